@@ -0,0 +1,125 @@
+#include "AssetLoader.h"
+#include <cstdio>
+
+AssetLoader& AssetLoader::getInstance() {
+    static AssetLoader instance;
+    return instance;
+}
+
+void AssetLoader::start(int workerCount) {
+    if (mutex) {
+        return;
+    }
+    if (workerCount <= 0) {
+        workerCount = SDL_GetNumLogicalCPUCores() - 1;
+        if (workerCount > 4) workerCount = 4;
+        if (workerCount < 1) workerCount = 1;
+    }
+
+    mutex = SDL_CreateMutex();
+    jobAvailable = SDL_CreateCondition();
+    jobCompleted = SDL_CreateCondition();
+    if (!mutex || !jobAvailable || !jobCompleted) {
+        std::fprintf(stderr, "AssetLoader: no sync primitives, loading inline: %s\n", SDL_GetError());
+        stop();
+        return;
+    }
+
+    quitting = false;
+    for (int i = 0; i < workerCount; ++i) {
+        SDL_Thread* thread = SDL_CreateThread(workerMain, "AssetLoader", this);
+        if (!thread) {
+            std::fprintf(stderr, "AssetLoader: could not start worker %d: %s\n", i, SDL_GetError());
+            break;
+        }
+        workers.push_back(thread);
+    }
+    if (workers.empty()) {
+        stop();
+    }
+}
+
+void AssetLoader::stop() {
+    if (!workers.empty()) {
+        waitIdle();
+        SDL_LockMutex(mutex);
+        quitting = true;
+        SDL_BroadcastCondition(jobAvailable);
+        SDL_UnlockMutex(mutex);
+        for (SDL_Thread* thread : workers) {
+            SDL_WaitThread(thread, nullptr);
+        }
+        workers.clear();
+    }
+    if (jobCompleted) SDL_DestroyCondition(jobCompleted);
+    if (jobAvailable) SDL_DestroyCondition(jobAvailable);
+    if (mutex) SDL_DestroyMutex(mutex);
+    jobCompleted = nullptr;
+    jobAvailable = nullptr;
+    mutex = nullptr;
+}
+
+void AssetLoader::submit(Task work, Task finish) {
+    if (workers.empty()) {
+        if (work) work();
+        if (finish) finish();
+        return;
+    }
+
+    ++outstanding;
+    SDL_LockMutex(mutex);
+    queue.push_back(Job{ std::move(work), std::move(finish) });
+    SDL_SignalCondition(jobAvailable);
+    SDL_UnlockMutex(mutex);
+}
+
+void AssetLoader::pumpMainThread() {
+    if (outstanding == 0) {
+        return;
+    }
+
+    std::deque<Task> done;
+    SDL_LockMutex(mutex);
+    done.swap(completed);
+    SDL_UnlockMutex(mutex);
+
+    for (Task& finish : done) {
+        if (finish) finish();
+        --outstanding;
+    }
+}
+
+void AssetLoader::waitIdle() {
+    while (outstanding > 0) {
+        SDL_LockMutex(mutex);
+        while (completed.empty()) {
+            SDL_WaitCondition(jobCompleted, mutex);
+        }
+        SDL_UnlockMutex(mutex);
+        pumpMainThread();
+    }
+}
+
+int AssetLoader::workerMain(void* userdata) {
+    AssetLoader* self = static_cast<AssetLoader*>(userdata);
+    SDL_LockMutex(self->mutex);
+    for (;;) {
+        while (self->queue.empty() && !self->quitting) {
+            SDL_WaitCondition(self->jobAvailable, self->mutex);
+        }
+        if (self->queue.empty()) {
+            break;
+        }
+        Job job = std::move(self->queue.front());
+        self->queue.pop_front();
+        SDL_UnlockMutex(self->mutex);
+
+        if (job.work) job.work();
+
+        SDL_LockMutex(self->mutex);
+        self->completed.push_back(std::move(job.finish));
+        SDL_SignalCondition(self->jobCompleted);
+    }
+    SDL_UnlockMutex(self->mutex);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "SDL3/SDL.h"
+#include <deque>
+#include <functional>
+#include <vector>
+
+// Startup job system. Each job's work runs on a worker thread; its optional
+// finish step runs later on the render thread inside pumpMainThread(), which
+// is where GL uploads and anything the game thread reads get published.
+class AssetLoader {
+public:
+    typedef std::function<void()> Task;
+
+    static AssetLoader& getInstance();
+
+    // workerCount 0 = one per core minus the render thread (at most 4). If no
+    // worker can be started, submit() runs jobs inline.
+    void start(int workerCount = 0);
+    void stop();                    // finishes outstanding jobs, then joins
+
+    // Render thread only
+    void submit(Task work, Task finish = Task());
+    void pumpMainThread();          // run finish steps of completed jobs
+    bool isIdle() const { return outstanding == 0; }
+    void waitIdle();                // completion barrier
+
+private:
+    AssetLoader() = default;
+    ~AssetLoader() { stop(); }
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    static int workerMain(void* userdata);
+
+    struct Job {
+        Task work;
+        Task finish;
+    };
+
+    SDL_Mutex* mutex = nullptr;
+    SDL_Condition* jobAvailable = nullptr;
+    SDL_Condition* jobCompleted = nullptr;
+    std::deque<Job> queue;          // guarded by mutex
+    std::deque<Task> completed;     // guarded by mutex
+    std::vector<SDL_Thread*> workers;
+    bool quitting = false;          // guarded by mutex
+    int outstanding = 0;            // render thread: submitted, not yet finished
+};
@@ -0,0 +1,129 @@
+#include "AssetPack.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetPack& AssetPack::getInstance() {
+    static AssetPack instance;
+    return instance;
+}
+
+bool AssetPack::open(const char* path) {
+    close();
+
+    const void* view = nullptr;
+    Uint64 size = 0;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER li;
+    if (!GetFileSizeEx(file, &li) || li.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    size = (Uint64)li.QuadPart;
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    view = mapped;
+    size = (Uint64)st.st_size;
+#endif
+    base = static_cast<const Uint8*>(view);
+    fileSize = size;
+
+    // Validate everything up front so lookups can trust the table
+    const AssetPackHeader* header = reinterpret_cast<const AssetPackHeader*>(base);
+    if (fileSize < sizeof(AssetPackHeader) ||
+        std::memcmp(header->magic, AssetPackMagic, sizeof(AssetPackMagic)) != 0 ||
+        header->version != AssetPackVersion ||
+        (fileSize - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry) < header->entryCount) {
+        std::fprintf(stderr, "AssetPack: '%s' is not a version %u asset pack\n", path, AssetPackVersion);
+        close();
+        return false;
+    }
+    const AssetPackEntry* table = reinterpret_cast<const AssetPackEntry*>(base + sizeof(AssetPackHeader));
+    for (Uint32 i = 0; i < header->entryCount; ++i) {
+        const AssetPackEntry& e = table[i];
+        if (e.offset > fileSize || e.size > fileSize - e.offset ||
+            std::memchr(e.path, '\0', sizeof(e.path)) == nullptr) {
+            std::fprintf(stderr, "AssetPack: '%s' has a corrupt entry %u\n", path, i);
+            close();
+            return false;
+        }
+    }
+    entries = table;
+    entryCount = header->entryCount;
+
+    std::printf("AssetPack: mapped '%s' (%u assets, %llu KB)\n", path, entryCount,
+                (unsigned long long)(fileSize / 1024));
+    return true;
+}
+
+void AssetPack::close() {
+    if (base) {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle((HANDLE)mappingHandle);
+        CloseHandle((HANDLE)fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<Uint8*>(base), (size_t)fileSize);
+#endif
+    }
+    base = nullptr;
+    fileSize = 0;
+    entries = nullptr;
+    entryCount = 0;
+}
+
+const AssetPackEntry* AssetPack::find(const char* path) const {
+    // The packer sorts the table by path
+    Uint32 lo = 0;
+    Uint32 hi = entryCount;
+    while (lo < hi) {
+        Uint32 mid = lo + (hi - lo) / 2;
+        int c = std::strcmp(entries[mid].path, path);
+        if (c == 0) return &entries[mid];
+        if (c < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return nullptr;
+}
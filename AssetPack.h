@@ -0,0 +1,68 @@
+#pragma once
+#include "SDL3/SDL.h"
+
+// assets.pak: every sound and image already converted to the format the game
+// consumes (F32 stereo at the device rate, RGBA8 pixels), written offline by
+// asset_packer. At runtime the file is memory-mapped and assets are used in
+// place, so startup does no decoding or conversion at all.
+//
+// Layout: header, entry table sorted by path, then 16-byte aligned payloads.
+
+static const char AssetPackMagic[4] = { 'P', 'P', 'A', 'K' };
+static const Uint32 AssetPackVersion = 1;
+static const char* const AssetPackDefaultPath = "assets.pak";
+
+enum AssetType : Uint32 {
+    ASSET_AUDIO_F32 = 1,   // interleaved float frames
+    ASSET_IMAGE_RGBA8 = 2  // tightly packed rows, top row first
+};
+
+struct AssetPackHeader {
+    char magic[4];
+    Uint32 version;
+    Uint32 entryCount;
+    Uint32 reserved;
+};
+
+struct AssetPackEntry {
+    char path[216];        // "assets/..." with forward slashes, as the game names it
+    Uint32 type;           // AssetType
+    Uint32 freq;           // audio: sample rate
+    Uint32 channels;       // audio: channel count
+    Uint32 width;          // image: pixels
+    Uint32 height;
+    Uint32 reserved;
+    Uint64 offset;         // from the start of the file
+    Uint64 size;           // payload bytes
+};
+static_assert(sizeof(AssetPackEntry) == 256, "AssetPackEntry is part of the file format");
+
+class AssetPack {
+public:
+    static AssetPack& getInstance();
+
+    // Maps the archive; false (and the game falls back to loose files) if it
+    // is missing or malformed
+    bool open(const char* path = AssetPackDefaultPath);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    // Entry for a loose-file path, or nullptr
+    const AssetPackEntry* find(const char* path) const;
+    const void* data(const AssetPackEntry& entry) const { return base + entry.offset; }
+
+private:
+    AssetPack() = default;
+    ~AssetPack() { close(); }
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    const Uint8* base = nullptr;
+    Uint64 fileSize = 0;
+    const AssetPackEntry* entries = nullptr;
+    Uint32 entryCount = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
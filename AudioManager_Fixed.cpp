@@ -1,4 +1,6 @@
 #include "AudioManager_Fixed.h"
+#include "AssetPack.h"
+#include "AssetLoader.h"
 #include <cstdio>
 #include <cstring>
 #include <cmath>
@@ -33,6 +35,13 @@ const char* AudioManager::gameSoundFiles[static_cast<int>(GameSound::COUNT)] = {
     "assets/Audio/SFX_Gameplay/Effects/win_dance.wav"
 };
 
+// Music tracks, streamed from disk rather than loaded up front
+const char* AudioManager::musicFiles[static_cast<int>(MusicTrack::COUNT)] = {
+    "assets/Audio/SFX_Gameplay/Music/gameplay_classic.ogg",
+    "assets/Audio/SFX_Gameplay/Music/gameplay_battle.ogg",
+    "assets/Audio/SFX_Gameplay/Music/gameplay_endless.ogg"
+};
+
 AudioManager& AudioManager::getInstance() {
     static AudioManager instance;
     return instance;
@@ -44,7 +53,7 @@ bool AudioManager::init() {
     }
     
     // Initialize SDL audio subsystem
-    if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+    if (!SDL_Init(SDL_INIT_AUDIO)) {
         std::fprintf(stderr, "SDL audio could not initialize! Error: %s\n", SDL_GetError());
         return false;
     }
@@ -81,39 +90,58 @@ bool AudioManager::init() {
         return false;
     }
     
-    // Reserve space for playing sounds
-    playingSounds.reserve(16);  // Allow up to 16 simultaneous sounds
-    
-    // Load all UI sounds
-    bool allLoaded = true;
-    for (int i = 0; i < static_cast<int>(UISound::COUNT); ++i) {
-        if (!loadUISound(static_cast<UISound>(i), uiSoundFiles[i])) {
-            // Log error but continue - missing one sound shouldn't break audio
-            std::fprintf(stderr, "Warning: Failed to load UI sound %d: %s\n", i, uiSoundFiles[i]);
-            allLoaded = false;
-        }
+    // The device pulls mixed audio from the voice pool through this callback
+    kernels = &getMixKernels();
+    std::printf("AudioManager: %s mix kernels\n", kernels->name);
+    for (int i = 0; i < MaxVoices; ++i) {
+        voices[i].active = false;
+    }
+    commandHead.store(0);
+    commandTail.store(0);
+    if (!SDL_SetAudioStreamGetCallback(audioStream, audioCallback, this)) {
+        std::fprintf(stderr, "Failed to set audio stream callback! Error: %s\n", SDL_GetError());
     }
     
-    // Load all gameplay sounds
-    for (int i = 0; i < static_cast<int>(GameSound::COUNT); ++i) {
-        if (!loadGameSound(static_cast<GameSound>(i), gameSoundFiles[i])) {
-            // Log error but continue - missing one sound shouldn't break audio
-            std::fprintf(stderr, "Warning: Failed to load gameplay sound %d: %s\n", i, gameSoundFiles[i]);
-            allLoaded = false;
-        }
+    // Music decodes on its own thread so file IO never stalls a frame or the mixer
+    musicThreadRunning.store(true);
+    musicThread = SDL_CreateThread(musicThreadMain, "MusicStream", this);
+    if (!musicThread) {
+        std::fprintf(stderr, "Failed to start music thread, music disabled: %s\n", SDL_GetError());
+        musicThreadRunning.store(false);
     }
     
     // Resume audio device
     SDL_ResumeAudioDevice(audioDevice);
     
     initialized = true;
-    
-    // Even if some sounds failed, we can still use the ones that loaded
-    if (!allLoaded) {
-        std::fprintf(stderr, "AudioManager: Some sounds failed to load, but continuing...\n");
+    return true;
+}
+
+void AudioManager::loadSoundsAsync() {
+    if (!initialized) {
+        return;
     }
     
-    return true;
+    // One job per sound; a missing file shouldn't hold up the others
+    AssetLoader& loader = AssetLoader::getInstance();
+    for (int i = 0; i < static_cast<int>(UISound::COUNT); ++i) {
+        loader.submit([this, i]() {
+            if (!loadUISound(static_cast<UISound>(i), uiSoundFiles[i])) {
+                std::fprintf(stderr, "Warning: Failed to load UI sound %d: %s\n", i, uiSoundFiles[i]);
+            }
+        }, [this, i]() {
+            uiSounds[i].ready = uiSounds[i].data != nullptr;
+        });
+    }
+    for (int i = 0; i < static_cast<int>(GameSound::COUNT); ++i) {
+        loader.submit([this, i]() {
+            if (!loadGameSound(static_cast<GameSound>(i), gameSoundFiles[i])) {
+                std::fprintf(stderr, "Warning: Failed to load gameplay sound %d: %s\n", i, gameSoundFiles[i]);
+            }
+        }, [this, i]() {
+            gameSounds[i].ready = gameSounds[i].data != nullptr;
+        });
+    }
 }
 
 void AudioManager::cleanup() {
@@ -124,7 +152,7 @@ void AudioManager::cleanup() {
     // Stop audio device
     SDL_PauseAudioDevice(audioDevice);
     
-    // Clean up audio stream
+    // Clean up audio stream (no callbacks run after this returns)
     if (audioStream) {
         SDL_DestroyAudioStream(audioStream);
         audioStream = nullptr;
@@ -136,18 +164,55 @@ void AudioManager::cleanup() {
         audioDevice = 0;
     }
     
+    // The mixer is gone, so the music thread is the only one touching the streams
+    if (musicThread) {
+        musicThreadRunning.store(false);
+        SDL_WaitThread(musicThread, nullptr);
+        musicThread = nullptr;
+    }
+    for (int i = 0; i < MusicStreamCount; ++i) {
+        musicStreams[i].close();
+        musicStreams[i].state.store(MusicStream::STATE_IDLE);
+    }
+    currentMusic = -1;
+    
     // Quit SDL audio subsystem
     SDL_QuitSubSystem(SDL_INIT_AUDIO);
     
-    // Clear playing sounds
-    playingSounds.clear();
+    for (int i = 0; i < MaxVoices; ++i) {
+        voices[i].active = false;
+    }
     
     initialized = false;
 }
 
+bool AudioManager::loadPackedSample(AudioSample& sample, const char* filepath) {
+    const AssetPack& pack = AssetPack::getInstance();
+    if (!pack.isOpen()) {
+        return false;
+    }
+    const AssetPackEntry* entry = pack.find(filepath);
+    if (!entry || entry->type != ASSET_AUDIO_F32 ||
+        (int)entry->freq != audioSpec.freq || (int)entry->channels != audioSpec.channels) {
+        return false;
+    }
+    
+    // The mixer only reads sample data, so the mapped bytes are used as-is
+    sample.data = const_cast<Uint8*>(static_cast<const Uint8*>(pack.data(*entry)));
+    sample.length = (Uint32)entry->size;
+    sample.spec = audioSpec;
+    sample.owned = false;
+    return true;
+}
+
 bool AudioManager::loadUISound(UISound sound, const char* filepath) {
     int index = static_cast<int>(sound);
     
+    // Pre-converted copy in the asset pack: use it in place
+    if (loadPackedSample(uiSounds[index], filepath)) {
+        return true;
+    }
+    
     // Load WAV file using SDL3
     if (!SDL_LoadWAV(filepath, &uiSounds[index].spec, &uiSounds[index].data, &uiSounds[index].length)) {
         std::fprintf(stderr, "Failed to load UI sound '%s': %s\n", filepath, SDL_GetError());
@@ -209,6 +274,11 @@ bool AudioManager::loadUISound(UISound sound, const char* filepath) {
 bool AudioManager::loadGameSound(GameSound sound, const char* filepath) {
     int index = static_cast<int>(sound);
     
+    // Pre-converted copy in the asset pack: use it in place
+    if (loadPackedSample(gameSounds[index], filepath)) {
+        return true;
+    }
+    
     // Load WAV file using SDL3
     if (!SDL_LoadWAV(filepath, &gameSounds[index].spec, &gameSounds[index].data, &gameSounds[index].length)) {
         std::fprintf(stderr, "Failed to load gameplay sound '%s': %s\n", filepath, SDL_GetError());
@@ -267,173 +337,312 @@ bool AudioManager::loadGameSound(GameSound sound, const char* filepath) {
     return true;
 }
 
-void AudioManager::playUI(UISound sound) {
+void AudioManager::playUI(UISound sound, float gain) {
     if (!initialized || muted) {
         return;
     }
     
-    int index = static_cast<int>(sound);
-    
-    if (uiSounds[index].data == nullptr) {
-        // Sound not loaded, silently skip
+    const AudioSample& sample = uiSounds[static_cast<int>(sound)];
+    if (!sample.ready) {
+        // Sound not loaded (yet), silently skip
         return;
     }
     
-    // Simple approach: create a temporary stream and play the sound directly
-    SDL_AudioStream* tempStream = SDL_CreateAudioStream(&audioSpec, &audioSpec);
-    if (tempStream) {
-        // Apply volume scaling
-        Uint8* volumeData = (Uint8*)SDL_malloc(uiSounds[index].length);
-        if (volumeData) {
-            std::memcpy(volumeData, uiSounds[index].data, uiSounds[index].length);
-            
-            // Apply volume to S16 samples
-            Sint16* samples = (Sint16*)volumeData;
-            Uint32 sampleCount = uiSounds[index].length / sizeof(Sint16);
-            
-            for (Uint32 i = 0; i < sampleCount; ++i) {
-                samples[i] = (Sint16)(samples[i] * uiVolume);
-            }
-            
-            // Put audio data in stream
-            if (SDL_PutAudioStreamData(tempStream, volumeData, uiSounds[index].length)) {
-                SDL_FlushAudioStream(tempStream);
-                
-                // Bind stream to device temporarily
-                if (SDL_BindAudioStream(audioDevice, tempStream)) {
-                    // Keep the stream alive for a short time to let audio play
-                    // In a real implementation, we'd manage stream lifecycle properly
-                    printf("Audio stream bound and playing sound: %d\n", index);
-                }
-            }
-            
-            SDL_free(volumeData);
-        }
-        
-        // Clean up the stream after a short delay
-        // In production, we'd use a timer or thread to manage this
-        SDL_DestroyAudioStream(tempStream);
-    }
-    
-    printf("Playing UI sound: %d (volume: %.2f, muted: %s)\n", index, uiVolume, muted ? "yes" : "no");
+    AudioCommand cmd;
+    cmd.type = AudioCommand::PLAY;
+    cmd.sample = &sample;
+    cmd.gain = gain * uiVolume;
+    pushCommand(cmd);
 }
 
-void AudioManager::playGameSound(GameSound sound) {
+void AudioManager::playGameSound(GameSound sound, float gain) {
     if (!initialized || muted) {
         return;
     }
     
-    int index = static_cast<int>(sound);
-    
-    if (gameSounds[index].data == nullptr) {
-        // Sound not loaded, silently skip
+    const AudioSample& sample = gameSounds[static_cast<int>(sound)];
+    if (!sample.ready) {
+        // Sound not loaded (yet), silently skip
         return;
     }
     
-    // Simple approach: create a temporary stream and play the sound directly
-    SDL_AudioStream* tempStream = SDL_CreateAudioStream(&audioSpec, &audioSpec);
-    if (tempStream) {
-        // Apply volume scaling
-        Uint8* volumeData = (Uint8*)SDL_malloc(gameSounds[index].length);
-        if (volumeData) {
-            std::memcpy(volumeData, gameSounds[index].data, gameSounds[index].length);
-            
-            // Apply volume to S16 samples
-            Sint16* samples = (Sint16*)volumeData;
-            Uint32 sampleCount = gameSounds[index].length / sizeof(Sint16);
-            
-            for (Uint32 i = 0; i < sampleCount; ++i) {
-                samples[i] = (Sint16)(samples[i] * gameVolume);
-            }
-            
-            // Put audio data in stream
-            if (SDL_PutAudioStreamData(tempStream, volumeData, gameSounds[index].length)) {
-                SDL_FlushAudioStream(tempStream);
-                
-                // Bind stream to device temporarily
-                if (SDL_BindAudioStream(audioDevice, tempStream)) {
-                    // Keep the stream alive for a short time to let audio play
-                    // In a real implementation, we'd manage stream lifecycle properly
-                    printf("Game audio stream bound and playing sound: %d\n", index);
-                }
+    AudioCommand cmd;
+    cmd.type = AudioCommand::PLAY;
+    cmd.sample = &sample;
+    cmd.gain = gain * gameVolume;
+    pushCommand(cmd);
+}
+
+void AudioManager::pushCommand(const AudioCommand& cmd) {
+    // Single producer (game thread): only this side advances the head
+    Uint32 head = commandHead.load(std::memory_order_relaxed);
+    Uint32 tail = commandTail.load(std::memory_order_acquire);
+    if (head - tail >= (Uint32)CommandRingSize) {
+        // Mixer is behind; losing one sound beats blocking the frame
+        return;
+    }
+    commands[head & (CommandRingSize - 1)] = cmd;
+    commandHead.store(head + 1, std::memory_order_release);
+}
+
+void AudioManager::stopVoice(Voice& v) {
+    v.targetGain = 0.0f;
+    v.rampFrames = RampFrames;
+    v.stopping = true;
+}
+
+void AudioManager::startVoice(const AudioSample* sample, float gain) {
+    // Too many sounds: fade out the one that has played longest to make room
+    int playing = 0;
+    int oldest = -1;
+    for (int i = 0; i < MaxVoices; ++i) {
+        const Voice& v = voices[i];
+        if (!v.active || v.stopping) continue;
+        playing++;
+        if (oldest < 0 || v.frame > voices[oldest].frame) oldest = i;
+    }
+    if (playing >= MaxPlayingVoices && oldest >= 0) {
+        stopVoice(voices[oldest]);
+    }
+
+    // Free slot, or failing that cut the quietest fade-out short
+    int slot = -1;
+    for (int i = 0; i < MaxVoices; ++i) {
+        if (!voices[i].active) {
+            slot = i;
+            break;
+        }
+        if (voices[i].stopping && (slot < 0 || voices[i].gain < voices[slot].gain)) slot = i;
+    }
+    if (slot < 0) return;
+
+    // Short fade-in so samples that don't start at zero don't click
+    Voice& v = voices[slot];
+    v.sample = sample;
+    v.frame = 0;
+    v.gain = 0.0f;
+    v.targetGain = gain;
+    v.rampFrames = RampFrames;
+    v.stopping = false;
+    v.active = true;
+}
+
+void AudioManager::audioCallback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount) {
+    (void)total_amount;
+    AudioManager* self = static_cast<AudioManager*>(userdata);
+    
+    // Single consumer (audio thread): apply everything queued since the last callback
+    Uint32 tail = self->commandTail.load(std::memory_order_relaxed);
+    Uint32 head = self->commandHead.load(std::memory_order_acquire);
+    while (tail != head) {
+        const AudioCommand& cmd = self->commands[tail & (CommandRingSize - 1)];
+        if (cmd.type == AudioCommand::PLAY) {
+            self->startVoice(cmd.sample, cmd.gain);
+        } else {
+            for (int i = 0; i < MaxVoices; ++i) {
+                if (self->voices[i].active) self->stopVoice(self->voices[i]);
             }
-            
-            SDL_free(volumeData);
         }
+        ++tail;
+    }
+    self->commandTail.store(tail, std::memory_order_release);
+    
+    // Mix in fixed chunks from the preallocated buffer
+    const int frameBytes = (int)(2 * sizeof(float));
+    int framesNeeded = (additional_amount + frameBytes - 1) / frameBytes;
+    while (framesNeeded > 0) {
+        int frames = framesNeeded < MixChunkFrames ? framesNeeded : MixChunkFrames;
+        self->mixAudio(self->mixBuffer, frames);
+        SDL_PutAudioStreamData(stream, self->mixBuffer, frames * frameBytes);
+        framesNeeded -= frames;
+    }
+}
+
+void AudioManager::mixAudio(float* output, int frames) {
+    // Clear output buffer
+    std::memset(output, 0, frames * 2 * sizeof(float));
+    
+    for (int i = 0; i < MaxVoices; ++i) {
+        Voice& v = voices[i];
+        if (!v.active) continue;
         
-        // Clean up the stream after a short delay
-        // In production, we'd use a timer or thread to manage this
-        SDL_DestroyAudioStream(tempStream);
+        int mixed = mixSample(output, v, frames);
+        v.frame += mixed;
+        if (mixed < frames || (v.stopping && v.rampFrames == 0)) {
+            v.active = false;
+        }
     }
     
-    printf("Playing gameplay sound: %d (volume: %.2f, muted: %s)\n", index, gameVolume, muted ? "yes" : "no");
+    mixMusic(output, frames);
+    
+    // Keep overlapping hits from wrapping around without a hard-clip crackle
+    kernels->softClip(output, frames * 2);
 }
 
-void AudioManager::processAudio() {
-    if (!initialized || !audioStream) {
-        return;
+int AudioManager::mixSample(float* output, Voice& voice, int frames) {
+    const AudioSample* sample = voice.sample;
+    if (!sample || !sample->data) {
+        return 0;
     }
     
-    // Calculate how much audio data we need to provide
-    int additionalAmount = 4096; // 4KB buffer
-    Uint64 available = SDL_GetAudioStreamAvailable(audioStream);
+    // Samples are converted to the device format (F32 stereo) at load time
+    Uint32 totalFrames = sample->length / (2 * sizeof(float));
+    if (voice.frame >= totalFrames) {
+        return 0;
+    }
     
-    if (available < additionalAmount) {
-        // We need to provide more audio data
-        int samplesNeeded = additionalAmount / sizeof(float) / 2; // Stereo samples
-        std::vector<float> buffer(samplesNeeded * 2);
+    const float* input = reinterpret_cast<const float*>(sample->data) + voice.frame * 2;
+    int framesToMix = (int)std::min((Uint32)frames, totalFrames - voice.frame);
+    int done = 0;
+    
+    // Ramp segment, then constant gain for the rest of the block
+    if (voice.rampFrames > 0) {
+        int n = std::min(framesToMix, voice.rampFrames);
+        float step = (voice.targetGain - voice.gain) / (float)voice.rampFrames;
+        kernels->mixVoice(output, input, n, voice.gain, step);
+        voice.rampFrames -= n;
+        voice.gain = (voice.rampFrames == 0) ? voice.targetGain : voice.gain + step * (float)n;
+        done = n;
+        
+        if (voice.stopping && voice.rampFrames == 0) {
+            return done;
+        }
+    }
+    if (done < framesToMix) {
+        kernels->mixVoice(output + done * 2, input + done * 2, framesToMix - done, voice.gain, 0.0f);
+    }
+    return framesToMix;
+}
+
+void AudioManager::mixMusic(float* output, int frames) {
+    Uint32 seq = musicRequestSeq.load(std::memory_order_acquire);
+    float volume = musicMuted.load(std::memory_order_relaxed) ? 0.0f : musicVolume.load(std::memory_order_relaxed);
+    
+    for (int i = 0; i < MusicStreamCount; ++i) {
+        MusicStream& stream = musicStreams[i];
+        MusicFade& fade = musicFades[i];
+        int state = stream.state.load(std::memory_order_acquire);
+        
+        // A newly opened track fades in, unless it was superseded while opening
+        if (state == MusicStream::STATE_READY) {
+            if (stream.requestSeq != seq) {
+                stream.state.store(MusicStream::STATE_FINISHED, std::memory_order_release);
+                continue;
+            }
+            fade.gain = 0.0f;
+            fade.targetGain = 1.0f;
+            fade.rampFrames = std::max(stream.fadeFrames, 1);
+            fade.stopping = false;
+            stream.state.store(MusicStream::STATE_PLAYING, std::memory_order_relaxed);
+            state = MusicStream::STATE_PLAYING;
+        }
+        if (state != MusicStream::STATE_PLAYING) continue;
         
-        // Mix all playing sounds
-        mixAudio(buffer.data(), samplesNeeded);
+        // Any later play/stop request fades this track out
+        if (!fade.stopping && stream.requestSeq != seq) {
+            fade.targetGain = 0.0f;
+            fade.rampFrames = std::max(musicRequestFadeFrames.load(std::memory_order_relaxed), 1);
+            fade.stopping = true;
+        }
+        
+        // On underrun mix what there is; the fade keeps time regardless
+        int got = stream.read(musicBuffer, frames);
+        int ramp = std::min(frames, fade.rampFrames);
+        if (ramp > 0) {
+            float step = (fade.targetGain - fade.gain) / (float)fade.rampFrames;
+            int n = std::min(got, ramp);
+            kernels->mixVoice(output, musicBuffer, n, fade.gain * volume, step * volume);
+            fade.rampFrames -= ramp;
+            fade.gain = (fade.rampFrames == 0) ? fade.targetGain : fade.gain + step * (float)ramp;
+        }
+        if (got > ramp) {
+            kernels->mixVoice(output + ramp * 2, musicBuffer + ramp * 2, got - ramp, fade.gain * volume, 0.0f);
+        }
         
-        // Put mixed audio into stream
-        SDL_PutAudioStreamData(audioStream, buffer.data(), additionalAmount);
+        if (fade.stopping && fade.rampFrames == 0) {
+            stream.state.store(MusicStream::STATE_FINISHED, std::memory_order_release);
+        }
     }
 }
 
-void AudioManager::mixAudio(float* output, int samples) {
-    // Clear output buffer
-    std::memset(output, 0, samples * 2 * sizeof(float));
-    
-    if (muted) {
-        return;
+int AudioManager::musicThreadMain(void* userdata) {
+    AudioManager* self = static_cast<AudioManager*>(userdata);
+    while (self->musicThreadRunning.load()) {
+        self->updateMusicStreams();
+        // The ring holds ~180 ms, so a 10 ms poll keeps it comfortably full
+        SDL_Delay(10);
+    }
+    return 0;
+}
+
+void AudioManager::updateMusicStreams() {
+    // Take back streams the mixer has finished fading out
+    for (int i = 0; i < MusicStreamCount; ++i) {
+        if (musicStreams[i].state.load(std::memory_order_acquire) == MusicStream::STATE_FINISHED) {
+            musicStreams[i].close();
+            musicStreams[i].state.store(MusicStream::STATE_IDLE, std::memory_order_release);
+        }
     }
     
-    // Mix all active sounds
-    for (auto& sound : playingSounds) {
-        if (sound.active && sound.sample) {
-            mixSample(output, sound.sample, sound.position, sound.volume, samples);
-            
-            // Update position
-            sound.position += samples * 2 * sizeof(float);  // Stereo samples
-            
-            // Check if sound finished
-            if (sound.position >= sound.sample->length) {
-                sound.active = false;
+    // Open the newest requested track once a stream is free
+    Uint32 seq = musicRequestSeq.load(std::memory_order_acquire);
+    if (seq != musicOpenedSeq) {
+        int track = musicRequestTrack.load(std::memory_order_relaxed);
+        int slot = -1;
+        for (int i = 0; i < MusicStreamCount; ++i) {
+            if (musicStreams[i].state.load(std::memory_order_acquire) == MusicStream::STATE_IDLE) {
+                slot = i;
+                break;
+            }
+        }
+        if (track < 0) {
+            musicOpenedSeq = seq;
+        } else if (slot >= 0) {
+            musicOpenedSeq = seq;
+            MusicStream& stream = musicStreams[slot];
+            if (stream.open(musicFiles[track], audioSpec)) {
+                stream.fill();
+                stream.requestSeq = seq;
+                stream.fadeFrames = musicRequestFadeFrames.load(std::memory_order_relaxed);
+                stream.state.store(MusicStream::STATE_READY, std::memory_order_release);
             }
         }
     }
     
-    // Remove inactive sounds
-    playingSounds.erase(
-        std::remove_if(playingSounds.begin(), playingSounds.end(),
-            [](const PlayingSound& sound) { return !sound.active; }),
-        playingSounds.end()
-    );
+    for (int i = 0; i < MusicStreamCount; ++i) {
+        int state = musicStreams[i].state.load(std::memory_order_acquire);
+        if (state == MusicStream::STATE_READY || state == MusicStream::STATE_PLAYING) {
+            musicStreams[i].fill();
+        }
+    }
 }
 
-void AudioManager::mixSample(float* output, const AudioSample* sample, Uint32 position, float volume, int samples) {
-    if (!sample || !sample->data || position >= sample->length) {
+void AudioManager::playMusic(MusicTrack track, float fadeSeconds) {
+    int index = static_cast<int>(track);
+    if (!initialized || !musicThread || index == currentMusic) {
         return;
     }
-    
-    const float* inputData = reinterpret_cast<const float*>(sample->data + position);
-    Uint32 samplesAvailable = (sample->length - position) / sizeof(float);
-    Uint32 samplesToMix = std::min((Uint32)samples * 2, samplesAvailable);  // Stereo
-    
-    for (Uint32 i = 0; i < samplesToMix; ++i) {
-        output[i] += inputData[i] * volume;
+    currentMusic = index;
+    musicRequestTrack.store(index, std::memory_order_relaxed);
+    musicRequestFadeFrames.store((int)(fadeSeconds * (float)audioSpec.freq), std::memory_order_relaxed);
+    musicRequestSeq.fetch_add(1, std::memory_order_release);
+}
+
+void AudioManager::stopMusic(float fadeSeconds) {
+    if (!initialized || currentMusic < 0) {
+        return;
     }
+    currentMusic = -1;
+    musicRequestTrack.store(-1, std::memory_order_relaxed);
+    musicRequestFadeFrames.store((int)(fadeSeconds * (float)audioSpec.freq), std::memory_order_relaxed);
+    musicRequestSeq.fetch_add(1, std::memory_order_release);
+}
+
+void AudioManager::setMusicVolume(float volume) {
+    if (volume < 0.0f) volume = 0.0f;
+    if (volume > 1.0f) volume = 1.0f;
+    
+    musicVolume.store(volume, std::memory_order_relaxed);
 }
 
 void AudioManager::setUIVolume(float volume) {
@@ -446,10 +655,20 @@ void AudioManager::setUIVolume(float volume) {
 
 void AudioManager::setMuted(bool mute) {
     muted = mute;
+    musicMuted.store(mute, std::memory_order_relaxed);
+    if (muted) {
+        stopAll();
+    }
 }
 
 void AudioManager::stopAll() {
-    for (auto& sound : playingSounds) {
-        sound.active = false;
+    if (!initialized) {
+        return;
     }
+    
+    AudioCommand cmd;
+    cmd.type = AudioCommand::STOP_ALL;
+    cmd.sample = nullptr;
+    cmd.gain = 0.0f;
+    pushCommand(cmd);
 }
@@ -1,8 +1,9 @@
 #pragma once
 #include "SDL3/SDL.h"
+#include "AudioMix.h"
+#include "MusicStream.h"
 #include <string>
-#include <vector>
-#include <queue>
+#include <atomic>
 
 // UI Sound effects from SoupTonic UI1 SFX Pack
 enum class UISound {
@@ -35,26 +36,45 @@ enum class GameSound {
     COUNT                  // Total number of gameplay sounds
 };
 
+// Streamed background music (assets/Audio/SFX_Gameplay/Music)
+enum class MusicTrack {
+    CLASSIC = 0,           // gameplay_classic.ogg
+    BATTLE,                // gameplay_battle.ogg
+    ENDLESS,               // gameplay_endless.ogg
+    COUNT
+};
+
 // Simple audio sample structure
 struct AudioSample {
     Uint8* data;
     Uint32 length;
     SDL_AudioSpec spec;
+    bool owned;          // false when data points into the mapped asset pack
+    bool ready;          // game thread: loaded and safe to hand to the mixer
     
-    AudioSample() : data(nullptr), length(0) {}
+    AudioSample() : data(nullptr), length(0), owned(true), ready(false) {}
     ~AudioSample() {
-        if (data) SDL_free(data);
+        if (data && owned) SDL_free(data);
     }
 };
 
-// Playing sound instance
-struct PlayingSound {
-    AudioSample* sample;
-    Uint32 position;
-    float volume;
+// One mixer voice; only ever touched by the audio thread
+struct Voice {
+    const AudioSample* sample;
+    Uint32 frame;        // next stereo frame to mix
+    float gain;          // current gain
+    float targetGain;    // gain being ramped towards
+    int rampFrames;      // frames left in the current ramp
+    bool stopping;       // fading out; freed when the ramp ends
     bool active;
-    
-    PlayingSound() : sample(nullptr), position(0), volume(1.0f), active(false) {}
+};
+
+// Game thread -> audio thread message, passed through a lock-free ring
+struct AudioCommand {
+    enum Type : Uint8 { PLAY, STOP_ALL };
+    Type type;
+    const AudioSample* sample;
+    float gain;
 };
 
 class AudioManager {
@@ -62,10 +82,15 @@ public:
     // Singleton access
     static AudioManager& getInstance();
     
-    // Initialize SDL3 audio and load all sounds
+    // Initialize SDL3 audio and start the mixer; sounds are loaded separately
     // Returns false if audio could not be initialized (game continues silently)
     bool init();
     
+    // Load every sound effect on the asset loader's workers. Each one becomes
+    // playable when its job is finished on the game thread; until then it is
+    // skipped like a sound that failed to load.
+    void loadSoundsAsync();
+    
     // Cleanup all loaded sounds and quit SDL audio
     void cleanup();
     
@@ -77,15 +102,22 @@ public:
     void setMuted(bool mute);
     bool isMuted() const { return muted; }
     
-    // Play a UI sound effect (non-blocking, immediate)
-    void playUI(UISound sound);
+    // Play a UI sound effect at gain (0.0-1.0) on top of the UI volume.
+    // Never blocks or allocates: it only queues a command for the mixer.
+    void playUI(UISound sound, float gain = 1.0f);
     
-    // Play a gameplay sound effect (non-blocking, immediate)
-    void playGameSound(GameSound sound);
+    // Play a gameplay sound effect at gain (0.0-1.0) on top of the game volume
+    void playGameSound(GameSound sound, float gain = 1.0f);
     
     // Stop all currently playing sounds
     void stopAll();
     
+    // Crossfade to a music track (no-op if it is already playing). The file is
+    // opened and decoded on the music thread, never on the caller's.
+    void playMusic(MusicTrack track, float fadeSeconds = 1.5f);
+    void stopMusic(float fadeSeconds = 1.0f);
+    void setMusicVolume(float volume);
+    
     // Check if audio is properly initialized
     bool isInitialized() const { return initialized; }
 
@@ -96,26 +128,69 @@ private:
     AudioManager& operator=(const AudioManager&) = delete;
     
     // Load a single WAV file
+    bool loadPackedSample(AudioSample& sample, const char* filepath);
     bool loadUISound(UISound sound, const char* filepath);
     bool loadGameSound(GameSound sound, const char* filepath);
     
-    // Audio callback function
+    // Queue a command for the audio thread; drops it if the ring is full
+    void pushCommand(const AudioCommand& cmd);
+    void startVoice(const AudioSample* sample, float gain);
+    void stopVoice(Voice& v);
+    
+    // Audio callback: drains commands and mixes the voice pool into the stream
     static void audioCallback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount);
     
-    // Audio processing
-    void processAudio();
-    void mixAudio(float* output, int samples);
-    void mixSample(float* output, const AudioSample* sample, Uint32 position, float volume, int samples);
+    // Music worker: opens requested tracks and keeps their rings topped up
+    static int musicThreadMain(void* userdata);
+    void updateMusicStreams();
+    
+    // Audio processing (audio thread only)
+    void mixAudio(float* output, int frames);
+    void mixMusic(float* output, int frames);
+    int mixSample(float* output, Voice& voice, int frames);
     
     // SDL3 audio objects
-    SDL_AudioDeviceID audioDevice;
+    SDL_AudioDeviceID audioDevice = 0;
     SDL_AudioSpec audioSpec;
-    SDL_AudioStream* audioStream;
+    SDL_AudioStream* audioStream = nullptr;
     
     // Audio data
     AudioSample uiSounds[static_cast<int>(UISound::COUNT)];
     AudioSample gameSounds[static_cast<int>(GameSound::COUNT)];
-    std::vector<PlayingSound> playingSounds;
+    
+    // Mixer
+    static const int MaxVoices = 32;
+    static const int MaxPlayingVoices = 24;  // the rest is headroom for fade-outs
+    static const int RampFrames = 64;        // ~1.5 ms fade in/out to avoid clicks
+    static const int CommandRingSize = 64;   // power of two
+    static const int MixChunkFrames = 1024;
+    Voice voices[MaxVoices] = {};
+    AudioCommand commands[CommandRingSize];
+    std::atomic<Uint32> commandHead{0};      // written by the game thread
+    std::atomic<Uint32> commandTail{0};      // written by the audio thread
+    float mixBuffer[MixChunkFrames * 2];
+    const MixKernels* kernels = nullptr;
+    
+    // Music: two streams so one can fade in while the other fades out
+    struct MusicFade {
+        float gain;
+        float targetGain;
+        int rampFrames;
+        bool stopping;
+    };
+    static const int MusicStreamCount = 2;
+    MusicStream musicStreams[MusicStreamCount];
+    MusicFade musicFades[MusicStreamCount] = {};      // audio thread only
+    float musicBuffer[MixChunkFrames * 2];
+    SDL_Thread* musicThread = nullptr;
+    std::atomic<bool> musicThreadRunning{false};
+    std::atomic<Uint32> musicRequestSeq{0};           // bumped by play/stopMusic
+    std::atomic<int> musicRequestTrack{-1};           // -1 = silence
+    std::atomic<int> musicRequestFadeFrames{0};
+    std::atomic<float> musicVolume{0.6f};
+    std::atomic<bool> musicMuted{false};
+    Uint32 musicOpenedSeq = 0;                        // music thread only
+    int currentMusic = -1;                            // game thread only
     
     // State
     bool initialized = false;
@@ -126,4 +201,5 @@ private:
     // File paths for each sound (relative to executable)
     static const char* uiSoundFiles[static_cast<int>(UISound::COUNT)];
     static const char* gameSoundFiles[static_cast<int>(GameSound::COUNT)];
+    static const char* musicFiles[static_cast<int>(MusicTrack::COUNT)];
 };
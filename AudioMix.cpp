@@ -0,0 +1,190 @@
+#include "AudioMix.h"
+#include "SDL3/SDL.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MIX_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define MIX_HAVE_X86 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MIX_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MIX_TARGET_AVX2
+#endif
+
+// Limiter shape: untouched below the knee, then a rational tanh approximation
+// squeezes [knee, knee + 3 * range] into [knee, 1.0]
+static const float kClipKnee = 0.8f;
+static const float kClipRange = 1.0f - kClipKnee;
+
+// --- Scalar ---
+
+static void mixVoiceScalar(float* output, const float* input, int frames, float gain, float gainStep) {
+    for (int i = 0; i < frames; ++i) {
+        output[i * 2 + 0] += input[i * 2 + 0] * gain;
+        output[i * 2 + 1] += input[i * 2 + 1] * gain;
+        gain += gainStep;
+    }
+}
+
+static inline float softClipSample(float x) {
+    float ax = std::fabs(x);
+    if (ax <= kClipKnee) return x;
+    float z = (ax - kClipKnee) / kClipRange;
+    if (z > 3.0f) z = 3.0f;
+    float z2 = z * z;
+    float y = kClipKnee + kClipRange * (z * (27.0f + z2) / (27.0f + 9.0f * z2));
+    return x < 0.0f ? -y : y;
+}
+
+static void softClipScalar(float* buffer, int samples) {
+    for (int i = 0; i < samples; ++i) {
+        buffer[i] = softClipSample(buffer[i]);
+    }
+}
+
+#if MIX_HAVE_X86
+
+// --- SSE2: two stereo frames per register ---
+
+static void mixVoiceSSE2(float* output, const float* input, int frames, float gain, float gainStep) {
+    __m128 g = _mm_setr_ps(gain, gain, gain + gainStep, gain + gainStep);
+    const __m128 gInc = _mm_set1_ps(2.0f * gainStep);
+
+    int i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 o0 = _mm_loadu_ps(output + i * 2);
+        __m128 o1 = _mm_loadu_ps(output + i * 2 + 4);
+        __m128 x0 = _mm_loadu_ps(input + i * 2);
+        __m128 x1 = _mm_loadu_ps(input + i * 2 + 4);
+        __m128 g1 = _mm_add_ps(g, gInc);
+        o0 = _mm_add_ps(o0, _mm_mul_ps(x0, g));
+        o1 = _mm_add_ps(o1, _mm_mul_ps(x1, g1));
+        _mm_storeu_ps(output + i * 2, o0);
+        _mm_storeu_ps(output + i * 2 + 4, o1);
+        g = _mm_add_ps(g1, gInc);
+    }
+    mixVoiceScalar(output + i * 2, input + i * 2, frames - i, gain + gainStep * (float)i, gainStep);
+}
+
+static void softClipSSE2(float* buffer, int samples) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 knee = _mm_set1_ps(kClipKnee);
+    const __m128 invRange = _mm_set1_ps(1.0f / kClipRange);
+    const __m128 range = _mm_set1_ps(kClipRange);
+    const __m128 three = _mm_set1_ps(3.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 c27 = _mm_set1_ps(27.0f);
+    const __m128 c9 = _mm_set1_ps(9.0f);
+
+    int i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        __m128 x = _mm_loadu_ps(buffer + i);
+        __m128 sign = _mm_and_ps(x, signMask);
+        __m128 ax = _mm_andnot_ps(signMask, x);
+
+        __m128 z = _mm_mul_ps(_mm_sub_ps(ax, knee), invRange);
+        z = _mm_min_ps(_mm_max_ps(z, zero), three);
+        __m128 z2 = _mm_mul_ps(z, z);
+        __m128 t = _mm_div_ps(_mm_mul_ps(z, _mm_add_ps(c27, z2)), _mm_add_ps(c27, _mm_mul_ps(c9, z2)));
+        __m128 limited = _mm_add_ps(knee, _mm_mul_ps(range, t));
+
+        __m128 over = _mm_cmpgt_ps(ax, knee);
+        __m128 y = _mm_or_ps(_mm_and_ps(over, limited), _mm_andnot_ps(over, ax));
+        _mm_storeu_ps(buffer + i, _mm_or_ps(y, sign));
+    }
+    softClipScalar(buffer + i, samples - i);
+}
+
+// --- AVX2: four stereo frames per register ---
+
+MIX_TARGET_AVX2
+static void mixVoiceAVX2(float* output, const float* input, int frames, float gain, float gainStep) {
+    __m256 g = _mm256_setr_ps(gain, gain,
+                              gain + gainStep, gain + gainStep,
+                              gain + 2.0f * gainStep, gain + 2.0f * gainStep,
+                              gain + 3.0f * gainStep, gain + 3.0f * gainStep);
+    const __m256 gInc = _mm256_set1_ps(4.0f * gainStep);
+
+    int i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m256 o0 = _mm256_loadu_ps(output + i * 2);
+        __m256 o1 = _mm256_loadu_ps(output + i * 2 + 8);
+        __m256 x0 = _mm256_loadu_ps(input + i * 2);
+        __m256 x1 = _mm256_loadu_ps(input + i * 2 + 8);
+        __m256 g1 = _mm256_add_ps(g, gInc);
+        o0 = _mm256_add_ps(o0, _mm256_mul_ps(x0, g));
+        o1 = _mm256_add_ps(o1, _mm256_mul_ps(x1, g1));
+        _mm256_storeu_ps(output + i * 2, o0);
+        _mm256_storeu_ps(output + i * 2 + 8, o1);
+        g = _mm256_add_ps(g1, gInc);
+    }
+    mixVoiceScalar(output + i * 2, input + i * 2, frames - i, gain + gainStep * (float)i, gainStep);
+}
+
+MIX_TARGET_AVX2
+static void softClipAVX2(float* buffer, int samples) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 knee = _mm256_set1_ps(kClipKnee);
+    const __m256 invRange = _mm256_set1_ps(1.0f / kClipRange);
+    const __m256 range = _mm256_set1_ps(kClipRange);
+    const __m256 three = _mm256_set1_ps(3.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 c27 = _mm256_set1_ps(27.0f);
+    const __m256 c9 = _mm256_set1_ps(9.0f);
+
+    int i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        __m256 x = _mm256_loadu_ps(buffer + i);
+        __m256 sign = _mm256_and_ps(x, signMask);
+        __m256 ax = _mm256_andnot_ps(signMask, x);
+
+        __m256 z = _mm256_mul_ps(_mm256_sub_ps(ax, knee), invRange);
+        z = _mm256_min_ps(_mm256_max_ps(z, zero), three);
+        __m256 z2 = _mm256_mul_ps(z, z);
+        __m256 t = _mm256_div_ps(_mm256_mul_ps(z, _mm256_add_ps(c27, z2)),
+                                 _mm256_add_ps(c27, _mm256_mul_ps(c9, z2)));
+        __m256 limited = _mm256_add_ps(knee, _mm256_mul_ps(range, t));
+
+        __m256 over = _mm256_cmp_ps(ax, knee, _CMP_GT_OQ);
+        __m256 y = _mm256_blendv_ps(ax, limited, over);
+        _mm256_storeu_ps(buffer + i, _mm256_or_ps(y, sign));
+    }
+    softClipScalar(buffer + i, samples - i);
+}
+
+#endif // MIX_HAVE_X86
+
+static const MixKernels kScalarKernels = { "scalar", mixVoiceScalar, softClipScalar };
+#if MIX_HAVE_X86
+static const MixKernels kSSE2Kernels = { "sse2", mixVoiceSSE2, softClipSSE2 };
+static const MixKernels kAVX2Kernels = { "avx2", mixVoiceAVX2, softClipAVX2 };
+#endif
+
+const MixKernels* getMixKernels(MixKernelLevel level) {
+    switch (level) {
+    case MIX_SCALAR:
+        return &kScalarKernels;
+#if MIX_HAVE_X86
+    case MIX_SSE2:
+        return SDL_HasSSE2() ? &kSSE2Kernels : nullptr;
+    case MIX_AVX2:
+        return SDL_HasAVX2() ? &kAVX2Kernels : nullptr;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+const MixKernels& getMixKernels() {
+    static const MixKernels* best = nullptr;
+    if (!best) {
+        best = getMixKernels(MIX_AVX2);
+        if (!best) best = getMixKernels(MIX_SSE2);
+        if (!best) best = &kScalarKernels;
+    }
+    return *best;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Inner loops of the software voice mixer, in scalar, SSE2 and AVX2 flavours.
+// All buffers are interleaved stereo float; no SDL audio objects involved, so
+// the mix benchmark can drive them directly.
+
+// Accumulate `frames` stereo frames of input into output. Gain starts at `gain`
+// and moves by `gainStep` every frame (0 for a constant gain).
+typedef void (*MixVoiceFn)(float* output, const float* input, int frames, float gain, float gainStep);
+
+// Soft-knee limiter: linear below the knee, rolls off smoothly to +/-1.0
+typedef void (*SoftClipFn)(float* buffer, int samples);
+
+struct MixKernels {
+    const char* name;
+    MixVoiceFn mixVoice;
+    SoftClipFn softClip;
+};
+
+enum MixKernelLevel { MIX_SCALAR = 0, MIX_SSE2 = 1, MIX_AVX2 = 2 };
+
+// Fastest kernel set this CPU supports
+const MixKernels& getMixKernels();
+
+// A specific kernel set, or nullptr if this CPU/build can't run it
+const MixKernels* getMixKernels(MixKernelLevel level);
@@ -1,21 +1,14 @@
 #pragma once
 #include <cstddef>
 
-class Paddle;
-
+// Render proxy for the match ball; gameplay lives in Simulation (SimBall)
 class Ball {
 public:
     Ball(float x, float y, float vx, float vy, int r);
 
-    void reset(float cx, float cy);
-    void update(double dt, int screenW, int screenH,
-                const Paddle& p1, const Paddle& p2,
-                int& score1, int& score2,
-                int& health1, int& health2,
-                float& boost1, float& boost2,
-                bool battleMode,
-                bool& shield1Held, bool& shield2Held);
     void render() const;
+    // The ball cube on its own, for balls without a proxy (multi-ball extras)
+    static void draw(float x, float y, int radius, bool piercing);
 
 public:
     float x, y;
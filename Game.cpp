@@ -1,328 +1,34 @@
 #include "Game.h"
 #include "Paddle.h"
 #include "Ball.h"
+#include "Simulation.h"
+#include "Renderer.h"
+#include "VectorFont.h"
+#include "AssetPack.h"
+#include "AssetLoader.h"
+#include "RenderMath.h"
+#include "Profiler.h"
 
 #include "SDL3/SDL.h"
 #include "SDL3/SDL_opengl.h"
 #include <cstdio>
 #include <cmath>
 #include <cstdlib>
+#include <algorithm>
+#include <vector>
 
 // stb_image for loading PNG files
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 const int Game::MaxHealthOptions[4] = { 5, 10, 15, 20 };
+const int Game::BallCountOptions[6] = { 1, 3, 10, 50, 100, 250 };
 
-static inline bool aabbOverlap(float ax, float ay, float aw, float ah,
-                               float bx, float by, float bw, float bh) {
-    return (ax < bx + bw) && (ax + aw > bx) && (ay < by + bh) && (ay + ah > by);
-}
-
-static void drawChar(float x, float y, float scale, char c) {
-    float s = scale;
-    auto segment = [x, y, s](float x1, float y1, float x2, float y2) {
-        glVertex2f(x + x1 * s, y + y1 * s);
-        glVertex2f(x + x2 * s, y + y2 * s);
-    };
-
-    glBegin(GL_LINES);
-    switch (c) {
-    case 'A':
-        segment(0.0f, 1.0f, 0.5f, 0.0f);
-        segment(1.0f, 1.0f, 0.5f, 0.0f);
-        segment(0.2f, 0.5f, 0.8f, 0.5f);
-        break;
-    case 'C':
-        segment(0.8f, 0.0f, 0.2f, 0.0f);
-        segment(0.2f, 0.0f, 0.2f, 1.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        break;
-    case 'D':
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        segment(0.0f, 0.0f, 0.6f, 0.2f);
-        segment(0.6f, 0.2f, 0.6f, 0.8f);
-        segment(0.6f, 0.8f, 0.0f, 1.0f);
-        break;
-    case 'E':
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        segment(0.0f, 0.0f, 0.8f, 0.0f);
-        segment(0.0f, 0.5f, 0.7f, 0.5f);
-        segment(0.0f, 1.0f, 0.8f, 1.0f);
-        break;
-    case 'F':
-        // Vertical stem
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        // Top bar
-        segment(0.0f, 0.0f, 0.8f, 0.0f);
-        // Middle bar
-        segment(0.0f, 0.5f, 0.7f, 0.5f);
-        break;
-    case 'G':
-        segment(0.2f, 0.0f, 0.8f, 0.0f);
-        segment(0.2f, 0.0f, 0.2f, 1.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        segment(0.8f, 1.0f, 0.8f, 0.5f);
-        segment(0.8f, 0.5f, 0.5f, 0.5f);
-        break;
-    case 'L':
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        segment(0.0f, 1.0f, 0.8f, 1.0f);
-        break;
-    case 'N':
-        segment(0.0f, 1.0f, 0.0f, 0.0f);
-        segment(0.0f, 0.0f, 1.0f, 1.0f);
-        segment(1.0f, 1.0f, 1.0f, 0.0f);
-        break;
-    case 'O':
-        segment(0.2f, 0.0f, 0.8f, 0.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        segment(0.2f, 0.0f, 0.2f, 1.0f);
-        segment(0.8f, 0.0f, 0.8f, 1.0f);
-        break;
-    case 'P':
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        segment(0.0f, 0.0f, 0.7f, 0.0f);
-        segment(0.7f, 0.0f, 0.7f, 0.5f);
-        segment(0.0f, 0.5f, 0.7f, 0.5f);
-        break;
-    case 'S':
-        segment(0.8f, 0.0f, 0.2f, 0.0f);
-        segment(0.2f, 0.0f, 0.2f, 0.5f);
-        segment(0.2f, 0.5f, 0.8f, 0.5f);
-        segment(0.8f, 0.5f, 0.8f, 1.0f);
-        segment(0.8f, 1.0f, 0.2f, 1.0f);
-        break;
-    case 'T':
-        // Top bar
-        segment(0.0f, 0.0f, 1.0f, 0.0f);
-        // Vertical stem
-        segment(0.5f, 0.0f, 0.5f, 1.0f);
-        break;
-    case 'R':
-        // Left stem
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        // Top bar
-        segment(0.0f, 0.0f, 0.8f, 0.0f);
-        // Middle bar
-        segment(0.0f, 0.5f, 0.7f, 0.5f);
-        // Right side of bowl
-        segment(0.8f, 0.0f, 0.8f, 0.5f);
-        // Diagonal leg
-        segment(0.0f, 0.5f, 0.8f, 1.0f);
-        break;
-    case 'M':
-        // Side stems
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        segment(1.0f, 0.0f, 1.0f, 1.0f);
-        // Peaks at top
-        segment(0.0f, 0.0f, 0.5f, 0.5f);
-        segment(1.0f, 0.0f, 0.5f, 0.5f);
-        break;
-    case 'V':
-        segment(0.0f, 0.0f, 0.5f, 1.0f);
-        segment(1.0f, 0.0f, 0.5f, 1.0f);
-        break;
-    case 'I':
-        segment(0.5f, 0.0f, 0.5f, 1.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        segment(0.2f, 0.0f, 0.8f, 0.0f);
-        break;
-    case 'Q':
-        segment(0.2f, 0.0f, 0.8f, 0.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        segment(0.2f, 0.0f, 0.2f, 1.0f);
-        segment(0.8f, 0.0f, 0.8f, 1.0f);
-        segment(0.6f, 0.4f, 0.9f, 0.0f);
-        break;
-    case 'U':
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        segment(1.0f, 0.0f, 1.0f, 1.0f);
-        segment(0.0f, 1.0f, 1.0f, 1.0f);
-        break;
-    case 'W':
-        segment(0.0f, 0.0f, 0.2f, 1.0f);
-        segment(0.2f, 1.0f, 0.5f, 0.5f);
-        segment(0.5f, 0.5f, 0.8f, 1.0f);
-        segment(0.8f, 1.0f, 1.0f, 0.0f);
-        break;
-    case 'Y':
-        segment(0.0f, 0.0f, 0.5f, 0.5f);
-        segment(1.0f, 0.0f, 0.5f, 0.5f);
-        segment(0.5f, 0.5f, 0.5f, 1.0f);
-        break;
-    case '0':
-        segment(0.2f, 0.0f, 0.8f, 0.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        segment(0.2f, 0.0f, 0.2f, 1.0f);
-        segment(0.8f, 0.0f, 0.8f, 1.0f);
-        break;
-    case '1':
-        segment(0.5f, 0.0f, 0.5f, 1.0f);
-        segment(0.3f, 0.2f, 0.5f, 0.0f);
-        segment(0.3f, 1.0f, 0.7f, 1.0f);
-        break;
-    case '2':
-        segment(0.2f, 0.0f, 0.8f, 0.0f);
-        segment(0.8f, 0.0f, 0.8f, 0.5f);
-        segment(0.2f, 0.5f, 0.8f, 0.5f);
-        segment(0.2f, 0.5f, 0.2f, 1.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        break;
-    case '3':
-        segment(0.2f, 0.0f, 0.8f, 0.0f);
-        segment(0.8f, 0.0f, 0.8f, 0.5f);
-        segment(0.2f, 0.5f, 0.8f, 0.5f);
-        segment(0.8f, 0.5f, 0.8f, 1.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        break;
-    case '4':
-        segment(0.2f, 0.0f, 0.2f, 0.5f);
-        segment(0.8f, 0.0f, 0.8f, 1.0f);
-        segment(0.2f, 0.5f, 0.8f, 0.5f);
-        break;
-    case '5':
-        segment(0.8f, 0.0f, 0.2f, 0.0f);
-        segment(0.2f, 0.0f, 0.2f, 0.5f);
-        segment(0.2f, 0.5f, 0.8f, 0.5f);
-        segment(0.8f, 0.5f, 0.8f, 1.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        break;
-    case '6':
-        segment(0.8f, 0.0f, 0.2f, 0.0f);
-        segment(0.2f, 0.0f, 0.2f, 1.0f);
-        segment(0.2f, 0.5f, 0.8f, 0.5f);
-        segment(0.8f, 0.5f, 0.8f, 1.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        break;
-    case '7':
-        segment(0.2f, 0.0f, 0.8f, 0.0f);
-        segment(0.8f, 0.0f, 0.5f, 1.0f);
-        break;
-    case '8':
-        segment(0.2f, 0.0f, 0.8f, 0.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        segment(0.2f, 0.0f, 0.2f, 1.0f);
-        segment(0.8f, 0.0f, 0.8f, 1.0f);
-        segment(0.2f, 0.5f, 0.8f, 0.5f);
-        break;
-    case '9':
-        segment(0.2f, 0.0f, 0.8f, 0.0f);
-        segment(0.2f, 0.0f, 0.2f, 0.5f);
-        segment(0.2f, 0.5f, 0.8f, 0.5f);
-        segment(0.8f, 0.0f, 0.8f, 1.0f);
-        segment(0.2f, 1.0f, 0.8f, 1.0f);
-        break;
-    case '/':
-        segment(0.8f, 0.0f, 0.2f, 1.0f);
-        break;
-    case ':':
-        segment(0.5f, 0.3f, 0.5f, 0.3f);
-        segment(0.5f, 0.7f, 0.5f, 0.7f);
-        break;
-    case 'B':
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        segment(0.0f, 0.0f, 0.7f, 0.0f);
-        segment(0.7f, 0.0f, 0.8f, 0.15f);
-        segment(0.8f, 0.15f, 0.8f, 0.35f);
-        segment(0.8f, 0.35f, 0.7f, 0.5f);
-        segment(0.0f, 0.5f, 0.7f, 0.5f);
-        segment(0.7f, 0.5f, 0.8f, 0.65f);
-        segment(0.8f, 0.65f, 0.8f, 0.85f);
-        segment(0.8f, 0.85f, 0.7f, 1.0f);
-        segment(0.0f, 1.0f, 0.7f, 1.0f);
-        break;
-    case 'H':
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        segment(0.8f, 0.0f, 0.8f, 1.0f);
-        segment(0.0f, 0.5f, 0.8f, 0.5f);
-        break;
-    case 'J':
-        segment(0.8f, 0.0f, 0.8f, 0.85f);
-        segment(0.8f, 0.85f, 0.5f, 1.0f);
-        segment(0.5f, 1.0f, 0.2f, 0.85f);
-        segment(0.3f, 0.0f, 0.8f, 0.0f);
-        break;
-    case 'K':
-        segment(0.0f, 0.0f, 0.0f, 1.0f);
-        segment(0.8f, 0.0f, 0.0f, 0.5f);
-        segment(0.0f, 0.5f, 0.8f, 1.0f);
-        break;
-    case 'X':
-        segment(0.0f, 0.0f, 0.8f, 1.0f);
-        segment(0.8f, 0.0f, 0.0f, 1.0f);
-        break;
-    case 'Z':
-        segment(0.0f, 0.0f, 0.8f, 0.0f);
-        segment(0.8f, 0.0f, 0.0f, 1.0f);
-        segment(0.0f, 1.0f, 0.8f, 1.0f);
-        break;
-    case '.':
-        segment(0.4f, 0.9f, 0.6f, 0.9f);
-        segment(0.6f, 0.9f, 0.6f, 1.0f);
-        segment(0.6f, 1.0f, 0.4f, 1.0f);
-        segment(0.4f, 1.0f, 0.4f, 0.9f);
-        break;
-    case '!':
-        segment(0.5f, 0.0f, 0.5f, 0.65f);
-        segment(0.4f, 0.85f, 0.6f, 0.85f);
-        segment(0.6f, 0.85f, 0.6f, 1.0f);
-        segment(0.6f, 1.0f, 0.4f, 1.0f);
-        segment(0.4f, 1.0f, 0.4f, 0.85f);
-        break;
-    case '>':
-        segment(0.2f, 0.0f, 0.8f, 0.5f);
-        segment(0.8f, 0.5f, 0.2f, 1.0f);
-        break;
-    case '<':
-        segment(0.8f, 0.0f, 0.2f, 0.5f);
-        segment(0.2f, 0.5f, 0.8f, 1.0f);
-        break;
-    case '-':
-        segment(0.2f, 0.5f, 0.8f, 0.5f);
-        break;
-    case ' ':
-        break;
-    default:
-        segment(0.0f, 0.0f, 1.0f, 1.0f);
-        segment(1.0f, 0.0f, 0.0f, 1.0f);
-        break;
-    }
-    glEnd();
-}
-
-static float measureText(float scale, const char* text) {
-    float width = 0.0f;
-    for (const char* p = text; *p; ++p) {
-        char c = *p;
-        if (c == ' ') {
-            width += scale * 0.7f;
-        } else if (c == '\n') {
-            // We only use single-line text for width calculations here.
-            break;
-        } else {
-            width += scale * 1.0f;
-        }
-    }
-    return width;
-}
-
-static void drawText(float x, float y, float scale, const char* text) {
-    float cursor = x;
-    glLineWidth(2.0f);
-    for (const char* p = text; *p; ++p) {
-        char c = *p;
-        if (c == ' ') {
-            cursor += scale * 0.7f;
-        } else if (c == '\n') {
-            y += scale * 1.2f;
-            cursor = x;
-        } else {
-            drawChar(cursor, y, scale, c);
-            cursor += scale * 1.0f;
-        }
-    }
-}
+// Render benchmark: fixed seed for the match and effects, warm-up frames
+// per scene, and how often the one-shot win/lose screens restart
+static const unsigned int BenchSeed = 0xBE4C4u;
+static const int BenchWarmupFrames = 30;
+static const int BenchReplayFrames = 240;
 
 static const float kPaddleColorPresets[4][3] = {
     {0.2f, 0.95f, 1.0f},
@@ -363,10 +69,10 @@ static void hsvToRgb(float h, float s, float v, float& r, float& g, float& b) {
     }
 }
 
-static void applyRandomVividColor(Paddle* paddle) {
+static void applyRandomVividColor(Paddle* paddle, Rng& rng) {
     if (!paddle) return;
 
-    float h = (float)(std::rand() % 360) / 360.0f;
+    float h = rng.nextFloat();
     float r, g, b;
     hsvToRgb(h, 0.9f, 1.0f, r, g, b);
     paddle->colorR = r;
@@ -410,17 +116,13 @@ bool Game::init() {
         return false;
     }
 
-    std::srand((unsigned int)SDL_GetPerformanceCounter());
+    fxRng.seed(benchFrames > 0 ? BenchSeed : SDL_GetPerformanceCounter(), RNG_STREAM_COSMETIC);
     
-    // Initialize audio system (non-critical - game continues if audio fails)
-    if (!AudioManager::getInstance().init()) {
-        std::fprintf(stderr, "Warning: Audio initialization failed. Continuing without sound.\n");
-    } else {
-        // Apply initial audio settings
-        AudioManager::getInstance().setMuted(!soundEnabled);
-        AudioManager::getInstance().setUIVolume(volumePercent * 128 / 100);
+    // Pre-converted assets; anything not in the pack is loaded from loose files
+    if (!AssetPack::getInstance().open()) {
+        std::printf("No %s found, decoding loose asset files\n", AssetPackDefaultPath);
     }
-
+    
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 2);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
@@ -436,6 +138,8 @@ bool Game::init() {
         std::fprintf(stderr, "SDL_CreateWindow error: %s\n", SDL_GetError());
         return false;
     }
+    // The court is the window; keep it a size replays and peers will accept
+    SDL_SetWindowMinimumSize(window, MinCourtWidth, MinCourtHeight);
 
     glContext = SDL_GL_CreateContext(window);
     if (!glContext) {
@@ -443,7 +147,7 @@ bool Game::init() {
         return false;
     }
 
-    SDL_GL_SetSwapInterval(1); // vsync
+    SDL_GL_SetSwapInterval(benchFrames > 0 ? 0 : 1); // vsync, off when benchmarking
 
     glViewport(0, 0, width, height);
     glClearColor(0.06f, 0.07f, 0.10f, 1.0f);
@@ -451,36 +155,63 @@ bool Game::init() {
     glDepthFunc(GL_LEQUAL);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    Renderer::getInstance().init();
+    Renderer::getInstance().setGpuTiming(Profiler::getInstance().isEnabled());
     resetProjection();
 
-    // Load splash screen texture
-    const char* splashPath = "assets/Logos/ChatGPT Image Feb 8, 2026, 01_07_20 PM.png";
-    if (!loadSplashTexture(splashPath)) {
-        std::fprintf(stderr, "Warning: Could not load splash screen image. Continuing without it.\n");
-        inSplashScreen = false;
-        inStartScreen = true;
-        paused = true;
-        currentMenu = MENU_MAIN;
-    } else {
-        inSplashScreen = true;
-        inStartScreen = false;
-        splashTimer = 0.0;
-    }
-
     // Create entities
-    const int paddleW = 16;
-    const int paddleH = 120;
-    const float paddleSpeed = 600.0f;
-
-    paddle1 = new Paddle(40.0f, (height - paddleH) * 0.5f, paddleW, paddleH, paddleSpeed,
+    paddle1 = new Paddle(PaddleInset, (height - PaddleHeight) * 0.5f, PaddleWidth, PaddleHeight, PaddleSpeed,
                          SDL_SCANCODE_W, SDL_SCANCODE_S, SDL_SCANCODE_A, SDL_SCANCODE_D);
-    paddle2 = new Paddle(width - 40.0f - paddleW, (height - paddleH) * 0.5f, paddleW, paddleH, paddleSpeed,
+    paddle2 = new Paddle(width - PaddleInset - PaddleWidth, (height - PaddleHeight) * 0.5f, PaddleWidth, PaddleHeight, PaddleSpeed,
                          SDL_SCANCODE_UP, SDL_SCANCODE_DOWN, SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT);
 
     applyPresetToPaddle(paddle1, p1ColorIndex);
     applyPresetToPaddle(paddle2, p2ColorIndex);
 
-    ball = new Ball(width * 0.5f, height * 0.5f, 420.0f, 140.0f, 10);
+    ball = new Ball(width * 0.5f, height * 0.5f, 0.0f, 0.0f, BallRadius);
+
+    // Match state lives in the headless simulation; the entities above only render it
+    startMatch();
+
+    // Show the (still empty) splash right away; everything else loads behind it
+    inSplashScreen = true;
+    inStartScreen = false;
+    splashTimer = 0.0;
+    Renderer::getInstance().beginFrame();
+    render();
+    Renderer::getInstance().endFrame();
+    SDL_GL_SwapWindow(window);
+
+    AssetLoader& loader = AssetLoader::getInstance();
+    loader.start();
+
+    // The splash decodes on a worker and is uploaded here once it is ready
+    const char* splashPath = "assets/Logos/ChatGPT Image Feb 8, 2026, 01_07_20 PM.png";
+    loader.submit([this, splashPath]() {
+        decodeSplashImage(splashPath);
+    }, [this]() {
+        uploadSplashTexture();
+    });
+
+    // Initialize audio system (non-critical - game continues if audio fails)
+    if (!AudioManager::getInstance().init()) {
+        std::fprintf(stderr, "Warning: Audio initialization failed. Continuing without sound.\n");
+    } else {
+        // Apply initial audio settings
+        AudioManager::getInstance().setMuted(!soundEnabled);
+        AudioManager::getInstance().setUIVolume(volumePercent / 100.0f);
+        AudioManager::getInstance().loadSoundsAsync();
+    }
+
+    if (netplay && !openNetplay()) {
+        return false;
+    }
+    if (broadcastPort != 0 && !broadcaster.open(broadcastPort)) {
+        return false;
+    }
+    if (spectating && !viewer.connect(spectateAddress)) {
+        return false;
+    }
 
     perfFreq = SDL_GetPerformanceFrequency();
     lastCounter = SDL_GetPerformanceCounter();
@@ -489,12 +220,10 @@ bool Game::init() {
 }
 
 void Game::resetProjection() {
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
+    Renderer& gfx = Renderer::getInstance();
     // 2D ortho in screen space; we can still extend to 3D later
-    glOrtho(0.0, (GLdouble)width, (GLdouble)height, 0.0, -1.0, 1.0);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    gfx.ortho(0.0f, (float)width, (float)height, 0.0f, -1.0f, 1.0f);
+    gfx.loadIdentity();
 }
 
 int Game::menuHitTest(float my) const {
@@ -515,7 +244,7 @@ int Game::menuHitTest(float my) const {
         spacing = 18.0f * 1.6f;
         if (currentMenu == MENU_MAIN) count = hasActiveGame ? 4 : 3;
         else if (currentMenu == MENU_PLAY) count = 5;
-        else if (currentMenu == MENU_SETTINGS) count = 13;
+        else if (currentMenu == MENU_SETTINGS) count = 14;
     } else if (currentMenu == MENU_PAUSE) {
         float hs = 28.0f;
         float hy = (float)height * 0.3f;
@@ -545,17 +274,19 @@ void Game::handleEvents() {
         } else if (e.type == SDL_EVENT_KEY_DOWN) {
             SDL_Scancode sc = e.key.scancode;
 
+            if (sc == SDL_SCANCODE_F3 && !e.key.repeat) {
+                // Profiler overlay; turns recording on the first time
+                profilerOverlay = !profilerOverlay;
+                if (profilerOverlay) setProfiling(true);
+                continue;
+            }
+
             if (inSplashScreen) {
-                // Skip splash screen on any key press
-                inSplashScreen = false;
-                inStartScreen = true;
-                paused = true;
-                currentMenu = MENU_MAIN;
-                menuSelection = 0;
-                menuAnimTimer = 0.0;
-                labelTimer = 0.0;
+                // Skip splash screen on any key press (once loading is done)
+                splashTimer = splashDuration();
             } else if (inStartScreen) {
-                if (sc == SDL_SCANCODE_RETURN || sc == SDL_SCANCODE_KP_ENTER) {
+                // Online, the start screen waits for the other player (or the broadcast) instead
+                if (!netplay && !spectating && (sc == SDL_SCANCODE_RETURN || sc == SDL_SCANCODE_KP_ENTER)) {
                     AudioManager::getInstance().playUI(UISound::OPEN_MENU);
                     inStartScreen = false;
                     currentMenu = MENU_MAIN;
@@ -573,6 +304,8 @@ void Game::handleEvents() {
                         inWinLoseScreen = false;
                         winLoseShowPrompt = false;
                         winLoseTimer = 0.0;
+                        if (netplay) endNetplay();
+                        if (spectating) endSpectating();
                         // Transition to main menu after win/lose
                         currentMenu = MENU_MAIN;
                         gameOver = false;
@@ -666,31 +399,22 @@ void Game::handleEvents() {
                                     }
 
                                     if (p1RandomColor) {
-                                        applyRandomVividColor(paddle1);
+                                        applyRandomVividColor(paddle1, fxRng);
                                     } else {
                                         applyPresetToPaddle(paddle1, p1ColorIndex);
                                     }
 
                                     if (p2RandomColor) {
-                                        applyRandomVividColor(paddle2);
+                                        applyRandomVividColor(paddle2, fxRng);
                                     } else {
                                         applyPresetToPaddle(paddle2, p2ColorIndex);
                                     }
 
                                     gameOver = false;
-                                    koWin = false;
-                                    score1 = score2 = 0;
-                                    health1 = health2 = maxHealth;
-                                    boostMeter1 = boostMeter2 = 0.0f;
-                                    boostActive1 = boostActive2 = false;
-                                    shieldHeld1 = shieldHeld2 = false;
-                                    shieldCooldown1 = shieldCooldown2 = 0.0f;
-                                    shieldPickup1.active = shieldPickup2.active = false;
-                                    boostParticleCount1 = boostParticleCount2 = 0;
-                                    paddle1->x = 40.0f;
-                                    paddle1->y = (float)(height - paddle1->height) * 0.5f;
-                                    paddle2->x = (float)width - 40.0f - (float)paddle2->width;
-                                    paddle2->y = (float)(height - paddle2->height) * 0.5f;
+                                    startMatch();
+                                    AudioManager::getInstance().playMusic(endlessMode ? MusicTrack::ENDLESS
+                                                                          : gameMode == MODE_BATTLE ? MusicTrack::BATTLE
+                                                                          : MusicTrack::CLASSIC);
                                     paused = false;
                                     currentMenu = MENU_NONE;
                                     hasActiveGame = true;
@@ -802,8 +526,9 @@ void Game::handleEvents() {
                                 labelTimer = 0.0;
                             }
                         } else if (currentMenu == MENU_SETTINGS) {
-                            // SETTINGS: SCORE, AI, SIDE, MOVEMENT, BOOST, SHIELD, HP, VISUAL FX, SOUND, VOLUME, P1 INPUT, P2 INPUT, BACK
-                            const int itemCount = 13;
+                            // SETTINGS: SCORE, AI, SIDE, MOVEMENT, BOOST, SHIELD, HP, VISUAL FX, SOUND, VOLUME, P1 INPUT, P2 INPUT,
+                            // BALLS, BACK
+                            const int itemCount = 14;
                             if (sc == SDL_SCANCODE_UP) {
                                 AudioManager::getInstance().playUI(UISound::SELECT);
                                 menuSelection = (menuSelection - 1 + itemCount) % itemCount;
@@ -811,7 +536,7 @@ void Game::handleEvents() {
                                 AudioManager::getInstance().playUI(UISound::SELECT);
                                 menuSelection = (menuSelection + 1) % itemCount;
                             } else if (sc == SDL_SCANCODE_RETURN || sc == SDL_SCANCODE_KP_ENTER) {
-                                if (menuSelection == 12) {
+                                if (menuSelection == 13) {
                                     // BACK
                                     AudioManager::getInstance().playUI(UISound::CANCEL);
                                     currentMenu = hasActiveGame && !gameOver ? MENU_PAUSE : MENU_MAIN;
@@ -836,19 +561,10 @@ void Game::handleEvents() {
                                         playerSide = (playerSide == 1) ? 2 : 1;
                                     } else if (menuSelection == 3) {
                                         freeMovement = !freeMovement;
-                                        if (!freeMovement) {
-                                            paddle1->x = 40.0f;
-                                            paddle2->x = (float)width - 40.0f - (float)paddle2->width;
-                                        }
                                     } else if (menuSelection == 4) {
                                         autoBoostEnabled = !autoBoostEnabled;
                                     } else if (menuSelection == 5) {
                                         shieldEnabled = !shieldEnabled;
-                                        if (!shieldEnabled) {
-                                            shieldHeld1 = shieldHeld2 = false;
-                                            shieldCooldown1 = shieldCooldown2 = 0.0f;
-                                            shieldPickup1.active = shieldPickup2.active = false;
-                                        }
                                     } else if (menuSelection == 6) {
                                         maxHealthIndex = (maxHealthIndex + 1) % 4;
                                         maxHealth = MaxHealthOptions[maxHealthIndex];
@@ -864,7 +580,7 @@ void Game::handleEvents() {
                                         else if (volumePercent == 50) volumePercent = 75;
                                         else if (volumePercent == 75) volumePercent = 100;
                                         else volumePercent = 25;
-                                        AudioManager::getInstance().setUIVolume(volumePercent * 128 / 100);
+                                        AudioManager::getInstance().setUIVolume(volumePercent / 100.0f);
                                     } else if (menuSelection == 10) {
                                         // Toggle P1 input (mutual exclusion with P2)
                                         p1UseMouse = !p1UseMouse;
@@ -873,6 +589,9 @@ void Game::handleEvents() {
                                         // Toggle P2 input (mutual exclusion with P1)
                                         p2UseMouse = !p2UseMouse;
                                         if (p2UseMouse) p1UseMouse = false;
+                                    } else if (menuSelection == 12) {
+                                        // Cycle multi-ball: 1 → 3 → 10 → 50 → 100 → 250 → 1
+                                        ballCountIndex = (ballCountIndex + 1) % 6;
                                     }
                                 }
                                 labelTimer = 0.0;
@@ -901,6 +620,7 @@ void Game::handleEvents() {
                                 } else if (menuSelection == 2) {
                                     // Main Menu
                                     AudioManager::getInstance().playUI(UISound::CLOSE_MENU);
+                                    AudioManager::getInstance().stopMusic();
                                     currentMenu = MENU_MAIN;
                                     gameOver = false;
                                     menuSelection = 0;
@@ -942,15 +662,11 @@ void Game::handleEvents() {
             mouseX = e.button.x;
             mouseY = e.button.y;
             if (inSplashScreen) {
-                // Skip splash screen on mouse click
+                // Skip splash screen on mouse click (once loading is done)
                 AudioManager::getInstance().playUI(UISound::OPEN_MENU);
-                inSplashScreen = false;
-                inStartScreen = true;
-                paused = true;
-                currentMenu = MENU_MAIN;
-                menuSelection = 0;
-                menuAnimTimer = 0.0;
-                labelTimer = 0.0;
+                splashTimer = splashDuration();
+            } else if (inStartScreen && (netplay || spectating)) {
+                // Waiting for the other player or the broadcast
             } else if (inStartScreen) {
                 AudioManager::getInstance().playUI(UISound::OPEN_MENU);
                 inStartScreen = false;
@@ -964,6 +680,8 @@ void Game::handleEvents() {
                 inWinLoseScreen = false;
                 winLoseShowPrompt = false;
                 winLoseTimer = 0.0;
+                if (netplay) endNetplay();
+                if (spectating) endSpectating();
                 currentMenu = MENU_MAIN;
                 gameOver = false;
                 menuSelection = 0;
@@ -989,6 +707,7 @@ void Game::handleEvents() {
 }
 
 void Game::update(double dt) {
+    PROFILE_SCOPE(PROFILE_UPDATE);
     menuAnimTimer += dt;
 
     if (ballExplosionTimer > 0.0) {
@@ -1004,34 +723,16 @@ void Game::update(double dt) {
         }
 
         if (lastAiWin && loseShatterActive) {
+            PROFILE_SCOPE(PROFILE_PARTICLES);
             loseShatterTimer += dt;
             float slow = 0.4f;
             float step = (float)(dt * slow);
 
-            for (int i = 0; i < loseShardCount; ++i) {
-                LoseShard& s = loseShards[i];
-                if (!s.active) continue;
-                s.vx += s.ax * step;
-                s.vy += s.ay * step;
-                s.x += s.vx * step;
-                s.y += s.vy * step;
-                s.angle += s.angularVelocity * step;
-                s.life += (float)dt;
-                if (s.life >= s.maxLife) {
-                    s.active = false;
-                }
-            }
-
-            for (int i = 0; i < loseWispCount; ++i) {
-                LoseWisp& w = loseWisps[i];
-                if (!w.active) continue;
-                w.x += w.vx * step;
-                w.y += w.vy * step;
-                w.life += (float)dt;
-                if (w.life >= w.maxLife) {
-                    w.active = false;
-                }
-            }
+            // Motion runs in slow motion; lifetimes still count real time
+            loseShards.integrate(step);
+            loseShards.age((float)dt);
+            loseWisps.integrate(step);
+            loseWisps.age((float)dt);
         }
 
         if (!lastAiWin && winDanceActive) {
@@ -1039,7 +740,19 @@ void Game::update(double dt) {
         }
     }
 
+    if (netplay) {
+        updateNetplay();
+    }
+    if (spectating) {
+        updateSpectating();
+    }
+
     if (inStartScreen || paused || gameOver) {
+        // Don't bank time while the match is halted, or it would all replay on resume
+        simAccumulator = 0.0;
+        renderAlpha = 1.0f;
+        // Spectators keep showing the court (and the win screen) meanwhile
+        if (hasActiveGame) broadcaster.idle(match);
         return;
     }
 
@@ -1049,577 +762,591 @@ void Game::update(double dt) {
         if (scoreFlashTimer < 0.0) scoreFlashTimer = 0.0;
     }
 
-    const bool* keys = SDL_GetKeyboardState(nullptr);
-    
-    // Boost activation: P1 = Shift, P2 = RCtrl
-    bool p1WantsBoost = keys[SDL_SCANCODE_LSHIFT] || keys[SDL_SCANCODE_RSHIFT];
-    bool p2WantsBoost = keys[SDL_SCANCODE_RCTRL];
-    
-    // Handle boost for P1
-    if (autoBoostEnabled) {
-        // Auto-boost: activate automatically when meter > 0
-        boostActive1 = (boostMeter1 > 0.0f);
+    if (spectating) {
+        // The broadcaster simulates; blend across the gap between its frames
+        spectateFrameAge += dt;
+        renderAlpha = gameOver ? 1.0f : (float)std::min(1.0, spectateFrameAge / spectateFrameGap);
     } else {
-        // Manual boost: hold key while having meter
-        boostActive1 = (p1WantsBoost && boostMeter1 > 0.0f);
-    }
-    
-    // Detect boost activation for sound
-    if (boostActive1 && !boostActive1Prev) {
-        AudioManager::getInstance().playGameSound(GameSound::BOOST_ACTIVATE);
-    }
-    boostActive1Prev = boostActive1;
-    
-    // Drain boost meter while active
-    if (boostActive1) {
-        boostMeter1 -= BoostDrainRate * (float)dt;
-        if (boostMeter1 <= 0.0f) {
-            boostMeter1 = 0.0f;
-            boostActive1 = false;
+        // Step the match in fixed ticks; leftover time becomes the render blend factor
+        const double tickDt = 1.0 / tickRate;
+        simAccumulator += dt;
+        int ticks = 0;
+        Profiler::getInstance().begin(PROFILE_SIM);
+        while (simAccumulator >= tickDt && !gameOver) {
+            if (ticks == MaxTicksPerFrame) {
+                // Can't keep up: drop the backlog rather than falling further behind
+                simAccumulator = 0.0;
+                break;
+            }
+            fixedUpdate((float)tickDt);
+            simAccumulator -= tickDt;
+            ++ticks;
         }
+        Profiler::getInstance().end(PROFILE_SIM);
+        renderAlpha = gameOver ? 1.0f : (float)(simAccumulator / tickDt);
     }
-    
-    // Handle boost for P2 (only in 2-player mode)
-    if (!singlePlayer) {
-        if (autoBoostEnabled) {
-            boostActive2 = (boostMeter2 > 0.0f);
+
+    // Boost particle update & emission
+    if (fxEnabled) {
+        PROFILE_SCOPE(PROFILE_PARTICLES);
+        float fdt = (float)dt;
+        // Update existing particles
+        boostParticles1.integrate(fdt);
+        boostParticles1.age(fdt);
+        boostParticles2.integrate(fdt);
+        boostParticles2.age(fdt);
+        // Emit along the trails that boost events started
+        boostTrail1 = boostTrail1 && match.boostActive1;
+        boostTrail2 = boostTrail2 && match.boostActive2;
+        if (boostTrail1) {
+            boostEmitTimer1 += fdt;
+            while (boostEmitTimer1 >= BoostEmitInterval) {
+                boostEmitTimer1 -= BoostEmitInterval;
+                int i = boostParticles1.spawn();
+                if (i < 0) continue;
+                ParticleSystem& p = boostParticles1;
+                float randY = fxRng.nextFloat();
+                p.x[i] = match.paddle1.x;
+                p.y[i] = match.paddle1.y + randY * match.paddle1.height;
+                p.vx[i] = -fxRng.range(40.0f, 100.0f);
+                p.vy[i] = fxRng.range(-30.0f, 30.0f);
+                p.maxLife[i] = fxRng.range(0.3f, 0.6f);
+                p.size[i] = fxRng.range(2.0f, 5.0f);
+                p.r[i] = 0.3f; p.g[i] = 0.7f; p.b[i] = 1.0f;
+            }
         } else {
-            boostActive2 = (p2WantsBoost && boostMeter2 > 0.0f);
-        }
-        
-        // Detect boost activation for sound
-        if (boostActive2 && !boostActive2Prev) {
-            AudioManager::getInstance().playGameSound(GameSound::BOOST_ACTIVATE);
+            boostEmitTimer1 = 0.0f;
         }
-        boostActive2Prev = boostActive2;
-        
-        if (boostActive2) {
-            boostMeter2 -= BoostDrainRate * (float)dt;
-            if (boostMeter2 <= 0.0f) {
-                boostMeter2 = 0.0f;
-                boostActive2 = false;
+        if (boostTrail2) {
+            boostEmitTimer2 += fdt;
+            while (boostEmitTimer2 >= BoostEmitInterval) {
+                boostEmitTimer2 -= BoostEmitInterval;
+                int i = boostParticles2.spawn();
+                if (i < 0) continue;
+                ParticleSystem& p = boostParticles2;
+                float randY = fxRng.nextFloat();
+                p.x[i] = match.paddle2.x + match.paddle2.width;
+                p.y[i] = match.paddle2.y + randY * match.paddle2.height;
+                p.vx[i] = fxRng.range(40.0f, 100.0f);
+                p.vy[i] = fxRng.range(-30.0f, 30.0f);
+                p.maxLife[i] = fxRng.range(0.3f, 0.6f);
+                p.size[i] = fxRng.range(2.0f, 5.0f);
+                p.r[i] = 0.3f; p.g[i] = 0.7f; p.b[i] = 1.0f;
             }
+        } else {
+            boostEmitTimer2 = 0.0f;
         }
     }
-    
-    // Shield system (Battle Mode only when enabled)
-    if (shieldEnabled && gameMode == MODE_BATTLE && ball) {
-        float fdt = (float)dt;
+}
 
-        // Tick down cooldowns (used in fixed movement mode)
-        if (shieldCooldown1 > 0.0f) {
-            shieldCooldown1 -= fdt;
-            if (shieldCooldown1 < 0.0f) shieldCooldown1 = 0.0f;
+void Game::fixedUpdate(float dt) {
+    copyMatchState(match, prevMatch);
+    if (netMatchLive) {
+        // Only this side's paddle reads the keyboard. The session may rewind
+        // `match` and re-simulate a few ticks before stepping it.
+        MatchInput local = gatherInput();
+        if (!net.advance(match, playerSide == 1 ? local.p1 : local.p2, dt, &stepEvents)) {
+            return;   // waiting for the other player
         }
-        if (shieldCooldown2 > 0.0f) {
-            shieldCooldown2 -= fdt;
-            if (shieldCooldown2 < 0.0f) shieldCooldown2 = 0.0f;
+        // Spectators get the predicted state too; a rollback just shows up a frame later
+        broadcaster.publish(match, net.config(), stepEvents);
+        // A predicted win can still be rolled back; only a confirmed one ends the match
+        // Events come from every tick stepped, re-simulated ones included
+        handleMatchEvents(stepEvents, stepEvents.kinds & ~EVENT_MATCH_OVER);
+        if (net.confirmedWinner(match) != 0) {
+            beginWinLoseScreen();
         }
+        return;
+    }
 
-        if (freeMovement) {
-            // --- COLLECTIBLE SHIELD MODE ---
-            // Spawn pickups when ball is piercing, no active pickup, player doesn't hold one
-            float pickupSize = 18.0f;
-            float floatInset = 60.0f; // how far from wall edge the pickup floats to
-
-            auto spawnPickup = [&](ShieldPickup& pickup, bool held, float xMin, float xMax) {
-                if (pickup.active || held || !ball->isPiercing) return;
-                pickup.x = xMin + ((float)(std::rand() % 100) / 100.0f) * (xMax - xMin);
-                bool fromTop = (std::rand() % 2 == 0);
-                pickup.y = fromTop ? -pickupSize : (float)height + pickupSize;
-                pickup.targetY = fromTop ? floatInset : ((float)height - floatInset);
-                pickup.bobTimer = 0.0f;
-                pickup.active = true;
-            };
+    MatchConfig cfg;
+    MatchInput in;
+    if (replayMode) {
+        // Everything comes from the file; the keyboard is ignored
+        if (!replay.next(cfg, in)) {
+            finishReplay();
+            return;
+        }
+    } else {
+        cfg = buildMatchConfig();
+        in = gatherInput();
+        recorder.record(cfg, in);
+    }
+    stepMatch(match, cfg, in, dt, &stepEvents);
+    broadcaster.publish(match, cfg, stepEvents);
+    handleMatchEvents(stepEvents, stepEvents.kinds);
+    if (replayMode && replay.atEnd()) {
+        finishReplay();
+    }
+}
 
-            float p1XMin = 0.0f;
-            float p1XMax = (float)width * 0.45f - pickupSize;
-            float p2XMin = (float)width * 0.55f;
-            float p2XMax = (float)width - pickupSize;
-
-            spawnPickup(shieldPickup1, shieldHeld1, p1XMin, p1XMax);
-            spawnPickup(shieldPickup2, shieldHeld2, p2XMin, p2XMax);
-
-            // Animate pickups sliding in and bobbing
-            auto updatePickup = [&](ShieldPickup& pickup) {
-                if (!pickup.active) return;
-                // Slide toward target Y
-                float dy = pickup.targetY - pickup.y;
-                float slideSpeed = 200.0f;
-                if (std::fabs(dy) > 1.0f) {
-                    float step = (dy > 0 ? 1.0f : -1.0f) * slideSpeed * fdt;
-                    if (std::fabs(step) > std::fabs(dy)) step = dy;
-                    pickup.y += step;
-                }
-                pickup.bobTimer += fdt;
-            };
-            updatePickup(shieldPickup1);
-            updatePickup(shieldPickup2);
+bool Game::loadReplay(const char* path) {
+    replayMode = replay.load(path);
+    if (replayMode) {
+        setTickRate(replay.tickRate());
+    }
+    return replayMode;
+}
 
-            // Despawn pickups if ball is no longer piercing
-            if (!ball->isPiercing) {
-                shieldPickup1.active = false;
-                shieldPickup2.active = false;
-            }
+void Game::startReplayMatch() {
+    adoptMatchConfig(replay.initialConfig());
+    replay.restart(match);
+    enterMatch();
+}
 
-            // Check paddle-pickup collection
-            auto checkCollect = [&](ShieldPickup& pickup, Paddle* pad, bool& held) {
-                if (!pickup.active || !pad || held) return;
-                float px0 = pad->x;
-                float py0 = pad->y;
-                float pw = (float)pad->width;
-                float ph = (float)pad->height;
-                float sx0 = pickup.x - pickupSize * 0.5f;
-                float sy0 = pickup.y - pickupSize * 0.5f;
-                if (aabbOverlap(px0, py0, pw, ph, sx0, sy0, pickupSize, pickupSize)) {
-                    held = true;
-                    pickup.active = false;
-                    AudioManager::getInstance().playUI(UISound::EQUIP);
-                    AudioManager::getInstance().playGameSound(GameSound::SHIELD_COLLECT);
-                }
-            };
-            checkCollect(shieldPickup1, paddle1, shieldHeld1);
-            checkCollect(shieldPickup2, paddle2, shieldHeld2);
-        } else {
-            // --- FIXED MOVEMENT: KEY-ACTIVATED ONE-USE SHIELD ---
-            if (shieldEnabled) {
-                if (singlePlayer) {
-                // Player activates shield
-                bool& pHeld = (playerSide == 1) ? shieldHeld1 : shieldHeld2;
-                float& pCooldown = (playerSide == 1) ? shieldCooldown1 : shieldCooldown2;
-                if (keys[SDL_SCANCODE_SPACE] && !pHeld && pCooldown <= 0.0f) {
-                    pHeld = true;
-                }
+void Game::adoptMatchConfig(const MatchConfig& cfg) {
+    // Mirror rules set elsewhere (a replay, the netplay host) so the HUD matches
+    gameMode = cfg.mode;
+    freeMovement = cfg.freeMovement;
+    autoBoostEnabled = cfg.autoBoost;
+    shieldEnabled = cfg.shieldEnabled;
+    maxHealth = cfg.maxHealth;
+    targetScore = cfg.targetScore;
+    endlessMode = (cfg.targetScore == 0);
+    singlePlayer = cfg.aiControlled1 || cfg.aiControlled2;
+    playerSide = cfg.aiControlled1 ? 2 : 1;
+    aiDifficulty = cfg.aiControlled1 ? cfg.aiDifficulty1 : cfg.aiDifficulty2;
+    ballCountIndex = 0;
+    for (int i = 0; i < 6; ++i) {
+        if (BallCountOptions[i] == cfg.ballCount) ballCountIndex = i;
+    }
+}
 
-                // AI activates shield
-                bool& aiHeld = (playerSide == 1) ? shieldHeld2 : shieldHeld1;
-                float& aiCooldown = (playerSide == 1) ? shieldCooldown2 : shieldCooldown1;
-                Paddle* aiPaddle = (playerSide == 1) ? paddle2 : paddle1;
-                if (!aiHeld && aiCooldown <= 0.0f && ball->isPiercing) {
-                    bool ballTowardAI = (playerSide == 1) ? (ball->velX > 0) : (ball->velX < 0);
-                    if (ballTowardAI) {
-                        float dist = std::fabs(ball->x - (aiPaddle->x + aiPaddle->width * 0.5f));
-                        bool activate = false;
-                        switch (aiDifficulty) {
-                            case AI_EASY: activate = false; break;
-                            case AI_MEDIUM: activate = (dist < 200.0f && ball->wallBounceCount >= 2); break;
-                            case AI_HARD: activate = (dist < 300.0f); break;
-                        }
-                        if (activate) {
-                            aiHeld = true;
-                            // AI shield activation (quiet sound)
-                            AudioManager::getInstance().setUIVolume(AudioManager::getInstance().getUIVolume() * 0.5f);
-                            AudioManager::getInstance().playUI(UISound::EQUIP);
-                            AudioManager::getInstance().setUIVolume(volumePercent / 100.0f);
-                        }
-                    }
-                }
-            } else {
-                // PvP: P1 = Space, P2 = RAlt
-                if (keys[SDL_SCANCODE_SPACE] && !shieldHeld1 && shieldCooldown1 <= 0.0f) {
-                    shieldHeld1 = true;
-                    AudioManager::getInstance().playUI(UISound::EQUIP);
-                }
-                if (keys[SDL_SCANCODE_RALT] && !shieldHeld2 && shieldCooldown2 <= 0.0f) {
-                    shieldHeld2 = true;
-                    AudioManager::getInstance().playUI(UISound::EQUIP);
-                }
-            }
-        }
+void Game::enterMatch() {
+    // Leave the menus for a match that was just reset
+    copyMatchState(match, prevMatch);
+    simAccumulator = 0.0;
+    renderAlpha = 1.0f;
+    boostParticles1.clear();
+    boostParticles2.clear();
+    syncRenderEntities();
+
+    inStartScreen = false;
+    paused = false;
+    gameOver = false;
+    currentMenu = MENU_NONE;
+    hasActiveGame = true;
+    labelTimer = 0.0;
+}
+
+void Game::finishReplay() {
+    bool ok = replay.matches(match);
+    std::printf("Replay finished after %u ticks, score %d-%d: %s\n", replay.tickCount(),
+                match.score1, match.score2, ok ? "state matches the recording" : "STATE DIVERGED");
+    replayMode = false;
+    if (!gameOver) {
+        paused = true;
+        hasActiveGame = false;
+        currentMenu = MENU_MAIN;
+        menuSelection = 0;
     }
+}
 
-    // Apply boost multiplier to paddle speeds temporarily
-    float originalSpeed1 = paddle1->speed;
-    float originalSpeed2 = paddle2->speed;
-    if (boostActive1) paddle1->speed *= BoostMultiplier;
-    if (boostActive2) paddle2->speed *= BoostMultiplier;
-    
-    if (singlePlayer && ball) {
-        // Determine which paddle is player-controlled and which is AI
-        Paddle* playerPaddle = (playerSide == 1) ? paddle1 : paddle2;
-        Paddle* aiPaddle = (playerSide == 1) ? paddle2 : paddle1;
-        
-        // Player input (keyboard or mouse)
-        if (p1UseMouse) {
-            float targetY = mouseY - playerPaddle->height * 0.5f;
-            if (targetY < 0.0f) targetY = 0.0f;
-            if (targetY > (float)(height - playerPaddle->height)) targetY = (float)(height - playerPaddle->height);
-            playerPaddle->y = targetY;
-            playerPaddle->setVerticalSpeed(0.0f);
-            if (freeMovement) {
-                float pMinX = (playerSide == 1) ? 0.0f : (float)width * 0.55f;
-                float pMaxX = (playerSide == 1) ? ((float)width * 0.45f - (float)playerPaddle->width) : ((float)width - (float)playerPaddle->width);
-                float targetX = mouseX - playerPaddle->width * 0.5f;
-                if (targetX < pMinX) targetX = pMinX;
-                if (targetX > pMaxX) targetX = pMaxX;
-                playerPaddle->x = targetX;
-                playerPaddle->setHorizontalSpeed(0.0f);
-            }
-        } else {
-            playerPaddle->handleInput(keys, freeMovement);
-        }
-        
-        // AI control
-        float paddleCenterY = aiPaddle->y + aiPaddle->height * 0.5f;
-        int aiHealth = (playerSide == 1) ? health2 : health1;
-        
-        // Difficulty-based AI parameters
-        float speedMult, reactionMult, predictionBlend;
-        switch (aiDifficulty) {
-            case AI_EASY:
-                speedMult = 0.55f;
-                reactionMult = 2.0f;
-                predictionBlend = 0.4f;
-                break;
-            case AI_MEDIUM:
-                speedMult = 0.75f;
-                reactionMult = 3.5f;
-                predictionBlend = 0.75f;
-                break;
-            case AI_HARD:
-            default:
-                speedMult = 0.95f;
-                reactionMult = 5.0f;
-                predictionBlend = 1.0f;
-                break;
-        }
+void Game::saveMatchRecording() {
+    if (!recorder.isRecording() || recorder.tickCount() == 0) {
+        return;
+    }
+    recorder.finish(match);
+    if (recorder.save(ReplayLastMatchPath)) {
+        std::printf("Match replay saved to %s (%u ticks)\n", ReplayLastMatchPath, recorder.tickCount());
+    }
+}
 
-        // Predictive AI: calculate where ball will be when it reaches AI paddle
-        float targetY = ball->y;
-        bool ballMovingTowardAI = (playerSide == 1) ? (ball->velX > 0) : (ball->velX < 0);
-        if (ballMovingTowardAI) {
-            float timeToReach = std::fabs((aiPaddle->x - ball->x) / ball->velX);
-            if (timeToReach > 0 && timeToReach < 2.0f) {
-                float predictedY = ball->y + ball->velY * timeToReach;
-                // Handle wall bounces in prediction
-                float screenH = (float)height;
-                int maxBounces = 10;
-                int bounces = 0;
-                while ((predictedY < 0 || predictedY > screenH) && bounces < maxBounces) {
-                    if (predictedY < 0) predictedY = -predictedY;
-                    else if (predictedY > screenH) predictedY = 2 * screenH - predictedY;
-                    bounces++;
-                }
-                // Blend between current ball Y and predicted Y based on difficulty
-                targetY = ball->y * (1.0f - predictionBlend) + predictedY * predictionBlend;
-            }
-        } else {
-            // Ball moving away: drift toward ready position (screen center)
-            float readyY = (float)height * 0.5f;
-            float driftBlend = 0.0f;
-            switch (aiDifficulty) {
-                case AI_EASY:   driftBlend = 0.15f; break;
-                case AI_MEDIUM: driftBlend = 0.35f; break;
-                case AI_HARD:   driftBlend = 0.55f; break;
-            }
-            targetY = ball->y * (1.0f - driftBlend) + readyY * driftBlend;
+void Game::hostNetplay(unsigned short port) {
+    netplay = true;
+    netHosting = true;
+    netPort = port;
+}
+
+bool Game::joinNetplay(const char* address) {
+    netplay = parseNetAddress(address, NetDefaultPort, netHostAddress);
+    netHosting = false;
+    return netplay;
+}
+
+void Game::setNetplayInputDelay(int ticks) {
+    netInputDelay = ticks;
+}
+
+void Game::setNetplayLag(int ticks) {
+    netLagTicks = ticks;
+}
+
+bool Game::openNetplay() {
+    bool ok = netHosting
+        ? net.host(netPort, (unsigned int)SDL_GetPerformanceCounter(), tickRate, buildMatchConfig())
+        : net.join(netHostAddress);
+    if (!ok) {
+        return false;
+    }
+    net.setInputDelay(netInputDelay);
+    net.setSimulatedLag(netLagTicks, netLagTicks / 4, 0);
+    return true;
+}
+
+void Game::updateNetplay() {
+    bool connected = net.poll();
+    if (net.peerLost()) {
+        bool midMatch = netMatchLive && !gameOver;
+        endNetplay();
+        if (midMatch || inStartScreen) {
+            // Nothing left to play online; carry on with the local menus
+            inStartScreen = false;
+            paused = true;
+            hasActiveGame = false;
+            currentMenu = MENU_MAIN;
+            menuSelection = 0;
         }
+        return;
+    }
+    if (connected && !netMatchLive && inStartScreen) {
+        startNetMatch();
+    }
+}
 
-        // AI shield pickup seeking - runs BEFORE dodge logic so it can override
-        // Works in BOTH movement modes
-        bool seekingShield = false;
-        float shieldTargetY = targetY;
-        float shieldTargetX = aiPaddle->x; // Only used in free movement
-        bool shieldOverrideDodge = false;
-        
-        if (shieldEnabled && gameMode == MODE_BATTLE && ball->isPiercing && freeMovement) {
-            ShieldPickup& aiPickup = (playerSide == 1) ? shieldPickup2 : shieldPickup1;
-            bool aiHasShield = (playerSide == 1) ? shieldHeld2 : shieldHeld1;
-            if (aiPickup.active && !aiHasShield) {
-                float pickupCenterY = aiPickup.y;
-                float pickupCenterX = aiPickup.x;
-                float padCenterY = aiPaddle->y + aiPaddle->height * 0.5f;
-                float padCenterX = aiPaddle->x + aiPaddle->width * 0.5f;
-                float distY = std::fabs(pickupCenterY - padCenterY);
-                float distX = std::fabs(pickupCenterX - padCenterX);
-                float distTotal = std::sqrt(distX * distX + distY * distY);
-                
-                switch (aiDifficulty) {
-                    case AI_EASY:
-                        // Easy AI doesn't understand shield importance
-                        seekingShield = false;
-                        break;
-                    case AI_MEDIUM: {
-                        // Medium AI seeks when pickup is reasonably close
-                        // More aggressive when health is low
-                        float seekRange = (aiHealth <= 2) ? 400.0f : 250.0f;
-                        seekingShield = (distTotal < seekRange);
-                        // Override dodge when critically low health
-                        shieldOverrideDodge = (aiHealth <= 2) && (distTotal < 300.0f);
-                        break;
-                    }
-                    case AI_HARD:
-                        // Hard AI always seeks aggressively
-                        seekingShield = true;
-                        // Only override dodge if shield is very close and worth the risk
-                        shieldOverrideDodge = (distTotal < 150.0f) || (aiHealth <= 2);
-                        break;
-                }
-                
-                if (seekingShield) {
-                    shieldTargetY = pickupCenterY;
-                    shieldTargetX = pickupCenterX;
-                }
-            }
+void Game::startNetMatch() {
+    // Both sides play by the host's rules, field size included
+    const MatchConfig& cfg = net.config();
+    adoptMatchConfig(cfg);
+    playerSide = net.localSide();
+    setTickRate(net.tickRate());
+    if (cfg.width != width || cfg.height != height) {
+        SDL_SetWindowSize(window, cfg.width, cfg.height);
+    }
+
+    // Not recorded: a replay needs every tick once, in order, and rollback
+    // re-simulates them
+    net.startMatch(match);
+    netMatchLive = true;
+    AudioManager::getInstance().playMusic(gameMode == MODE_BATTLE ? MusicTrack::BATTLE : MusicTrack::CLASSIC);
+    enterMatch();
+}
+
+void Game::endNetplay() {
+    if (netMatchLive) {
+        const NetSession::Stats& st = net.stats();
+        std::printf("Netplay: %u ticks, %u rollbacks re-simulating %u ticks (deepest %d, slowest %.2f ms), "
+                    "%u waits%s\n", net.frame(), st.rollbacks, st.resimulatedTicks, st.maxRollback,
+                    st.maxRollbackMs, st.stallTicks, net.desynced() ? ", DESYNCED" : "");
+    }
+    net.close();
+    netplay = false;
+    netMatchLive = false;
+}
+
+void Game::broadcastMatches(unsigned short port) {
+    broadcastPort = port;
+}
+
+bool Game::spectate(const char* address) {
+    spectating = parseNetAddress(address, SpectatorDefaultPort, spectateAddress);
+    return spectating;
+}
+
+void Game::updateSpectating() {
+    bool fresh = viewer.poll();
+    if (viewer.publisherLost()) {
+        std::printf("Spectator: the broadcast went quiet\n");
+        bool midMatch = hasActiveGame && !gameOver;
+        endSpectating();
+        if (midMatch) {
+            inStartScreen = false;
+            paused = true;
+            hasActiveGame = false;
+            currentMenu = MENU_MAIN;
+            menuSelection = 0;
         }
+        return;
+    }
+    if (!fresh) {
+        return;
+    }
 
-        // Red ball avoidance in Battle Mode
-        // Check if AI already has a shield - if so, don't dodge (stay and block)
-        bool aiHasShield = (playerSide == 1) ? shieldHeld2 : shieldHeld1;
-        bool shouldDodge = false;
-        if (gameMode == MODE_BATTLE && ball->isPiercing && ballMovingTowardAI && !aiHasShield) {
-            switch (aiDifficulty) {
-                case AI_EASY:
-                    // Easy AI doesn't understand red ball danger
-                    shouldDodge = false;
-                    break;
-                case AI_MEDIUM:
-                    // Medium AI dodges when health critical or many wall bounces
-                    // But if we're seeking shield and health is critical, shield takes priority
-                    if (!shieldOverrideDodge) {
-                        shouldDodge = (aiHealth <= 2) || (ball->wallBounceCount >= 3);
-                    }
-                    break;
-                case AI_HARD:
-                    // Hard AI always dodges unless shield override
-                    if (!shieldOverrideDodge) {
-                        shouldDodge = true;
-                    }
-                    break;
-            }
+    if (viewer.configVersion() != spectateConfigVersion) {
+        // First frame, or the broadcaster changed its rules (or the field size)
+        spectateConfigVersion = viewer.configVersion();
+        const MatchConfig& cfg = viewer.config();
+        adoptMatchConfig(cfg);
+        if (cfg.width != width || cfg.height != height) {
+            SDL_SetWindowSize(window, cfg.width, cfg.height);
         }
+    }
+    spectateFrameGap += (std::min(std::max(spectateFrameAge, 1.0 / 240.0), 0.25) - spectateFrameGap) * 0.1;
+    spectateFrameAge = 0.0;
+
+    copyMatchState(match, prevMatch);
+    viewer.latestState(match);
+    viewer.takeEvents(stepEvents);
+
+    // Start watching, or follow the broadcaster into its next match
+    if (inStartScreen || (inWinLoseScreen && match.winner == 0)) {
+        inWinLoseScreen = false;
+        winLoseShowPrompt = false;
+        winLoseTimer = 0.0;
+        AudioManager::getInstance().playMusic(gameMode == MODE_BATTLE ? MusicTrack::BATTLE : MusicTrack::CLASSIC);
+        enterMatch();
+        return;
+    }
+    if (gameOver) {
+        return;
+    }
+    handleMatchEvents(stepEvents, stepEvents.kinds & ~EVENT_MATCH_OVER);
+    if (match.winner != 0) {
+        beginWinLoseScreen();
+    }
+}
+
+void Game::endSpectating() {
+    if (viewer.isOpen()) {
+        std::printf("Spectator: %u KB received\n", viewer.bytesReceived() / 1024);
+    }
+    viewer.close();
+    spectating = false;
+    spectateConfigVersion = 0;
+}
 
-        if (shouldDodge) {
-            // Move away from predicted ball position
-            float dodgeDist = (float)aiPaddle->height * 1.5f;
-            float screenH = (float)height;
-            // Dodge toward whichever side has more room
-            if (targetY > screenH * 0.5f) {
-                targetY -= dodgeDist;
-            } else {
-                targetY += dodgeDist;
-            }
-            float halfH = (float)aiPaddle->height * 0.5f;
-            if (targetY < halfH) targetY = halfH;
-            if (targetY > screenH - halfH) targetY = screenH - halfH;
-        }
+void Game::setTickRate(int hz) {
+    if (hz < MinTickRate) hz = MinTickRate;
+    if (hz > MaxTickRate) hz = MaxTickRate;
+    tickRate = hz;
+}
 
-        // If seeking shield, override targetY with shield position
-        // But blend if both dodge and shield seeking are active
-        if (seekingShield) {
-            if (shouldDodge && !shieldOverrideDodge) {
-                // Blend: 60% toward shield, 40% dodge direction
-                targetY = shieldTargetY * 0.6f + targetY * 0.4f;
-            } else {
-                // Full shield seeking
-                targetY = shieldTargetY;
-            }
-        }
+MatchConfig Game::buildMatchConfig() const {
+    MatchConfig cfg = {};
+    cfg.width = width;
+    cfg.height = height;
+    cfg.mode = gameMode;
+    cfg.freeMovement = freeMovement;
+    cfg.autoBoost = autoBoostEnabled;
+    cfg.shieldEnabled = shieldEnabled;
+    cfg.maxHealth = maxHealth;
+    cfg.targetScore = endlessMode ? 0 : targetScore;
+    cfg.aiControlled1 = singlePlayer && playerSide == 2;
+    cfg.aiControlled2 = singlePlayer && playerSide == 1;
+    cfg.aiDifficulty1 = aiDifficulty;
+    cfg.aiDifficulty2 = aiDifficulty;
+    cfg.ballCount = BallCountOptions[ballCountIndex];
+    return cfg;
+}
 
-        float diff = targetY - paddleCenterY;
-
-        float maxSpeed = aiPaddle->speed * speedMult;
-        float desiredVy = diff * reactionMult;
-        if (desiredVy > maxSpeed) desiredVy = maxSpeed;
-        if (desiredVy < -maxSpeed) desiredVy = -maxSpeed;
-
-        aiPaddle->setVerticalSpeed(desiredVy);
-
-        // AI horizontal movement in free movement mode
-        if (freeMovement) {
-            float aiDefaultX = (playerSide == 1)
-                ? (float)(width - 40 - aiPaddle->width)
-                : 40.0f;
-            float advanceTarget = aiDefaultX;
-            
-            // If seeking shield, prioritize moving toward shield X
-            if (seekingShield) {
-                // Override normal tracking - move directly toward pickup
-                advanceTarget = shieldTargetX;
-            } else if (ballMovingTowardAI && !shouldDodge) {
-                float advanceFraction = 0.0f;
-                switch (aiDifficulty) {
-                    case AI_EASY:   advanceFraction = 0.05f; break;
-                    case AI_MEDIUM: advanceFraction = 0.15f; break;
-                    case AI_HARD:   advanceFraction = 0.25f; break;
-                }
-                // Health-aware: advance less when health is low
-                if (gameMode == MODE_BATTLE && aiHealth <= 3) {
-                    advanceFraction *= 0.3f;
-                }
-                float centerX = (float)width * 0.5f;
-                advanceTarget = aiDefaultX + (centerX - aiDefaultX) * advanceFraction;
-            }
-            
-            float hDiff = advanceTarget - (aiPaddle->x + aiPaddle->width * 0.5f);
-            float hSpeed = hDiff * reactionMult;
-            if (hSpeed > maxSpeed) hSpeed = maxSpeed;
-            if (hSpeed < -maxSpeed) hSpeed = -maxSpeed;
-            aiPaddle->setHorizontalSpeed(hSpeed);
-        } else {
-            aiPaddle->setHorizontalSpeed(0.0f);
-        }
+MatchInput Game::gatherInput() const {
+    const bool* keys = SDL_GetKeyboardState(nullptr);
+    MatchInput in = {};
+
+    if (benchAutoplay) {
+        // Render benchmark: both paddles chase the ball with a drifting aim
+        // error that lets the odd goal through, and burn boost whenever they can
+        float drift = 75.0f * std::sin((float)match.tick * 0.013f);
+        auto chase = [&](PaddleInput& pin, const SimPaddle& pad, float error) {
+            pin.usePointer = true;
+            pin.pointerX = pad.x + pad.width * 0.5f;
+            pin.pointerY = match.balls[0].y + error;
+            pin.boost = true;
+            pin.shield = match.balls[0].isPiercing;
+        };
+        chase(in.p1, match.paddle1, drift);
+        chase(in.p2, match.paddle2, -drift);
+        return in;
+    }
+
+    auto readPaddle = [&](PaddleInput& pin, const Paddle* pad, bool useMouse) {
+        pin.up = keys[pad->upKey];
+        pin.down = keys[pad->downKey];
+        pin.left = keys[pad->leftKey];
+        pin.right = keys[pad->rightKey];
+        pin.usePointer = useMouse;
+        pin.pointerX = mouseX;
+        pin.pointerY = mouseY;
+    };
+
+    if (singlePlayer || netMatchLive) {
+        // The human plays with P1's keys and controls whichever side was picked
+        // (online: whichever side this peer plays)
+        PaddleInput& pin = (playerSide == 1) ? in.p1 : in.p2;
+        readPaddle(pin, paddle1, p1UseMouse);
+        pin.boost = keys[SDL_SCANCODE_LSHIFT] || keys[SDL_SCANCODE_RSHIFT];
+        pin.shield = keys[SDL_SCANCODE_SPACE];
     } else {
-        // PvP: each player can independently use keyboard or mouse
-        float p1MinX = 0.0f;
-        float p1MaxX = (float)width * 0.45f - (float)paddle1->width;
-        float p2MinX = (float)width * 0.55f;
-        float p2MaxX = (float)width - (float)paddle2->width;
-
-        if (p1UseMouse) {
-            float targetY = mouseY - paddle1->height * 0.5f;
-            if (targetY < 0.0f) targetY = 0.0f;
-            if (targetY > (float)(height - paddle1->height)) targetY = (float)(height - paddle1->height);
-            paddle1->y = targetY;
-            paddle1->setVerticalSpeed(0.0f);
-            if (freeMovement) {
-                float targetX = mouseX - paddle1->width * 0.5f;
-                if (targetX < p1MinX) targetX = p1MinX;
-                if (targetX > p1MaxX) targetX = p1MaxX;
-                paddle1->x = targetX;
-                paddle1->setHorizontalSpeed(0.0f);
-            }
-        } else {
-            paddle1->handleInput(keys, freeMovement);
-        }
-        if (p2UseMouse) {
-            float targetY = mouseY - paddle2->height * 0.5f;
-            if (targetY < 0.0f) targetY = 0.0f;
-            if (targetY > (float)(height - paddle2->height)) targetY = (float)(height - paddle2->height);
-            paddle2->y = targetY;
-            paddle2->setVerticalSpeed(0.0f);
-            if (freeMovement) {
-                float targetX = mouseX - paddle2->width * 0.5f;
-                if (targetX < p2MinX) targetX = p2MinX;
-                if (targetX > p2MaxX) targetX = p2MaxX;
-                paddle2->x = targetX;
-                paddle2->setHorizontalSpeed(0.0f);
-            }
-        } else {
-            paddle2->handleInput(keys, freeMovement);
-        }
+        // PvP: P1 = W/S + Shift + Space, P2 = arrows + RCtrl + RAlt
+        readPaddle(in.p1, paddle1, p1UseMouse);
+        readPaddle(in.p2, paddle2, p2UseMouse);
+        in.p1.boost = keys[SDL_SCANCODE_LSHIFT] || keys[SDL_SCANCODE_RSHIFT];
+        in.p1.shield = keys[SDL_SCANCODE_SPACE];
+        in.p2.boost = keys[SDL_SCANCODE_RCTRL];
+        in.p2.shield = keys[SDL_SCANCODE_RALT];
+    }
+    return in;
+}
+
+void Game::syncRenderEntities() {
+    // Draw positions are blended between the last two ticks so motion stays smooth
+    // whatever the tick rate is relative to the display refresh
+    const float a = renderAlpha;
+    auto lerp = [a](float from, float to) { return from + (to - from) * a; };
+
+    auto syncPaddle = [&](Paddle* pad, const SimPaddle& prev, const SimPaddle& sp) {
+        if (!pad) return;
+        pad->x = lerp(prev.x, sp.x);
+        pad->y = lerp(prev.y, sp.y);
+        pad->width = sp.width;
+        pad->height = sp.height;
+    };
+    syncPaddle(paddle1, prevMatch.paddle1, match.paddle1);
+    syncPaddle(paddle2, prevMatch.paddle2, match.paddle2);
+
+    if (ball) {
+        const SimBall& sb = match.balls[0];
+        bool teleported = ballServed(0);
+        ball->x = teleported ? sb.x : lerp(prevMatch.balls[0].x, sb.x);
+        ball->y = teleported ? sb.y : lerp(prevMatch.balls[0].y, sb.y);
+        ball->velX = sb.velX;
+        ball->velY = sb.velY;
+        ball->trailBoost = sb.trailBoost;
+        ball->rallyEnergy = sb.rallyEnergy;
+        ball->leftImpactTimer = sb.leftImpactTimer;
+        ball->rightImpactTimer = sb.rightImpactTimer;
+        ball->topImpactTimer = sb.topImpactTimer;
+        ball->bottomImpactTimer = sb.bottomImpactTimer;
+        ball->lastScoreX = sb.lastScoreX;
+        ball->lastScoreY = sb.lastScoreY;
+        ball->radius = sb.radius;
+        ball->isPiercing = sb.isPiercing;
+        ball->wallBounceCount = sb.wallBounceCount;
     }
+    // Multi-ball balls[1..] have no entities; render() blends them straight from the states
+}
 
-    {
-        float p1MinX = 0.0f;
-        float p1MaxX = (float)width * 0.45f - (float)paddle1->width;
-        float p2MinX = (float)width * 0.55f;
-        float p2MaxX = (float)width - (float)paddle2->width;
-        paddle1->move(dt, height, freeMovement, p1MinX, p1MaxX);
-        paddle2->move(dt, height, freeMovement, p2MinX, p2MaxX);
+bool Game::ballServed(int index) const {
+    // A goal re-serves the ball; don't smear it across the court
+    for (int i = 0; i < stepEvents.count; ++i) {
+        const SimEvent& e = stepEvents.queue[i];
+        if (e.type == EVENT_GOAL && e.ball == index) return true;
     }
-    
-    // Restore original speeds
-    paddle1->speed = originalSpeed1;
-    paddle2->speed = originalSpeed2;
+    return false;
+}
 
-    // Boost particle update & emission
-    if (fxEnabled) {
-        float fdt = (float)dt;
-        // Update existing particles
-        for (int i = 0; i < boostParticleCount1; ++i) {
-            BoostParticle& p = boostParticles1[i];
-            p.x += p.vx * fdt;
-            p.y += p.vy * fdt;
-            p.life -= fdt;
-            if (p.life <= 0.0f) {
-                boostParticles1[i] = boostParticles1[--boostParticleCount1];
-                --i;
+void Game::startMatch(unsigned int seed) {
+    // A local match ends any online one, or watching someone else's
+    if (netMatchLive) endNetplay();
+    if (viewer.isOpen()) endSpectating();
+    // An abandoned match still gets its replay written
+    saveMatchRecording();
+    if (seed == 0) seed = (unsigned int)SDL_GetPerformanceCounter();
+    resetMatch(match, buildMatchConfig(), seed);
+    if (benchFrames == 0) {
+        recorder.begin(seed, tickRate);
+    }
+    copyMatchState(match, prevMatch);
+    simAccumulator = 0.0;
+    renderAlpha = 1.0f;
+    boostParticles1.clear();
+    boostParticles2.clear();
+    syncRenderEntities();
+}
+
+void Game::handleMatchEvents(const SimEvents& queue, unsigned int ev) {
+    if (ev == 0) return;
+
+    // Details come from the step's queue. Kinds it had no room for (or that a
+    // spectator frame only carries as flags) still get handled, without them;
+    // a goal then explodes where balls[0] last left the field.
+    unsigned int handled = 0;
+    for (int i = 0; i < queue.count; ++i) {
+        const SimEvent& e = queue.queue[i];
+        if (!(ev & e.type)) continue;
+        handleMatchEvent(e, !(handled & e.type));
+        handled |= e.type;
+    }
+    for (unsigned int bit = 1; bit <= EVENT_MATCH_OVER; bit <<= 1) {
+        if ((ev & bit) && !(handled & bit)) {
+            SimEvent e = { (MatchEvent)bit, 0, -1, 0.0f, 0.0f };
+            if (bit == EVENT_GOAL) {
+                e.x = match.balls[0].lastScoreX;
+                e.y = match.balls[0].lastScoreY;
             }
+            handleMatchEvent(e, true);
         }
-        for (int i = 0; i < boostParticleCount2; ++i) {
-            BoostParticle& p = boostParticles2[i];
-            p.x += p.vx * fdt;
-            p.y += p.vy * fdt;
-            p.life -= fdt;
-            if (p.life <= 0.0f) {
-                boostParticles2[i] = boostParticles2[--boostParticleCount2];
-                --i;
+    }
+}
+
+void Game::handleMatchEvent(const SimEvent& e, bool firstOfKind) {
+    // Multi-ball raises a burst of the same event in one tick; one sound is plenty
+    AudioManager& audio = AudioManager::getInstance();
+    switch (e.type) {
+        case EVENT_WALL_BOUNCE:
+            if (firstOfKind) audio.playGameSound(GameSound::BALL_WALL_BOUNCE);
+            break;
+        case EVENT_PADDLE_HIT:
+            if (firstOfKind) audio.playGameSound(GameSound::BALL_HIT_NORMAL);
+            break;
+        case EVENT_HEALTH_LOSS:
+            if (firstOfKind) audio.playGameSound(GameSound::HEALTH_LOSS);
+            break;
+        case EVENT_BOOST_START:
+            if (firstOfKind) audio.playGameSound(GameSound::BOOST_ACTIVATE);
+            // First puff right away; a flag-only event (side 0) could be either paddle
+            if (e.side != 2 && !boostTrail1) {
+                boostTrail1 = true;
+                boostEmitTimer1 = BoostEmitInterval;
             }
-        }
-        // Emit new particles when boosting
-        float emitInterval = 0.03f;
-        if (boostActive1) {
-            boostEmitTimer1 += fdt;
-            while (boostEmitTimer1 >= emitInterval && boostParticleCount1 < MaxBoostParticles) {
-                boostEmitTimer1 -= emitInterval;
-                BoostParticle& p = boostParticles1[boostParticleCount1++];
-                float randY = ((std::rand() % 100) / 100.0f);
-                p.x = paddle1->x;
-                p.y = paddle1->y + randY * paddle1->height;
-                p.vx = -40.0f - (std::rand() % 60);
-                p.vy = ((std::rand() % 100) - 50) * 0.6f;
-                p.life = 0.3f + (std::rand() % 30) * 0.01f;
-                p.maxLife = p.life;
-                p.size = 2.0f + (std::rand() % 30) * 0.1f;
-                p.r = 0.3f; p.g = 0.7f; p.b = 1.0f;
-                p.active = true;
+            if (e.side != 1 && !boostTrail2) {
+                boostTrail2 = true;
+                boostEmitTimer2 = BoostEmitInterval;
             }
-        } else {
-            boostEmitTimer1 = 0.0f;
-        }
-        if (boostActive2) {
-            boostEmitTimer2 += fdt;
-            while (boostEmitTimer2 >= emitInterval && boostParticleCount2 < MaxBoostParticles) {
-                boostEmitTimer2 -= emitInterval;
-                BoostParticle& p = boostParticles2[boostParticleCount2++];
-                float randY = ((std::rand() % 100) / 100.0f);
-                p.x = paddle2->x + paddle2->width;
-                p.y = paddle2->y + randY * paddle2->height;
-                p.vx = 40.0f + (std::rand() % 60);
-                p.vy = ((std::rand() % 100) - 50) * 0.6f;
-                p.life = 0.3f + (std::rand() % 30) * 0.01f;
-                p.maxLife = p.life;
-                p.size = 2.0f + (std::rand() % 30) * 0.1f;
-                p.r = 0.3f; p.g = 0.7f; p.b = 1.0f;
-                p.active = true;
+            break;
+        case EVENT_SHIELD_ARMED:
+            if (firstOfKind) audio.playUI(UISound::EQUIP);
+            break;
+        case EVENT_SHIELD_AI_ARMED:
+            // Quieter than the player's own shield
+            if (firstOfKind) audio.playUI(UISound::EQUIP, 0.5f);
+            break;
+        case EVENT_SHIELD_COLLECT:
+            if (firstOfKind) {
+                audio.playUI(UISound::EQUIP);
+                audio.playGameSound(GameSound::SHIELD_COLLECT);
             }
-        } else {
-            boostEmitTimer2 = 0.0f;
-        }
+            break;
+        case EVENT_SHIELD_CONSUMED:
+            if (firstOfKind) audio.playUI(UISound::UNEQUIP);
+            break;
+        case EVENT_GOAL:
+            // Brief score flash and explosion where the ball left the field;
+            // several goals in one tick leave it at the last one
+            if (firstOfKind) audio.playGameSound(GameSound::BALL_GOAL_SCORED);
+            scoreFlashTimer = 0.3; // seconds
+            ballExplosionTimer = 0.2;
+            ballExplosionX = e.x;
+            ballExplosionY = e.y;
+            break;
+        case EVENT_MATCH_OVER:
+            beginWinLoseScreen();
+            break;
     }
+}
 
-    // Track shield state before ball update so we can detect consumption
-    bool s1Before = shieldHeld1;
-    bool s2Before = shieldHeld2;
-    ball->update(dt, width, height, *paddle1, *paddle2, score1, score2, health1, health2, boostMeter1, boostMeter2, gameMode == MODE_BATTLE, shieldHeld1, shieldHeld2);
-    // Detect shield consumption and play sound
-    if ((s1Before && !shieldHeld1) || (s2Before && !shieldHeld2)) {
-        AudioManager::getInstance().playUI(UISound::UNEQUIP);
-    }
-    // Start cooldown when shield is consumed (fixed mode only)
-    if (!freeMovement && shieldEnabled && gameMode == MODE_BATTLE) {
-        if (s1Before && !shieldHeld1) shieldCooldown1 = ShieldCooldown;
-        if (s2Before && !shieldHeld2) shieldCooldown2 = ShieldCooldown;
-    }
-    // Detect score changes to trigger a brief flash
-    if (score1 != lastScore1 || score2 != lastScore2) {
-        scoreFlashTimer = 0.3; // seconds
-        ballExplosionTimer = 0.2;
-        if (ball) {
-            ballExplosionX = ball->lastScoreX;
-            ballExplosionY = ball->lastScoreY;
-        }
-        lastScore1 = score1;
-        lastScore2 = score2;
-    }
-    // Check KO win condition (health depleted) - Battle Mode only
-    if (gameMode == MODE_BATTLE && (health1 <= 0 || health2 <= 0)) {
+void Game::beginWinLoseScreen() {
+    // Snapshot paddle positions/colors for the shatter and dance effects
+    renderAlpha = 1.0f;
+    syncRenderEntities();
+    AudioManager::getInstance().stopMusic(0.5f);
+    saveMatchRecording();
+
+    if (match.koWin) {
         gameOver = true;
         paused = true;
-        koWin = true;
         currentMenu = MENU_NONE;
 
         inWinLoseScreen = true;
         winLoseTimer = 0.0;
         winLoseShowPrompt = false;
 
-        lastWinner = (health2 <= 0) ? 1 : 2;
+        lastWinner = match.winner;
         lastAiWin = (singlePlayer && lastWinner == 2);
         loseShatterActive = false;
         winDanceActive = false;
-        loseShardCount = 0;
-        loseWispCount = 0;
+        loseShards.clear();
+        loseWisps.clear();
         orbitBallCount = 0;
         loseShatterTimer = 0.0;
         winDanceTimer = 0.0;
@@ -1643,54 +1370,52 @@ void Game::update(double dt) {
                 float px1 = px0 + losingPaddle->width;
                 float py1 = py0 + losingPaddle->height;
 
-                loseShardCount = MaxLoseShards;
-
-                for (int i = 0; i < loseShardCount; ++i) {
-                    LoseShard& s = loseShards[i];
-                    float rx = (float)std::rand() / (float)RAND_MAX;
-                    float ry = (float)std::rand() / (float)RAND_MAX;
-                    s.x = px0 + (px1 - px0) * rx;
-                    s.y = py0 + (py1 - py0) * ry;
-
-                    float dirX = (float)std::rand() / (float)RAND_MAX - 0.5f;
-                    float dirY = (float)std::rand() / (float)RAND_MAX - 0.2f;
-                    s.vx = dirX * 320.0f;
-                    s.vy = -100.0f + dirY * 100.0f;
-                    s.ax = 0.0f;
-                    s.ay = 750.0f;
-
-                    s.size = 8.0f + ((float)std::rand() / (float)RAND_MAX) * 18.0f;
-                    s.angle = ((float)std::rand() / (float)RAND_MAX) * 6.2831853f;
-                    s.angularVelocity = -5.0f + ((float)std::rand() / (float)RAND_MAX) * 10.0f;
-                    s.life = 0.0f;
-                    s.maxLife = 2.0f + ((float)std::rand() / (float)RAND_MAX) * 0.8f;
-                    s.r = losingPaddle->colorR;
-                    s.g = losingPaddle->colorG;
-                    s.b = losingPaddle->colorB;
-                    s.active = true;
+                for (int n = 0; n < LoseShardBurst; ++n) {
+                    int i = loseShards.spawn();
+                    if (i < 0) break;
+                    float rx = fxRng.nextFloat();
+                    float ry = fxRng.nextFloat();
+                    loseShards.x[i] = px0 + (px1 - px0) * rx;
+                    loseShards.y[i] = py0 + (py1 - py0) * ry;
+
+                    float dirX = fxRng.nextFloat() - 0.5f;
+                    float dirY = fxRng.nextFloat() - 0.2f;
+                    loseShards.vx[i] = dirX * 320.0f;
+                    loseShards.vy[i] = -100.0f + dirY * 100.0f;
+                    loseShards.ax[i] = 0.0f;
+                    loseShards.ay[i] = 750.0f;
+
+                    loseShards.size[i] = 8.0f + fxRng.nextFloat() * 18.0f;
+                    loseShards.angle[i] = fxRng.nextFloat() * 6.2831853f;
+                    loseShards.spin[i] = -5.0f + fxRng.nextFloat() * 10.0f;
+                    loseShards.life[i] = 0.0f;
+                    loseShards.maxLife[i] = 2.0f + fxRng.nextFloat() * 0.8f;
+                    loseShards.r[i] = losingPaddle->colorR;
+                    loseShards.g[i] = losingPaddle->colorG;
+                    loseShards.b[i] = losingPaddle->colorB;
                 }
             }
 
-            loseWispCount = MaxLoseWisps;
-            for (int i = 0; i < loseWispCount; ++i) {
-                LoseWisp& w = loseWisps[i];
-                float t = (float)i / (float)(loseWispCount > 0 ? loseWispCount : 1);
+            const int wispBurst = LoseWispBurst;
+            for (int n = 0; n < wispBurst; ++n) {
+                int i = loseWisps.spawn();
+                if (i < 0) break;
+                float t = (float)n / (float)wispBurst;
 
                 float baseX = losingPaddle ? losingPaddle->x + losingPaddle->width * 0.5f : (float)width * 0.25f;
                 float baseY = losingPaddle ? losingPaddle->y + losingPaddle->height * 0.5f : (float)height * 0.5f;
 
-                w.x = baseX + (t - 0.5f) * 100.0f;
-                w.y = baseY + 30.0f;
-                w.vx = ((float)std::rand() / (float)RAND_MAX - 0.5f) * 60.0f;
-                w.vy = -60.0f - ((float)std::rand() / (float)RAND_MAX) * 60.0f;
-                w.life = 0.0f;
-                w.maxLife = 2.5f + ((float)std::rand() / (float)RAND_MAX) * 1.5f;
+                loseWisps.x[i] = baseX + (t - 0.5f) * 100.0f;
+                loseWisps.y[i] = baseY + 30.0f;
+                loseWisps.vx[i] = (fxRng.nextFloat() - 0.5f) * 60.0f;
+                loseWisps.vy[i] = -60.0f - fxRng.nextFloat() * 60.0f;
+                loseWisps.life[i] = 0.0f;
+                loseWisps.maxLife[i] = 2.5f + fxRng.nextFloat() * 1.5f;
 
                 float cool = 0.5f + 0.5f * t;
-                w.r = losingPaddle ? losingPaddle->colorR * 0.5f * cool : 0.5f * cool;
-                w.g = losingPaddle ? losingPaddle->colorG * 0.7f * cool : 0.6f * cool;
-                w.b = losingPaddle ? losingPaddle->colorB : 1.0f;
-                w.active = true;
+                loseWisps.r[i] = losingPaddle ? losingPaddle->colorR * 0.5f * cool : 0.5f * cool;
+                loseWisps.g[i] = losingPaddle ? losingPaddle->colorG * 0.7f * cool : 0.6f * cool;
+                loseWisps.b[i] = losingPaddle ? losingPaddle->colorB : 1.0f;
             }
         } else {
             winDanceActive = true;
@@ -1714,9 +1439,9 @@ void Game::update(double dt) {
                 OrbitBall& ob = orbitBalls[i];
                 float t = (float)i / (float)orbitBallCount;
                 ob.angle = t * 6.2831853f;
-                ob.radius = 70.0f + 20.0f * std::sin(t * 6.2831853f);
-                ob.speed = 1.4f + 0.3f * ((float)std::rand() / (float)RAND_MAX);
-                ob.size = 6.0f + 4.0f * ((float)std::rand() / (float)RAND_MAX);
+                ob.radius = oscillate(t, 6.2831853f, 70.0f, 20.0f);
+                ob.speed = 1.4f + 0.3f * fxRng.nextFloat();
+                ob.size = 6.0f + 4.0f * fxRng.nextFloat();
 
                 float h = t;
                 float r, g, b;
@@ -1726,152 +1451,144 @@ void Game::update(double dt) {
                 ob.b = b;
             }
         }
-    }
+    } else {
+        gameOver = true;
+        paused = true;
+        currentMenu = MENU_NONE;
 
-    // Check competitive win condition if enabled
-    if (!endlessMode && targetScore > 0 && !gameOver) {
-        if (score1 >= targetScore || score2 >= targetScore) {
-            koWin = false;
-            gameOver = true;
-            paused = true;
-            currentMenu = MENU_NONE;
-
-            inWinLoseScreen = true;
-            winLoseTimer = 0.0;
-            winLoseShowPrompt = false;
-
-            lastWinner = (score1 > score2) ? 1 : 2;
-            lastAiWin = (singlePlayer && lastWinner == 2);
-            loseShatterActive = false;
-            winDanceActive = false;
-            loseShardCount = 0;
-            loseWispCount = 0;
-            orbitBallCount = 0;
-            loseShatterTimer = 0.0;
-            winDanceTimer = 0.0;
+        inWinLoseScreen = true;
+        winLoseTimer = 0.0;
+        winLoseShowPrompt = false;
 
-            // Play win/lose sound
-            if (lastAiWin) {
-                AudioManager::getInstance().playUI(UISound::CANCEL);  // Loss sound
-            } else {
-                AudioManager::getInstance().playUI(UISound::CONFIRM); // Win sound
+        lastWinner = match.winner;
+        lastAiWin = (singlePlayer && lastWinner == 2);
+        loseShatterActive = false;
+        winDanceActive = false;
+        loseShards.clear();
+        loseWisps.clear();
+        orbitBallCount = 0;
+        loseShatterTimer = 0.0;
+        winDanceTimer = 0.0;
+
+        // Play win/lose sound
+        if (lastAiWin) {
+            AudioManager::getInstance().playUI(UISound::CANCEL);  // Loss sound
+        } else {
+            AudioManager::getInstance().playUI(UISound::CONFIRM); // Win sound
+        }
+
+        if (lastAiWin) {
+            loseShatterActive = true;
+            // Play lose shatter sound
+            AudioManager::getInstance().playGameSound(GameSound::LOSE_SHATTER);
+
+            Paddle* losingPaddle = (lastWinner == 1) ? paddle2 : paddle1;
+            if (losingPaddle) {
+                float px0 = losingPaddle->x;
+                float py0 = losingPaddle->y;
+                float px1 = px0 + losingPaddle->width;
+                float py1 = py0 + losingPaddle->height;
+
+                for (int n = 0; n < LoseShardBurst; ++n) {
+                    int i = loseShards.spawn();
+                    if (i < 0) break;
+                    float rx = fxRng.nextFloat();
+                    float ry = fxRng.nextFloat();
+                    loseShards.x[i] = px0 + (px1 - px0) * rx;
+                    loseShards.y[i] = py0 + (py1 - py0) * ry;
+
+                    float dirX = fxRng.nextFloat() - 0.5f;
+                    float dirY = fxRng.nextFloat() - 0.2f;
+                    loseShards.vx[i] = dirX * 260.0f;
+                    loseShards.vy[i] = -80.0f + dirY * 80.0f;
+                    loseShards.ax[i] = 0.0f;
+                    loseShards.ay[i] = 650.0f;
+
+                    loseShards.size[i] = 6.0f + fxRng.nextFloat() * 14.0f;
+                    loseShards.angle[i] = fxRng.nextFloat() * 6.2831853f;
+                    loseShards.spin[i] = -4.0f + fxRng.nextFloat() * 8.0f;
+                    loseShards.life[i] = 0.0f;
+                    loseShards.maxLife[i] = 1.6f + fxRng.nextFloat() * 0.6f;
+                    loseShards.r[i] = losingPaddle->colorR;
+                    loseShards.g[i] = losingPaddle->colorG;
+                    loseShards.b[i] = losingPaddle->colorB;
+                }
             }
 
-            if (lastAiWin) {
-                loseShatterActive = true;
-                // Play lose shatter sound
-                AudioManager::getInstance().playGameSound(GameSound::LOSE_SHATTER);
+            const int wispBurst = LoseWispBurst / 2;
+            for (int n = 0; n < wispBurst; ++n) {
+                int i = loseWisps.spawn();
+                if (i < 0) break;
+                float t = (float)n / (float)wispBurst;
 
-                Paddle* losingPaddle = (lastWinner == 1) ? paddle2 : paddle1;
+                float baseX;
+                float baseY;
                 if (losingPaddle) {
-                    float px0 = losingPaddle->x;
-                    float py0 = losingPaddle->y;
-                    float px1 = px0 + losingPaddle->width;
-                    float py1 = py0 + losingPaddle->height;
-
-                    loseShardCount = MaxLoseShards;
-
-                    for (int i = 0; i < loseShardCount; ++i) {
-                        LoseShard& s = loseShards[i];
-                        float rx = (float)std::rand() / (float)RAND_MAX;
-                        float ry = (float)std::rand() / (float)RAND_MAX;
-                        s.x = px0 + (px1 - px0) * rx;
-                        s.y = py0 + (py1 - py0) * ry;
-
-                        float dirX = (float)std::rand() / (float)RAND_MAX - 0.5f;
-                        float dirY = (float)std::rand() / (float)RAND_MAX - 0.2f;
-                        s.vx = dirX * 260.0f;
-                        s.vy = -80.0f + dirY * 80.0f;
-                        s.ax = 0.0f;
-                        s.ay = 650.0f;
-
-                        s.size = 6.0f + ((float)std::rand() / (float)RAND_MAX) * 14.0f;
-                        s.angle = ((float)std::rand() / (float)RAND_MAX) * 6.2831853f;
-                        s.angularVelocity = -4.0f + ((float)std::rand() / (float)RAND_MAX) * 8.0f;
-                        s.life = 0.0f;
-                        s.maxLife = 1.6f + ((float)std::rand() / (float)RAND_MAX) * 0.6f;
-                        s.r = losingPaddle->colorR;
-                        s.g = losingPaddle->colorG;
-                        s.b = losingPaddle->colorB;
-                        s.active = true;
-                    }
+                    baseX = losingPaddle->x + losingPaddle->width * 0.5f;
+                    baseY = losingPaddle->y + losingPaddle->height * 0.5f;
+                } else {
+                    baseX = (float)width * 0.25f;
+                    baseY = (float)height * 0.5f;
                 }
 
-                loseWispCount = MaxLoseWisps / 2;
-                for (int i = 0; i < loseWispCount; ++i) {
-                    LoseWisp& w = loseWisps[i];
-                    float t = (float)i / (float)(loseWispCount > 0 ? loseWispCount : 1);
-
-                    float baseX;
-                    float baseY;
-                    if (losingPaddle) {
-                        baseX = losingPaddle->x + losingPaddle->width * 0.5f;
-                        baseY = losingPaddle->y + losingPaddle->height * 0.5f;
-                    } else {
-                        baseX = (float)width * 0.25f;
-                        baseY = (float)height * 0.5f;
-                    }
+                loseWisps.x[i] = baseX + (t - 0.5f) * 80.0f;
+                loseWisps.y[i] = baseY + 20.0f;
+                loseWisps.vx[i] = (fxRng.nextFloat() - 0.5f) * 40.0f;
+                loseWisps.vy[i] = -40.0f - fxRng.nextFloat() * 40.0f;
+                loseWisps.life[i] = 0.0f;
+                loseWisps.maxLife[i] = 2.0f + fxRng.nextFloat() * 1.0f;
 
-                    w.x = baseX + (t - 0.5f) * 80.0f;
-                    w.y = baseY + 20.0f;
-                    w.vx = ((float)std::rand() / (float)RAND_MAX - 0.5f) * 40.0f;
-                    w.vy = -40.0f - ((float)std::rand() / (float)RAND_MAX) * 40.0f;
-                    w.life = 0.0f;
-                    w.maxLife = 2.0f + ((float)std::rand() / (float)RAND_MAX) * 1.0f;
-
-                    float cool = 0.5f + 0.5f * t;
-                    if (losingPaddle) {
-                        w.r = losingPaddle->colorR * 0.5f * cool;
-                        w.g = losingPaddle->colorG * 0.7f * cool;
-                        w.b = losingPaddle->colorB;
-                    } else {
-                        w.r = 0.5f * cool;
-                        w.g = 0.6f * cool;
-                        w.b = 1.0f;
-                    }
-                    w.active = true;
-                }
-            } else {
-                winDanceActive = true;
-                winDanceTimer = 0.0;
-                // Play win dance sound
-                AudioManager::getInstance().playGameSound(GameSound::WIN_DANCE);
-
-                Paddle* winner = (lastWinner == 1) ? paddle1 : paddle2;
-                if (winner) {
-                    winPaddleStartX = winner->x + winner->width * 0.5f;
-                    winPaddleStartY = winner->y + winner->height * 0.5f;
+                float cool = 0.5f + 0.5f * t;
+                if (losingPaddle) {
+                    loseWisps.r[i] = losingPaddle->colorR * 0.5f * cool;
+                    loseWisps.g[i] = losingPaddle->colorG * 0.7f * cool;
+                    loseWisps.b[i] = losingPaddle->colorB;
                 } else {
-                    winPaddleStartX = (float)width * 0.25f;
-                    winPaddleStartY = (float)height * 0.5f;
-                }
-                winPaddleLandingX = (float)width * 0.5f;
-                winPaddleLandingY = (float)height * 0.5f;
-
-                orbitBallCount = MaxOrbitBalls;
-                for (int i = 0; i < orbitBallCount; ++i) {
-                    OrbitBall& ob = orbitBalls[i];
-                    float t = (float)i / (float)orbitBallCount;
-                    ob.angle = t * 6.2831853f;
-                    ob.radius = 70.0f + 20.0f * std::sin(t * 6.2831853f);
-                    ob.speed = 1.4f + 0.3f * ((float)std::rand() / (float)RAND_MAX);
-                    ob.size = 6.0f + 4.0f * ((float)std::rand() / (float)RAND_MAX);
-
-                    float h = t;
-                    float r, g, b;
-                    hsvToRgb(h, 0.9f, 1.0f, r, g, b);
-                    ob.r = r;
-                    ob.g = g;
-                    ob.b = b;
+                    loseWisps.r[i] = 0.5f * cool;
+                    loseWisps.g[i] = 0.6f * cool;
+                    loseWisps.b[i] = 1.0f;
                 }
             }
-            // Leave scores as-is so they can be displayed
+        } else {
+            winDanceActive = true;
+            winDanceTimer = 0.0;
+            // Play win dance sound
+            AudioManager::getInstance().playGameSound(GameSound::WIN_DANCE);
+
+            Paddle* winner = (lastWinner == 1) ? paddle1 : paddle2;
+            if (winner) {
+                winPaddleStartX = winner->x + winner->width * 0.5f;
+                winPaddleStartY = winner->y + winner->height * 0.5f;
+            } else {
+                winPaddleStartX = (float)width * 0.25f;
+                winPaddleStartY = (float)height * 0.5f;
+            }
+            winPaddleLandingX = (float)width * 0.5f;
+            winPaddleLandingY = (float)height * 0.5f;
+
+            orbitBallCount = MaxOrbitBalls;
+            for (int i = 0; i < orbitBallCount; ++i) {
+                OrbitBall& ob = orbitBalls[i];
+                float t = (float)i / (float)orbitBallCount;
+                ob.angle = t * 6.2831853f;
+                ob.radius = oscillate(t, 6.2831853f, 70.0f, 20.0f);
+                ob.speed = 1.4f + 0.3f * fxRng.nextFloat();
+                ob.size = 6.0f + 4.0f * fxRng.nextFloat();
+
+                float h = t;
+                float r, g, b;
+                hsvToRgb(h, 0.9f, 1.0f, r, g, b);
+                ob.r = r;
+                ob.g = g;
+                ob.b = b;
+            }
         }
     }
 }
-}
 
 void Game::render() {
+    Renderer& gfx = Renderer::getInstance();
+    syncRenderEntities();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Splash screen
@@ -1882,11 +1599,11 @@ void Game::render() {
 
     // Start screen: pure 2D UI
     if (inStartScreen) {
-        glDisable(GL_DEPTH_TEST);
+        gfx.setDepthTest(false);
         resetProjection();
-        glLoadIdentity();
+        gfx.loadIdentity();
 
-        glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+        gfx.color(1.0f, 1.0f, 1.0f, 1.0f);
 
         const char* title = "PINGPONG 3D";
         float titleScale = 32.0f;
@@ -1896,6 +1613,11 @@ void Game::render() {
         drawText(tx, ty, titleScale, title);
 
         const char* prompt = "PRESS ENTER";
+        if (netplay) {
+            prompt = net.isConnected() ? "STARTING" : netHosting ? "WAITING FOR OPPONENT" : "CONNECTING";
+        } else if (spectating) {
+            prompt = "WAITING FOR BROADCAST";
+        }
         float promptScale = 18.0f;
         float promptWidth = measureText(promptScale, prompt);
         float px = (float)width * 0.5f - promptWidth * 0.5f;
@@ -1906,10 +1628,10 @@ void Game::render() {
     }
 
     // 3D world pass: perspective projection for center line, paddles, ball
-    glEnable(GL_DEPTH_TEST);
+    Profiler& prof = Profiler::getInstance();
+    prof.begin(PROFILE_WORLD);
+    gfx.setDepthTest(true);
 
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
     double zNear = 10.0;
     double zFar = 2000.0;
     double camZ = 800.0;
@@ -1919,11 +1641,9 @@ void Game::render() {
     double ymin = -ymax;
     double xmax = halfW * zNear / camZ;
     double xmin = -xmax;
-    glFrustum(xmin, xmax, ymax, ymin, zNear, zFar);
-
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-    glTranslatef((float)-halfW, (float)-halfH, (float)-camZ);
+    gfx.frustum((float)xmin, (float)xmax, (float)ymax, (float)ymin, (float)zNear, (float)zFar);
+    gfx.loadIdentity();
+    gfx.translate((float)-halfW, (float)-halfH, (float)-camZ);
  
     float baseR = 0.02f;
     float baseG = 0.03f;
@@ -1994,71 +1714,71 @@ void Game::render() {
 
     if (fxEnabled) {
         float zFloor = -6.0f;
-        glBegin(GL_QUADS);
-        glColor4f(baseR, baseG, baseB, 1.0f);
-        glVertex3f(0.0f, 0.0f, zFloor);
-        glVertex3f((float)width, 0.0f, zFloor);
-        glColor4f(baseR2, baseG2, baseB2, 1.0f);
-        glVertex3f((float)width, (float)height, zFloor);
-        glVertex3f(0.0f, (float)height, zFloor);
-        glEnd();
+        gfx.begin(GL_QUADS);
+        gfx.color(baseR, baseG, baseB, 1.0f);
+        gfx.vertex(0.0f, 0.0f, zFloor);
+        gfx.vertex((float)width, 0.0f, zFloor);
+        gfx.color(baseR2, baseG2, baseB2, 1.0f);
+        gfx.vertex((float)width, (float)height, zFloor);
+        gfx.vertex(0.0f, (float)height, zFloor);
+        gfx.end();
     }
 
     // 3D middle dashed line
     if (fxEnabled) {
-        glColor4f(accentR, accentG, accentB, 0.3f);
+        gfx.color(accentR, accentG, accentB, 0.3f);
     } else {
-        glColor4f(1.0f, 1.0f, 1.0f, 0.25f);
+        gfx.color(1.0f, 1.0f, 1.0f, 0.25f);
     }
     for (int y = 0; y < height; y += 30) {
         float mx = width * 0.5f - 2.0f;
         float z = -5.0f;
-        glBegin(GL_QUADS);
-        glVertex3f(mx, (float)y, z);
-        glVertex3f(mx + 4.0f, (float)y, z);
-        glVertex3f(mx + 4.0f, (float)(y + 20), z);
-        glVertex3f(mx, (float)(y + 20), z);
-        glEnd();
+        gfx.begin(GL_QUADS);
+        gfx.vertex(mx, (float)y, z);
+        gfx.vertex(mx + 4.0f, (float)y, z);
+        gfx.vertex(mx + 4.0f, (float)(y + 20), z);
+        gfx.vertex(mx, (float)(y + 20), z);
+        gfx.end();
     }
 
     if (fxEnabled) {
         float zShadow = -4.9f;
 
-        glBegin(GL_QUADS);
-        glColor4f(0.0f, 0.0f, 0.0f, 0.35f);
+        gfx.begin(GL_QUADS);
+        gfx.color(0.0f, 0.0f, 0.0f, 0.35f);
         float p1x0 = paddle1->x;
         float p1x1 = paddle1->x + paddle1->width;
         float p1y0 = paddle1->y;
         float p1y1 = paddle1->y + paddle1->height;
-        glVertex3f(p1x0, p1y0, zShadow);
-        glVertex3f(p1x1, p1y0, zShadow);
-        glVertex3f(p1x1, p1y1, zShadow);
-        glVertex3f(p1x0, p1y1, zShadow);
-        glEnd();
-
-        glBegin(GL_QUADS);
-        glColor4f(0.0f, 0.0f, 0.0f, 0.35f);
+        gfx.vertex(p1x0, p1y0, zShadow);
+        gfx.vertex(p1x1, p1y0, zShadow);
+        gfx.vertex(p1x1, p1y1, zShadow);
+        gfx.vertex(p1x0, p1y1, zShadow);
+        gfx.end();
+
+        gfx.begin(GL_QUADS);
+        gfx.color(0.0f, 0.0f, 0.0f, 0.35f);
         float p2x0 = paddle2->x;
         float p2x1 = paddle2->x + paddle2->width;
         float p2y0 = paddle2->y;
         float p2y1 = paddle2->y + paddle2->height;
-        glVertex3f(p2x0, p2y0, zShadow);
-        glVertex3f(p2x1, p2y0, zShadow);
-        glVertex3f(p2x1, p2y1, zShadow);
-        glVertex3f(p2x0, p2y1, zShadow);
-        glEnd();
-
-        glBegin(GL_QUADS);
-        glColor4f(0.0f, 0.0f, 0.0f, 0.35f);
+        gfx.vertex(p2x0, p2y0, zShadow);
+        gfx.vertex(p2x1, p2y0, zShadow);
+        gfx.vertex(p2x1, p2y1, zShadow);
+        gfx.vertex(p2x0, p2y1, zShadow);
+        gfx.end();
+
+        gfx.begin(GL_QUADS);
+        gfx.color(0.0f, 0.0f, 0.0f, 0.35f);
         float bx0 = ball->x - ball->radius;
         float bx1 = ball->x + ball->radius;
         float by0 = ball->y - ball->radius;
         float by1 = ball->y + ball->radius;
-        glVertex3f(bx0, by0, zShadow);
-        glVertex3f(bx1, by0, zShadow);
-        glVertex3f(bx1, by1, zShadow);
-        glVertex3f(bx0, by1, zShadow);
-        glEnd();
+        gfx.vertex(bx0, by0, zShadow);
+        gfx.vertex(bx1, by0, zShadow);
+        gfx.vertex(bx1, by1, zShadow);
+        gfx.vertex(bx0, by1, zShadow);
+        gfx.end();
     }
 
     // 3D entities
@@ -2088,7 +1808,7 @@ void Game::render() {
 
             float hops = 5.0f;
             float hopPhase = (float)winDanceTimer * hops * 3.1415926f * 0.5f;
-            float hopAmount = std::fabs(std::sin(hopPhase));
+            float hopAmount = std::fabs(fastSin(hopPhase));
             float hopScale = (1.0f - u);
             float hopOffset = hopAmount * 40.0f * hopScale;
             float centerY = pathY - hopOffset;
@@ -2101,29 +1821,29 @@ void Game::render() {
             float offsetX = pathX - origCx;
             float offsetY = centerY - origCy;
 
-            glPushMatrix();
-            glTranslatef(offsetX, offsetY, 0.0f);
-            glTranslatef(origCx, origCy, 0.0f);
-            glScalef(scaleX, scaleY, 1.0f);
-            glTranslatef(-origCx, -origCy, 0.0f);
+            gfx.pushMatrix();
+            gfx.translate(offsetX, offsetY, 0.0f);
+            gfx.translate(origCx, origCy, 0.0f);
+            gfx.scale(scaleX, scaleY, 1.0f);
+            gfx.translate(-origCx, -origCy, 0.0f);
             winner->render();
-            glPopMatrix();
+            gfx.popMatrix();
         }
     } else {
         // Boost color tint: shift paddle toward cyan when boosting
         float savedR1 = 0, savedG1 = 0, savedB1 = 0;
         float savedR2 = 0, savedG2 = 0, savedB2 = 0;
-        if (paddle1 && boostActive1 && fxEnabled) {
+        if (paddle1 && match.boostActive1 && fxEnabled) {
             savedR1 = paddle1->colorR; savedG1 = paddle1->colorG; savedB1 = paddle1->colorB;
-            float pulse = 0.6f + 0.4f * std::sin((float)labelTimer * 10.0f);
+            float pulse = oscillate((float)labelTimer, 10.0f, 0.6f, 0.4f);
             float blend = 0.4f * pulse;
             paddle1->colorR = savedR1 * (1.0f - blend) + 0.3f * blend;
             paddle1->colorG = savedG1 * (1.0f - blend) + 0.85f * blend;
             paddle1->colorB = savedB1 * (1.0f - blend) + 1.0f * blend;
         }
-        if (paddle2 && boostActive2 && fxEnabled) {
+        if (paddle2 && match.boostActive2 && fxEnabled) {
             savedR2 = paddle2->colorR; savedG2 = paddle2->colorG; savedB2 = paddle2->colorB;
-            float pulse = 0.6f + 0.4f * std::sin((float)labelTimer * 10.0f);
+            float pulse = oscillate((float)labelTimer, 10.0f, 0.6f, 0.4f);
             float blend = 0.4f * pulse;
             paddle2->colorR = savedR2 * (1.0f - blend) + 0.3f * blend;
             paddle2->colorG = savedG2 * (1.0f - blend) + 0.85f * blend;
@@ -2133,27 +1853,38 @@ void Game::render() {
         if (paddle1) paddle1->render();
         if (paddle2) paddle2->render();
         if (ball) ball->render();
+        // Multi-ball: balls[1..], no trails or impact fx. Balls that only just
+        // joined have no previous position to blend from.
+        for (int i = 1; i < match.ballCount; ++i) {
+            const SimBall& sb = match.balls[i];
+            float x = sb.x, y = sb.y;
+            if (i < prevMatch.ballCount && !ballServed(i)) {
+                x = prevMatch.balls[i].x + (x - prevMatch.balls[i].x) * renderAlpha;
+                y = prevMatch.balls[i].y + (y - prevMatch.balls[i].y) * renderAlpha;
+            }
+            Ball::draw(x, y, sb.radius, sb.isPiercing);
+        }
 
         // Restore paddle colors
-        if (paddle1 && boostActive1 && fxEnabled) {
+        if (paddle1 && match.boostActive1 && fxEnabled) {
             paddle1->colorR = savedR1; paddle1->colorG = savedG1; paddle1->colorB = savedB1;
         }
-        if (paddle2 && boostActive2 && fxEnabled) {
+        if (paddle2 && match.boostActive2 && fxEnabled) {
             paddle2->colorR = savedR2; paddle2->colorG = savedG2; paddle2->colorB = savedB2;
         }
     }
 
     // Switch to 2D for HUD and menus on top
-    glDisable(GL_DEPTH_TEST);
+    gfx.setDepthTest(false);
     resetProjection();
-    glLoadIdentity();
+    gfx.loadIdentity();
 
     // Boost visual effects: paddle glow aura + particles
     if (fxEnabled) {
         // Paddle glow aura when boosting
         auto drawBoostGlow = [&](Paddle* pad, bool active) {
             if (!pad || !active) return;
-            float pulse = 0.5f + 0.5f * std::sin((float)labelTimer * 8.0f);
+            float pulse = oscillate((float)labelTimer, 8.0f, 0.5f, 0.5f);
             float glowPad = 12.0f + 4.0f * pulse;
             float gx0 = pad->x - glowPad;
             float gy0 = pad->y - glowPad;
@@ -2164,47 +1895,23 @@ void Game::render() {
             float alpha = 0.25f + 0.15f * pulse;
 
             // Radial glow using triangle fan
-            glBegin(GL_TRIANGLE_FAN);
-            glColor4f(0.3f, 0.8f, 1.0f, alpha);
-            glVertex2f(cx, cy);
-            glColor4f(0.2f, 0.6f, 1.0f, 0.0f);
-            glVertex2f(gx0, gy0);
-            glVertex2f(gx1, gy0);
-            glVertex2f(gx1, gy1);
-            glVertex2f(gx0, gy1);
-            glVertex2f(gx0, gy0);
-            glEnd();
+            gfx.begin(GL_TRIANGLE_FAN);
+            gfx.color(0.3f, 0.8f, 1.0f, alpha);
+            gfx.vertex(cx, cy);
+            gfx.color(0.2f, 0.6f, 1.0f, 0.0f);
+            gfx.vertex(gx0, gy0);
+            gfx.vertex(gx1, gy0);
+            gfx.vertex(gx1, gy1);
+            gfx.vertex(gx0, gy1);
+            gfx.vertex(gx0, gy0);
+            gfx.end();
         };
-        drawBoostGlow(paddle1, boostActive1);
-        drawBoostGlow(paddle2, boostActive2);
+        drawBoostGlow(paddle1, match.boostActive1);
+        drawBoostGlow(paddle2, match.boostActive2);
 
         // Boost particles
-        for (int i = 0; i < boostParticleCount1; ++i) {
-            const BoostParticle& p = boostParticles1[i];
-            float t = p.life / p.maxLife;
-            float alpha = t * 0.8f;
-            float sz = p.size * t;
-            glBegin(GL_QUADS);
-            glColor4f(p.r, p.g, p.b, alpha);
-            glVertex2f(p.x - sz, p.y - sz);
-            glVertex2f(p.x + sz, p.y - sz);
-            glVertex2f(p.x + sz, p.y + sz);
-            glVertex2f(p.x - sz, p.y + sz);
-            glEnd();
-        }
-        for (int i = 0; i < boostParticleCount2; ++i) {
-            const BoostParticle& p = boostParticles2[i];
-            float t = p.life / p.maxLife;
-            float alpha = t * 0.8f;
-            float sz = p.size * t;
-            glBegin(GL_QUADS);
-            glColor4f(p.r, p.g, p.b, alpha);
-            glVertex2f(p.x - sz, p.y - sz);
-            glVertex2f(p.x + sz, p.y - sz);
-            glVertex2f(p.x + sz, p.y + sz);
-            glVertex2f(p.x - sz, p.y + sz);
-            glEnd();
-        }
+        boostParticles1.drawFadingSquares(0.8f);
+        boostParticles2.drawFadingSquares(0.8f);
     }
 
     if (fxEnabled) {
@@ -2220,14 +1927,14 @@ void Game::render() {
         float glowAlpha = 0.45f + 0.25f * rally + 0.4f * scorePulse;
         if (glowAlpha > 0.9f) glowAlpha = 0.9f;
 
-        glBegin(GL_QUADS);
-        glColor4f(accentR * 0.0f, accentG * 0.0f, accentB * 0.0f, 0.0f);
-        glVertex2f(centerX - centerGlowHalf, glowTop);
-        glVertex2f(centerX + centerGlowHalf, glowTop);
-        glColor4f(accentR * 0.7f, accentG * 0.7f, accentB * 0.8f, glowAlpha);
-        glVertex2f(centerX + centerGlowHalf, glowBottom);
-        glVertex2f(centerX - centerGlowHalf, glowBottom);
-        glEnd();
+        gfx.begin(GL_QUADS);
+        gfx.color(accentR * 0.0f, accentG * 0.0f, accentB * 0.0f, 0.0f);
+        gfx.vertex(centerX - centerGlowHalf, glowTop);
+        gfx.vertex(centerX + centerGlowHalf, glowTop);
+        gfx.color(accentR * 0.7f, accentG * 0.7f, accentB * 0.8f, glowAlpha);
+        gfx.vertex(centerX + centerGlowHalf, glowBottom);
+        gfx.vertex(centerX - centerGlowHalf, glowBottom);
+        gfx.end();
 
         if (ball) {
             float vx = ball->velX;
@@ -2270,14 +1977,14 @@ void Game::render() {
                 float headA = 0.5f + 0.25f * boost;
                 if (headA > 0.8f) headA = 0.8f;
 
-                glBegin(GL_QUADS);
-                glColor4f(headR, headG, headB, headA);
-                glVertex2f(ax, ay);
-                glVertex2f(bx, by);
-                glColor4f(tailR, tailG, tailB, 0.0f);
-                glVertex2f(dx, dy);
-                glVertex2f(cx, cy);
-                glEnd();
+                gfx.begin(GL_QUADS);
+                gfx.color(headR, headG, headB, headA);
+                gfx.vertex(ax, ay);
+                gfx.vertex(bx, by);
+                gfx.color(tailR, tailG, tailB, 0.0f);
+                gfx.vertex(dx, dy);
+                gfx.vertex(cx, cy);
+                gfx.end();
             }
         }
 
@@ -2294,21 +2001,19 @@ void Game::render() {
             float ringG = accentG * 1.2f;
             float ringB = accentB * 1.2f;
 
-            glBegin(GL_TRIANGLE_FAN);
-            glColor4f(ringR, ringG, ringB, 0.0f);
-            glVertex2f(cx, cy);
-            int segments = 32;
+            gfx.begin(GL_TRIANGLE_FAN);
+            gfx.color(ringR, ringG, ringB, 0.0f);
+            gfx.vertex(cx, cy);
+            const int segments = 32;
+            const float* ring = unitCircle(segments);
+            gfx.color(ringR, ringG, ringB, alpha);
             for (int i = 0; i <= segments; ++i) {
-                float ang = (float)i / (float)segments * 6.2831853f;
-                float px2 = cx + std::cos(ang) * radius;
-                float py2 = cy + std::sin(ang) * radius;
-                glColor4f(ringR, ringG, ringB, alpha);
-                glVertex2f(px2, py2);
+                gfx.vertex(cx + ring[i * 2] * radius, cy + ring[i * 2 + 1] * radius);
             }
-            glEnd();
+            gfx.end();
 
-            glLineWidth(3.0f);
-            glBegin(GL_LINES);
+            gfx.setLineWidth(3.0f);
+            gfx.begin(GL_LINES);
             int shardCount = 8;
             float shardBase = radius * 0.5f;
             float shardLen = radius * 0.7f;
@@ -2316,18 +2021,18 @@ void Game::render() {
             if (shardAlpha > 1.0f) shardAlpha = 1.0f;
             for (int i = 0; i < shardCount; ++i) {
                 float ang = (float)i / (float)shardCount * 6.2831853f + 0.4f;
-                float dirX = std::cos(ang);
-                float dirY = std::sin(ang);
+                float dirX = fastCos(ang);
+                float dirY = fastSin(ang);
                 float sx = cx + dirX * shardBase;
                 float sy = cy + dirY * shardBase;
                 float ex = cx + dirX * (shardBase + shardLen);
                 float ey = cy + dirY * (shardBase + shardLen);
-                glColor4f(ringR, ringG, ringB, shardAlpha);
-                glVertex2f(sx, sy);
-                glColor4f(ringR, ringG, ringB, 0.0f);
-                glVertex2f(ex, ey);
+                gfx.color(ringR, ringG, ringB, shardAlpha);
+                gfx.vertex(sx, sy);
+                gfx.color(ringR, ringG, ringB, 0.0f);
+                gfx.vertex(ex, ey);
             }
-            glEnd();
+            gfx.end();
         }
     }
 
@@ -2349,14 +2054,14 @@ void Game::render() {
             if (y0 < 0.0f) y0 = 0.0f;
             if (y1 > (float)height) y1 = (float)height;
 
-            glBegin(GL_QUADS);
-            glColor4f(accentR, accentG, accentB, alpha);
-            glVertex2f(x0, y0);
-            glVertex2f(x1, y0);
-            glColor4f(accentR, accentG, accentB, 0.0f);
-            glVertex2f(x1, y1);
-            glVertex2f(x0, y1);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(accentR, accentG, accentB, alpha);
+            gfx.vertex(x0, y0);
+            gfx.vertex(x1, y0);
+            gfx.color(accentR, accentG, accentB, 0.0f);
+            gfx.vertex(x1, y1);
+            gfx.vertex(x0, y1);
+            gfx.end();
         }
 
         if (ball->rightImpactTimer > 0.0f) {
@@ -2374,14 +2079,14 @@ void Game::render() {
             if (y0 < 0.0f) y0 = 0.0f;
             if (y1 > (float)height) y1 = (float)height;
 
-            glBegin(GL_QUADS);
-            glColor4f(accentR, accentG, accentB, alpha);
-            glVertex2f(x0, y0);
-            glVertex2f(x1, y0);
-            glColor4f(accentR, accentG, accentB, 0.0f);
-            glVertex2f(x1, y1);
-            glVertex2f(x0, y1);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(accentR, accentG, accentB, alpha);
+            gfx.vertex(x0, y0);
+            gfx.vertex(x1, y0);
+            gfx.color(accentR, accentG, accentB, 0.0f);
+            gfx.vertex(x1, y1);
+            gfx.vertex(x0, y1);
+            gfx.end();
         }
 
         if (ball->topImpactTimer > 0.0f) {
@@ -2390,14 +2095,14 @@ void Game::render() {
             float alpha = 0.7f * t;
             float h = 18.0f;
 
-            glBegin(GL_QUADS);
-            glColor4f(accentR, accentG, accentB, alpha);
-            glVertex2f(0.0f, 0.0f);
-            glVertex2f((float)width, 0.0f);
-            glColor4f(accentR, accentG, accentB, 0.0f);
-            glVertex2f((float)width, h);
-            glVertex2f(0.0f, h);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(accentR, accentG, accentB, alpha);
+            gfx.vertex(0.0f, 0.0f);
+            gfx.vertex((float)width, 0.0f);
+            gfx.color(accentR, accentG, accentB, 0.0f);
+            gfx.vertex((float)width, h);
+            gfx.vertex(0.0f, h);
+            gfx.end();
         }
 
         if (ball->bottomImpactTimer > 0.0f) {
@@ -2408,29 +2113,31 @@ void Game::render() {
             float y0 = (float)height - h;
             float y1 = (float)height;
 
-            glBegin(GL_QUADS);
-            glColor4f(accentR, accentG, accentB, 0.0f);
-            glVertex2f(0.0f, y0);
-            glVertex2f((float)width, y0);
-            glColor4f(accentR, accentG, accentB, alpha);
-            glVertex2f((float)width, y1);
-            glVertex2f(0.0f, y1);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(accentR, accentG, accentB, 0.0f);
+            gfx.vertex(0.0f, y0);
+            gfx.vertex((float)width, y0);
+            gfx.color(accentR, accentG, accentB, alpha);
+            gfx.vertex((float)width, y1);
+            gfx.vertex(0.0f, y1);
+            gfx.end();
         }
     }
 
     if (paused) {
         float alpha = (currentMenu == MENU_MAIN || currentMenu == MENU_PLAY || currentMenu == MENU_SETTINGS) ? 1.0f : 0.5f;
-        glColor4f(0.0f, 0.0f, 0.0f, alpha);
-        glBegin(GL_QUADS);
-        glVertex2f(0.0f, 0.0f);
-        glVertex2f((float)width, 0.0f);
-        glVertex2f((float)width, (float)height);
-        glVertex2f(0.0f, (float)height);
-        glEnd();
+        gfx.color(0.0f, 0.0f, 0.0f, alpha);
+        gfx.begin(GL_QUADS);
+        gfx.vertex(0.0f, 0.0f);
+        gfx.vertex((float)width, 0.0f);
+        gfx.vertex((float)width, (float)height);
+        gfx.vertex(0.0f, (float)height);
+        gfx.end();
     }
 
-    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    prof.end(PROFILE_WORLD);
+    prof.begin(PROFILE_HUD);
+    gfx.color(1.0f, 1.0f, 1.0f, 1.0f);
 
     // Only draw HUD when not in the opening main menu
     if (currentMenu != MENU_MAIN && currentMenu != MENU_PLAY) {
@@ -2438,14 +2145,14 @@ void Game::render() {
 
         // Control hints
         if (labelTimer < 3.0) {
-            glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+            gfx.color(1.0f, 1.0f, 1.0f, 1.0f);
             drawText(40.0f, topY, 12.0f, "P1: W/S");
             drawText((float)width - 200.0f, topY, 12.0f, "P2: UP/DOWN");
         }
 
         // Scores centered at top, with a brief flash when score changes
         char scoreText[32];
-        std::snprintf(scoreText, sizeof(scoreText), "%d : %d", score1, score2);
+        std::snprintf(scoreText, sizeof(scoreText), "%d : %d", match.score1, match.score2);
 
         float baseScoreScale = 20.0f;
         float scoreScale = baseScoreScale;
@@ -2454,12 +2161,12 @@ void Game::render() {
             float t = (float)(scoreFlashTimer / 0.3f);
             // Slight size bump and warm color
             scoreScale = baseScoreScale + 4.0f * t;
-            glColor4f(1.0f, 1.0f, 0.4f, 1.0f);
+            gfx.color(1.0f, 1.0f, 0.4f, 1.0f);
         } else {
             float sr = accentR * 0.6f + 0.4f;
             float sg = accentG * 0.6f + 0.4f;
             float sb = accentB * 0.6f + 0.4f;
-            glColor4f(sr, sg, sb, 1.0f);
+            gfx.color(sr, sg, sb, 1.0f);
         }
 
         float scoreWidth = measureText(scoreScale, scoreText);
@@ -2497,7 +2204,7 @@ void Game::render() {
         float mr = accentR * 0.8f + 0.2f;
         float mg = accentG * 0.8f + 0.2f;
         float mb = accentB * 0.8f + 0.2f;
-        glColor4f(mr, mg, mb, 1.0f);
+        gfx.color(mr, mg, mb, 1.0f);
         drawText(modeX, modeY, modeScale, modeText);
 
         // Health bars near each paddle (Battle Mode only)
@@ -2511,16 +2218,16 @@ void Game::render() {
             float p1BarY = paddle1->y + paddle1->height * 0.5f - barHeight * 0.5f;
 
             // Background
-            glBegin(GL_QUADS);
-            glColor4f(0.2f, 0.2f, 0.2f, 0.8f);
-            glVertex2f(p1BarX - barPadding, p1BarY - barPadding);
-            glVertex2f(p1BarX + barWidth + barPadding, p1BarY - barPadding);
-            glVertex2f(p1BarX + barWidth + barPadding, p1BarY + barHeight + barPadding);
-            glVertex2f(p1BarX - barPadding, p1BarY + barHeight + barPadding);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(0.2f, 0.2f, 0.2f, 0.8f);
+            gfx.vertex(p1BarX - barPadding, p1BarY - barPadding);
+            gfx.vertex(p1BarX + barWidth + barPadding, p1BarY - barPadding);
+            gfx.vertex(p1BarX + barWidth + barPadding, p1BarY + barHeight + barPadding);
+            gfx.vertex(p1BarX - barPadding, p1BarY + barHeight + barPadding);
+            gfx.end();
 
             // Health fill with color shift (green to yellow to red)
-            float p1Ratio = (float)health1 / (float)maxHealth;
+            float p1Ratio = (float)match.health1 / (float)maxHealth;
             float p1FillWidth = barWidth * p1Ratio;
             float p1Hue = p1Ratio * 0.33f; // 0.33 = green, 0 = red
             float p1r, p1g, p1b;
@@ -2528,50 +2235,50 @@ void Game::render() {
 
             // Animated pulse when low health
             float p1Pulse = 1.0f;
-            if (health1 <= 2) {
-                p1Pulse = 0.7f + 0.3f * std::sin((float)labelTimer * 8.0f);
+            if (match.health1 <= 2) {
+                p1Pulse = oscillate((float)labelTimer, 8.0f, 0.7f, 0.3f);
             }
 
-            glBegin(GL_QUADS);
-            glColor4f(p1r * p1Pulse, p1g * p1Pulse, p1b * p1Pulse, 1.0f);
-            glVertex2f(p1BarX, p1BarY);
-            glVertex2f(p1BarX + p1FillWidth, p1BarY);
-            glVertex2f(p1BarX + p1FillWidth, p1BarY + barHeight);
-            glVertex2f(p1BarX, p1BarY + barHeight);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(p1r * p1Pulse, p1g * p1Pulse, p1b * p1Pulse, 1.0f);
+            gfx.vertex(p1BarX, p1BarY);
+            gfx.vertex(p1BarX + p1FillWidth, p1BarY);
+            gfx.vertex(p1BarX + p1FillWidth, p1BarY + barHeight);
+            gfx.vertex(p1BarX, p1BarY + barHeight);
+            gfx.end();
 
             // P2 health bar (right side)
             float p2BarX = paddle2->x - 15.0f - barWidth;
             float p2BarY = paddle2->y + paddle2->height * 0.5f - barHeight * 0.5f;
 
             // Background
-            glBegin(GL_QUADS);
-            glColor4f(0.2f, 0.2f, 0.2f, 0.8f);
-            glVertex2f(p2BarX - barPadding, p2BarY - barPadding);
-            glVertex2f(p2BarX + barWidth + barPadding, p2BarY - barPadding);
-            glVertex2f(p2BarX + barWidth + barPadding, p2BarY + barHeight + barPadding);
-            glVertex2f(p2BarX - barPadding, p2BarY + barHeight + barPadding);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(0.2f, 0.2f, 0.2f, 0.8f);
+            gfx.vertex(p2BarX - barPadding, p2BarY - barPadding);
+            gfx.vertex(p2BarX + barWidth + barPadding, p2BarY - barPadding);
+            gfx.vertex(p2BarX + barWidth + barPadding, p2BarY + barHeight + barPadding);
+            gfx.vertex(p2BarX - barPadding, p2BarY + barHeight + barPadding);
+            gfx.end();
 
             // Health fill
-            float p2Ratio = (float)health2 / (float)maxHealth;
+            float p2Ratio = (float)match.health2 / (float)maxHealth;
             float p2FillWidth = barWidth * p2Ratio;
             float p2Hue = p2Ratio * 0.33f;
             float p2r, p2g, p2b;
             hsvToRgb(p2Hue, 0.9f, 1.0f, p2r, p2g, p2b);
 
             float p2Pulse = 1.0f;
-            if (health2 <= 2) {
-                p2Pulse = 0.7f + 0.3f * std::sin((float)labelTimer * 8.0f);
+            if (match.health2 <= 2) {
+                p2Pulse = oscillate((float)labelTimer, 8.0f, 0.7f, 0.3f);
             }
 
-            glBegin(GL_QUADS);
-            glColor4f(p2r * p2Pulse, p2g * p2Pulse, p2b * p2Pulse, 1.0f);
-            glVertex2f(p2BarX + barWidth - p2FillWidth, p2BarY);
-            glVertex2f(p2BarX + barWidth, p2BarY);
-            glVertex2f(p2BarX + barWidth, p2BarY + barHeight);
-            glVertex2f(p2BarX + barWidth - p2FillWidth, p2BarY + barHeight);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(p2r * p2Pulse, p2g * p2Pulse, p2b * p2Pulse, 1.0f);
+            gfx.vertex(p2BarX + barWidth - p2FillWidth, p2BarY);
+            gfx.vertex(p2BarX + barWidth, p2BarY);
+            gfx.vertex(p2BarX + barWidth, p2BarY + barHeight);
+            gfx.vertex(p2BarX + barWidth - p2FillWidth, p2BarY + barHeight);
+            gfx.end();
         }
 
         // Boost meters (shown in both Classic and Battle modes)
@@ -2585,45 +2292,45 @@ void Game::render() {
             float b1X = paddle1->x + paddle1->width + 15.0f;
             float b1Y = paddle1->y + paddle1->height * 0.5f + boostYOffset;
 
-            glBegin(GL_QUADS);
-            glColor4f(0.15f, 0.15f, 0.2f, 0.7f);
-            glVertex2f(b1X - 1, b1Y - 1);
-            glVertex2f(b1X + boostBarWidth + 1, b1Y - 1);
-            glVertex2f(b1X + boostBarWidth + 1, b1Y + boostBarHeight + 1);
-            glVertex2f(b1X - 1, b1Y + boostBarHeight + 1);
-            glEnd();
-
-            float b1Fill = boostBarWidth * boostMeter1;
-            float b1Glow = boostActive1 ? (0.8f + 0.2f * std::sin((float)labelTimer * 12.0f)) : 1.0f;
-            glBegin(GL_QUADS);
-            glColor4f(0.2f * b1Glow, 0.6f * b1Glow, 1.0f * b1Glow, 1.0f);
-            glVertex2f(b1X, b1Y);
-            glVertex2f(b1X + b1Fill, b1Y);
-            glVertex2f(b1X + b1Fill, b1Y + boostBarHeight);
-            glVertex2f(b1X, b1Y + boostBarHeight);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(0.15f, 0.15f, 0.2f, 0.7f);
+            gfx.vertex(b1X - 1, b1Y - 1);
+            gfx.vertex(b1X + boostBarWidth + 1, b1Y - 1);
+            gfx.vertex(b1X + boostBarWidth + 1, b1Y + boostBarHeight + 1);
+            gfx.vertex(b1X - 1, b1Y + boostBarHeight + 1);
+            gfx.end();
+
+            float b1Fill = boostBarWidth * match.boostMeter1;
+            float b1Glow = match.boostActive1 ? (oscillate((float)labelTimer, 12.0f, 0.8f, 0.2f)) : 1.0f;
+            gfx.begin(GL_QUADS);
+            gfx.color(0.2f * b1Glow, 0.6f * b1Glow, 1.0f * b1Glow, 1.0f);
+            gfx.vertex(b1X, b1Y);
+            gfx.vertex(b1X + b1Fill, b1Y);
+            gfx.vertex(b1X + b1Fill, b1Y + boostBarHeight);
+            gfx.vertex(b1X, b1Y + boostBarHeight);
+            gfx.end();
 
             // P2 boost bar
             float b2X = paddle2->x - 15.0f - boostBarWidth;
             float b2Y = paddle2->y + paddle2->height * 0.5f + boostYOffset;
 
-            glBegin(GL_QUADS);
-            glColor4f(0.15f, 0.15f, 0.2f, 0.7f);
-            glVertex2f(b2X - 1, b2Y - 1);
-            glVertex2f(b2X + boostBarWidth + 1, b2Y - 1);
-            glVertex2f(b2X + boostBarWidth + 1, b2Y + boostBarHeight + 1);
-            glVertex2f(b2X - 1, b2Y + boostBarHeight + 1);
-            glEnd();
-
-            float b2Fill = boostBarWidth * boostMeter2;
-            float b2Glow = boostActive2 ? (0.8f + 0.2f * std::sin((float)labelTimer * 12.0f)) : 1.0f;
-            glBegin(GL_QUADS);
-            glColor4f(0.2f * b2Glow, 0.6f * b2Glow, 1.0f * b2Glow, 1.0f);
-            glVertex2f(b2X + boostBarWidth - b2Fill, b2Y);
-            glVertex2f(b2X + boostBarWidth, b2Y);
-            glVertex2f(b2X + boostBarWidth, b2Y + boostBarHeight);
-            glVertex2f(b2X + boostBarWidth - b2Fill, b2Y + boostBarHeight);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(0.15f, 0.15f, 0.2f, 0.7f);
+            gfx.vertex(b2X - 1, b2Y - 1);
+            gfx.vertex(b2X + boostBarWidth + 1, b2Y - 1);
+            gfx.vertex(b2X + boostBarWidth + 1, b2Y + boostBarHeight + 1);
+            gfx.vertex(b2X - 1, b2Y + boostBarHeight + 1);
+            gfx.end();
+
+            float b2Fill = boostBarWidth * match.boostMeter2;
+            float b2Glow = match.boostActive2 ? (oscillate((float)labelTimer, 12.0f, 0.8f, 0.2f)) : 1.0f;
+            gfx.begin(GL_QUADS);
+            gfx.color(0.2f * b2Glow, 0.6f * b2Glow, 1.0f * b2Glow, 1.0f);
+            gfx.vertex(b2X + boostBarWidth - b2Fill, b2Y);
+            gfx.vertex(b2X + boostBarWidth, b2Y);
+            gfx.vertex(b2X + boostBarWidth, b2Y + boostBarHeight);
+            gfx.vertex(b2X + boostBarWidth - b2Fill, b2Y + boostBarHeight);
+            gfx.end();
         }
 
         // Shield visual effects (Battle Mode only)
@@ -2635,8 +2342,8 @@ void Game::render() {
                 auto drawPickup = [&](const ShieldPickup& pickup) {
                     if (!pickup.active) return;
                     float cx = pickup.x;
-                    float cy = pickup.y + std::sin(pickup.bobTimer * 3.0f) * 5.0f;
-                    float pulse = 0.7f + 0.3f * std::sin(pickup.bobTimer * 4.0f);
+                    float cy = pickup.y + fastSin(pickup.bobTimer * 3.0f) * 5.0f;
+                    float pulse = oscillate(pickup.bobTimer, 4.0f, 0.7f, 0.3f);
                     float sz = pickupSize * 0.5f;
 
                     // Shield shape: chevron/pentagon pointing up
@@ -2650,58 +2357,59 @@ void Game::render() {
                     };
 
                     // Blinking aura ring (~2Hz, alpha oscillates between visible and near-invisible)
-                    float blinkAlpha = 0.5f + 0.5f * std::sin(pickup.bobTimer * 12.56637f); // 2Hz = 4π rad/s
+                    float blinkAlpha = oscillate(pickup.bobTimer, 12.56637f, 0.5f, 0.5f); // 2Hz = 4π rad/s
                     float auraR = 18.0f + 2.0f * pulse; // larger than glow
-                    glBegin(GL_LINE_LOOP);
-                    glColor4f(0.5f, 1.0f, 0.7f, 0.6f * blinkAlpha);
-                    int auraSegs = 24;
+                    gfx.setLineWidth(2.0f);
+                    gfx.begin(GL_LINE_LOOP);
+                    gfx.color(0.5f, 1.0f, 0.7f, 0.6f * blinkAlpha);
+                    const int auraSegs = 24;
+                    const float* aura = unitCircle(auraSegs);
                     for (int i = 0; i < auraSegs; ++i) {
-                        float ang = (float)i / (float)auraSegs * 6.2831853f;
-                        glVertex2f(cx + std::cos(ang) * (sz + auraR), cy + std::sin(ang) * (sz + auraR));
+                        gfx.vertex(cx + aura[i * 2] * (sz + auraR), cy + aura[i * 2 + 1] * (sz + auraR));
                     }
-                    glEnd();
+                    gfx.end();
 
                     // Outer glow
                     float glowR = 12.0f;
-                    glBegin(GL_TRIANGLE_FAN);
-                    glColor4f(0.3f, 0.9f, 0.5f, 0.25f * pulse);
-                    glVertex2f(cx, cy);
-                    glColor4f(0.2f, 0.8f, 0.4f, 0.0f);
-                    int glowSegs = 20;
+                    gfx.begin(GL_TRIANGLE_FAN);
+                    gfx.color(0.3f, 0.9f, 0.5f, 0.25f * pulse);
+                    gfx.vertex(cx, cy);
+                    gfx.color(0.2f, 0.8f, 0.4f, 0.0f);
+                    const int glowSegs = 20;
+                    const float* glow = unitCircle(glowSegs);
                     for (int i = 0; i <= glowSegs; ++i) {
-                        float ang = (float)i / (float)glowSegs * 6.2831853f;
-                        glVertex2f(cx + std::cos(ang) * (sz + glowR), cy + std::sin(ang) * (sz + glowR));
+                        gfx.vertex(cx + glow[i * 2] * (sz + glowR), cy + glow[i * 2 + 1] * (sz + glowR));
                     }
-                    glEnd();
+                    gfx.end();
 
                     // Filled shield shape
-                    glBegin(GL_TRIANGLE_FAN);
-                    glColor4f(0.3f, 1.0f, 0.6f, 0.8f * pulse);
-                    glVertex2f(cx, cy);
+                    gfx.begin(GL_TRIANGLE_FAN);
+                    gfx.color(0.3f, 1.0f, 0.6f, 0.8f * pulse);
+                    gfx.vertex(cx, cy);
                     for (int i = 0; i <= 4; ++i) {
                         int idx = i % 5;
-                        glColor4f(0.2f, 0.85f, 0.5f, 0.7f * pulse);
-                        glVertex2f(pts[idx][0], pts[idx][1]);
+                        gfx.color(0.2f, 0.85f, 0.5f, 0.7f * pulse);
+                        gfx.vertex(pts[idx][0], pts[idx][1]);
                     }
-                    glEnd();
+                    gfx.end();
 
                     // Outline
-                    glLineWidth(2.0f);
-                    glBegin(GL_LINE_LOOP);
-                    glColor4f(0.5f, 1.0f, 0.8f, 0.9f * pulse);
+                    gfx.setLineWidth(2.0f);
+                    gfx.begin(GL_LINE_LOOP);
+                    gfx.color(0.5f, 1.0f, 0.8f, 0.9f * pulse);
                     for (int i = 0; i < 5; ++i) {
-                        glVertex2f(pts[i][0], pts[i][1]);
+                        gfx.vertex(pts[i][0], pts[i][1]);
                     }
-                    glEnd();
+                    gfx.end();
                 };
-                drawPickup(shieldPickup1);
-                drawPickup(shieldPickup2);
+                drawPickup(match.shieldPickup1);
+                drawPickup(match.shieldPickup2);
             }
 
             // Shield indicator on paddle when holding a shield (both modes)
             auto drawShieldIndicator = [&](Paddle* pad, bool held) {
                 if (!pad || !held) return;
-                float pulse = 0.6f + 0.4f * std::sin((float)labelTimer * 6.0f);
+                float pulse = oscillate((float)labelTimer, 6.0f, 0.6f, 0.4f);
                 float alpha = 0.7f * pulse; // increased from 0.4f
                 bool isLeft = (pad->upKey == SDL_SCANCODE_W);
                 float bx = isLeft ? (pad->x + pad->width + 3.0f) : (pad->x - 9.0f); // widened positioning
@@ -2709,32 +2417,32 @@ void Game::render() {
                 float by1 = pad->y + pad->height + 6.0f;
                 float bw = 6.0f; // widened from 4.0f
                 // Barrier quad on paddle face - brighter colors
-                glBegin(GL_QUADS);
-                glColor4f(0.5f, 1.0f, 0.7f, alpha); // brighter green
-                glVertex2f(bx, by0);
-                glVertex2f(bx + bw, by0);
-                glColor4f(0.3f, 0.95f, 1.0f, alpha * 0.8f); // brighter cyan
-                glVertex2f(bx + bw, by1);
-                glVertex2f(bx, by1);
-                glEnd();
+                gfx.begin(GL_QUADS);
+                gfx.color(0.5f, 1.0f, 0.7f, alpha); // brighter green
+                gfx.vertex(bx, by0);
+                gfx.vertex(bx + bw, by0);
+                gfx.color(0.3f, 0.95f, 1.0f, alpha * 0.8f); // brighter cyan
+                gfx.vertex(bx + bw, by1);
+                gfx.vertex(bx, by1);
+                gfx.end();
                 // Outer glow - expanded from 8px to 14px
                 float glowW = 14.0f;
-                glBegin(GL_QUADS);
-                glColor4f(0.4f, 0.95f, 0.8f, alpha * 0.4f); // brighter glow
-                glVertex2f(bx, by0);
-                glVertex2f(bx + bw, by0);
-                glColor4f(0.3f, 0.85f, 1.0f, 0.0f);
+                gfx.begin(GL_QUADS);
+                gfx.color(0.4f, 0.95f, 0.8f, alpha * 0.4f); // brighter glow
+                gfx.vertex(bx, by0);
+                gfx.vertex(bx + bw, by0);
+                gfx.color(0.3f, 0.85f, 1.0f, 0.0f);
                 if (isLeft) {
-                    glVertex2f(bx + bw + glowW, by1);
-                    glVertex2f(bx + bw + glowW, by0);
+                    gfx.vertex(bx + bw + glowW, by1);
+                    gfx.vertex(bx + bw + glowW, by0);
                 } else {
-                    glVertex2f(bx - glowW, by1);
-                    glVertex2f(bx - glowW, by0);
+                    gfx.vertex(bx - glowW, by1);
+                    gfx.vertex(bx - glowW, by0);
                 }
-                glEnd();
+                gfx.end();
             };
-            drawShieldIndicator(paddle1, shieldHeld1);
-            drawShieldIndicator(paddle2, shieldHeld2);
+            drawShieldIndicator(paddle1, match.shieldHeld1);
+            drawShieldIndicator(paddle2, match.shieldHeld2);
 
             // Fixed movement mode: cooldown bar below boost bar
             if (!freeMovement) {
@@ -2754,13 +2462,13 @@ void Game::render() {
                     sy = pad->y + pad->height * 0.5f + shieldYOff;
 
                     // Background
-                    glBegin(GL_QUADS);
-                    glColor4f(0.1f, 0.15f, 0.1f, 0.6f);
-                    glVertex2f(sx - 1, sy - 1);
-                    glVertex2f(sx + shieldBarW + 1, sy - 1);
-                    glVertex2f(sx + shieldBarW + 1, sy + shieldBarH + 1);
-                    glVertex2f(sx - 1, sy + shieldBarH + 1);
-                    glEnd();
+                    gfx.begin(GL_QUADS);
+                    gfx.color(0.1f, 0.15f, 0.1f, 0.6f);
+                    gfx.vertex(sx - 1, sy - 1);
+                    gfx.vertex(sx + shieldBarW + 1, sy - 1);
+                    gfx.vertex(sx + shieldBarW + 1, sy + shieldBarH + 1);
+                    gfx.vertex(sx - 1, sy + shieldBarH + 1);
+                    gfx.end();
 
                     float fill = 1.0f;
                     float r = 0.3f, g = 0.9f, b = 0.5f;
@@ -2775,25 +2483,25 @@ void Game::render() {
                     }
                     float fillW = shieldBarW * fill;
                     if (isLeft) {
-                        glBegin(GL_QUADS);
-                        glColor4f(r, g, b, 0.9f);
-                        glVertex2f(sx, sy);
-                        glVertex2f(sx + fillW, sy);
-                        glVertex2f(sx + fillW, sy + shieldBarH);
-                        glVertex2f(sx, sy + shieldBarH);
-                        glEnd();
+                        gfx.begin(GL_QUADS);
+                        gfx.color(r, g, b, 0.9f);
+                        gfx.vertex(sx, sy);
+                        gfx.vertex(sx + fillW, sy);
+                        gfx.vertex(sx + fillW, sy + shieldBarH);
+                        gfx.vertex(sx, sy + shieldBarH);
+                        gfx.end();
                     } else {
-                        glBegin(GL_QUADS);
-                        glColor4f(r, g, b, 0.9f);
-                        glVertex2f(sx + shieldBarW - fillW, sy);
-                        glVertex2f(sx + shieldBarW, sy);
-                        glVertex2f(sx + shieldBarW, sy + shieldBarH);
-                        glVertex2f(sx + shieldBarW - fillW, sy + shieldBarH);
-                        glEnd();
+                        gfx.begin(GL_QUADS);
+                        gfx.color(r, g, b, 0.9f);
+                        gfx.vertex(sx + shieldBarW - fillW, sy);
+                        gfx.vertex(sx + shieldBarW, sy);
+                        gfx.vertex(sx + shieldBarW, sy + shieldBarH);
+                        gfx.vertex(sx + shieldBarW - fillW, sy + shieldBarH);
+                        gfx.end();
                     }
                 };
-                drawShieldCooldown(paddle1, shieldCooldown1, shieldHeld1);
-                drawShieldCooldown(paddle2, shieldCooldown2, shieldHeld2);
+                drawShieldCooldown(paddle1, match.shieldCooldown1, match.shieldHeld1);
+                drawShieldCooldown(paddle2, match.shieldCooldown2, match.shieldHeld2);
             }
         }
 
@@ -2808,12 +2516,14 @@ void Game::render() {
             float p1X = paddle1->x + paddle1->width * 0.5f - p1Width * 0.5f;
             float p2X = paddle2->x + paddle2->width * 0.5f - p2Width * 0.5f;
 
-            glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+            gfx.color(1.0f, 1.0f, 1.0f, 1.0f);
             drawText(p1X, paddle1->y - labelYOffset, labelScale, "P1");
             drawText(p2X, paddle2->y - labelYOffset, labelScale, "P2");
         }
     }
+    prof.end(PROFILE_HUD);
 
+    prof.begin(PROFILE_MENU);
     if (paused) {
         if (inColorMenu) {
             const char* headerText = (colorMenuPlayer == 0) ? "P1 COLOR" : "P2 COLOR";
@@ -2840,9 +2550,9 @@ void Game::render() {
                 float iy = startY + i * (menuScale * 1.4f);
 
                 if (i == colorSelection) {
-                    glColor4f(1.0f, 1.0f, 0.3f, 1.0f);
+                    gfx.color(1.0f, 1.0f, 0.3f, 1.0f);
                 } else {
-                    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+                    gfx.color(1.0f, 1.0f, 1.0f, 1.0f);
                 }
 
                 drawText(ix, iy, menuScale, items[i]);
@@ -2896,9 +2606,10 @@ void Game::render() {
                 std::snprintf(dynamicLabels[9], sizeof(dynamicLabels[9]), "VOLUME: %d%%", volumePercent);
                 std::snprintf(dynamicLabels[10], sizeof(dynamicLabels[10]), "P1 INPUT: %s", p1UseMouse ? "MOUSE" : "KEYBOARD");
                 std::snprintf(dynamicLabels[11], sizeof(dynamicLabels[11]), "P2 INPUT: %s", p2UseMouse ? "MOUSE" : "KEYBOARD");
-                for (int i = 0; i < 12; ++i) menuItems[i] = dynamicLabels[i];
-                menuItems[12] = "BACK";
-                itemCount = 13;
+                std::snprintf(dynamicLabels[12], sizeof(dynamicLabels[12]), "BALLS: %d", BallCountOptions[ballCountIndex]);
+                for (int i = 0; i < 13; ++i) menuItems[i] = dynamicLabels[i];
+                menuItems[13] = "BACK";
+                itemCount = 14;
             }
 
             // Header
@@ -2908,27 +2619,27 @@ void Game::render() {
             float hy = (float)height * 0.25f;
 
             // Header shadow
-            glColor4f(0.0f, 0.0f, 0.0f, 0.6f);
+            gfx.color(0.0f, 0.0f, 0.0f, 0.6f);
             drawText(hx + 2.0f, hy + 2.0f, headerScale, headerText);
 
             // Header color - accent for title, white for submenus
             if (currentMenu == MENU_MAIN) {
-                glColor4f(0.3f, 0.7f, 1.0f, 1.0f);
+                gfx.color(0.3f, 0.7f, 1.0f, 1.0f);
             } else {
-                glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+                gfx.color(1.0f, 1.0f, 1.0f, 1.0f);
             }
             drawText(hx, hy, headerScale, headerText);
 
             // Separator line under header
             float sepY = hy + headerScale * 1.3f;
             float sepW = 200.0f;
-            glBegin(GL_QUADS);
-            glColor4f(0.3f, 0.5f, 0.8f, 0.6f);
-            glVertex2f((float)width * 0.5f - sepW * 0.5f, sepY);
-            glVertex2f((float)width * 0.5f + sepW * 0.5f, sepY);
-            glVertex2f((float)width * 0.5f + sepW * 0.5f, sepY + 2.0f);
-            glVertex2f((float)width * 0.5f - sepW * 0.5f, sepY + 2.0f);
-            glEnd();
+            gfx.begin(GL_QUADS);
+            gfx.color(0.3f, 0.5f, 0.8f, 0.6f);
+            gfx.vertex((float)width * 0.5f - sepW * 0.5f, sepY);
+            gfx.vertex((float)width * 0.5f + sepW * 0.5f, sepY);
+            gfx.vertex((float)width * 0.5f + sepW * 0.5f, sepY + 2.0f);
+            gfx.vertex((float)width * 0.5f - sepW * 0.5f, sepY + 2.0f);
+            gfx.end();
 
             // Menu items with visual hierarchy
             float menuScale = 18.0f;
@@ -2948,38 +2659,38 @@ void Game::render() {
 
                 if (isSelected) {
                     // Selection glow background
-                    float glowPulse = 0.6f + 0.4f * std::sin((float)menuAnimTimer * 5.0f);
+                    float glowPulse = oscillate((float)menuAnimTimer, 5.0f, 0.6f, 0.4f);
                     float bgPad = 8.0f;
-                    glBegin(GL_QUADS);
-                    glColor4f(0.2f, 0.4f, 0.8f, 0.25f * glowPulse);
-                    glVertex2f(ix - bgPad, iy - 2.0f);
-                    glVertex2f(ix + w + bgPad, iy - 2.0f);
-                    glVertex2f(ix + w + bgPad, iy + menuScale + 2.0f);
-                    glVertex2f(ix - bgPad, iy + menuScale + 2.0f);
-                    glEnd();
+                    gfx.begin(GL_QUADS);
+                    gfx.color(0.2f, 0.4f, 0.8f, 0.25f * glowPulse);
+                    gfx.vertex(ix - bgPad, iy - 2.0f);
+                    gfx.vertex(ix + w + bgPad, iy - 2.0f);
+                    gfx.vertex(ix + w + bgPad, iy + menuScale + 2.0f);
+                    gfx.vertex(ix - bgPad, iy + menuScale + 2.0f);
+                    gfx.end();
 
                     // Selection indicator brackets
                     float bracketOffset = 12.0f;
-                    glColor4f(0.3f, 0.7f, 1.0f, 1.0f);
+                    gfx.color(0.3f, 0.7f, 1.0f, 1.0f);
                     drawText(ix - bracketOffset - measureText(menuScale, ">"), iy, menuScale, ">");
                     drawText(ix + w + bracketOffset, iy, menuScale, "<");
 
                     // Highlighted text color
                     if (isQuit) {
-                        glColor4f(1.0f, 0.5f, 0.5f, 1.0f);
+                        gfx.color(1.0f, 0.5f, 0.5f, 1.0f);
                     } else {
-                        glColor4f(1.0f, 1.0f, 0.3f, 1.0f);
+                        gfx.color(1.0f, 1.0f, 0.3f, 1.0f);
                     }
                 } else {
                     if (isBack) {
-                        glColor4f(0.6f, 0.6f, 0.7f, 1.0f);
+                        gfx.color(0.6f, 0.6f, 0.7f, 1.0f);
                     } else if (isQuit) {
-                        glColor4f(0.7f, 0.4f, 0.4f, 1.0f);
+                        gfx.color(0.7f, 0.4f, 0.4f, 1.0f);
                     } else if (currentMenu == MENU_MAIN && i == 0) {
                         // PLAY is visually prominent
-                        glColor4f(0.9f, 0.9f, 1.0f, 1.0f);
+                        gfx.color(0.9f, 0.9f, 1.0f, 1.0f);
                     } else {
-                        glColor4f(0.8f, 0.8f, 0.85f, 1.0f);
+                        gfx.color(0.8f, 0.8f, 0.85f, 1.0f);
                     }
                 }
 
@@ -2992,7 +2703,7 @@ void Game::render() {
             float hintW = measureText(hintScale, hint);
             float hintX = (float)width * 0.5f - hintW * 0.5f;
             float hintY = (float)height - 40.0f;
-            glColor4f(0.5f, 0.5f, 0.6f, 0.7f);
+            gfx.color(0.5f, 0.5f, 0.6f, 0.7f);
             drawText(hintX, hintY, hintScale, hint);
         } else {
             if (inWinLoseScreen && gameOver) {
@@ -3001,29 +2712,29 @@ void Game::render() {
 
                 // Background tint for win/lose
                 if (fxEnabled) {
-                    glBegin(GL_QUADS);
+                    gfx.begin(GL_QUADS);
                     if (lastAiWin) {
-                        glColor4f(0.05f, 0.0f, 0.10f, 0.85f);
-                        glVertex2f(0.0f, 0.0f);
-                        glVertex2f((float)width, 0.0f);
-                        glColor4f(0.2f, 0.0f, 0.0f, 0.95f);
-                        glVertex2f((float)width, (float)height);
-                        glVertex2f(0.0f, (float)height);
+                        gfx.color(0.05f, 0.0f, 0.10f, 0.85f);
+                        gfx.vertex(0.0f, 0.0f);
+                        gfx.vertex((float)width, 0.0f);
+                        gfx.color(0.2f, 0.0f, 0.0f, 0.95f);
+                        gfx.vertex((float)width, (float)height);
+                        gfx.vertex(0.0f, (float)height);
                     } else {
-                        glColor4f(accentR * 0.25f, accentG * 0.25f, accentB * 0.35f, 0.6f);
-                        glVertex2f(0.0f, 0.0f);
-                        glVertex2f((float)width, 0.0f);
-                        glColor4f(accentR * 0.05f, accentG * 0.05f, accentB * 0.1f, 0.9f);
-                        glVertex2f((float)width, (float)height);
-                        glVertex2f(0.0f, (float)height);
+                        gfx.color(accentR * 0.25f, accentG * 0.25f, accentB * 0.35f, 0.6f);
+                        gfx.vertex(0.0f, 0.0f);
+                        gfx.vertex((float)width, 0.0f);
+                        gfx.color(accentR * 0.05f, accentG * 0.05f, accentB * 0.1f, 0.9f);
+                        gfx.vertex((float)width, (float)height);
+                        gfx.vertex(0.0f, (float)height);
                     }
-                    glEnd();
+                    gfx.end();
                 }
 
                 // Radial glow backdrop (rendered before animations)
                 if (fxEnabled) {
                     float t = (float)winLoseTimer;
-                    float pulse = 0.7f + 0.3f * std::sin(t * 3.5f);
+                    float pulse = oscillate(t, 3.5f, 0.7f, 0.3f);
                     float radius = (float)width * 0.25f + pulse * 30.0f;
                     float alpha = 0.4f;
 
@@ -3031,85 +2742,27 @@ void Game::render() {
                     float glowG = accentG * (lastAiWin ? 0.3f : 1.4f);
                     float glowB = accentB * (lastAiWin ? 0.5f : 1.4f);
 
-                    glBegin(GL_TRIANGLE_FAN);
-                    glColor4f(glowR, glowG, glowB, alpha);
-                    glVertex2f(centerX, centerY);
-                    int segments = 40;
+                    gfx.begin(GL_TRIANGLE_FAN);
+                    gfx.color(glowR, glowG, glowB, alpha);
+                    gfx.vertex(centerX, centerY);
+                    const int segments = 40;
+                    const float* ring = unitCircle(segments);
+                    gfx.color(glowR, glowG, glowB, 0.0f);
                     for (int i = 0; i <= segments; ++i) {
-                        float ang = (float)i / (float)segments * 6.2831853f;
-                        float px2 = centerX + std::cos(ang) * radius;
-                        float py2 = centerY + std::sin(ang) * radius;
-                        glColor4f(glowR, glowG, glowB, 0.0f);
-                        glVertex2f(px2, py2);
+                        gfx.vertex(centerX + ring[i * 2] * radius, centerY + ring[i * 2 + 1] * radius);
                     }
-                    glEnd();
+                    gfx.end();
                 }
 
                 if (lastAiWin && loseShatterActive) {
-                    for (int i = 0; i < loseShardCount; ++i) {
-                        const LoseShard& s = loseShards[i];
-                        if (!s.active) continue;
-                        float tLife = (s.maxLife > 0.0f) ? (s.life / s.maxLife) : 1.0f;
-                        float alpha = 1.0f - tLife;
-                        if (alpha <= 0.0f) continue;
-                        alpha *= alpha;
-
-                        float half = s.size * 0.5f;
-                        float cs = std::cos(s.angle);
-                        float sn = std::sin(s.angle);
-
-                        float x0 = -half;
-                        float y0 = -half;
-                        float x1 = half;
-                        float y1 = half;
-
-                        float vx0 = s.x + x0 * cs - y0 * sn;
-                        float vy0 = s.y + x0 * sn + y0 * cs;
-                        float vx1 = s.x + x1 * cs - y0 * sn;
-                        float vy1 = s.y + x1 * sn + y0 * cs;
-                        float vx2 = s.x + x1 * cs - y1 * sn;
-                        float vy2 = s.y + x1 * sn + y1 * cs;
-                        float vx3 = s.x + x0 * cs - y1 * sn;
-                        float vy3 = s.y + x0 * sn + y1 * cs;
-
-                        glBegin(GL_TRIANGLE_FAN);
-                        glColor4f(s.r, s.g, s.b, alpha);
-                        glVertex2f(vx0, vy0);
-                        glVertex2f(vx1, vy1);
-                        glVertex2f(vx2, vy2);
-                        glVertex2f(vx3, vy3);
-                        glEnd();
-                    }
-
-                    for (int i = 0; i < loseWispCount; ++i) {
-                        const LoseWisp& w = loseWisps[i];
-                        if (!w.active) continue;
-                        float tLife = (w.maxLife > 0.0f) ? (w.life / w.maxLife) : 1.0f;
-                        float alpha = (1.0f - tLife) * 0.7f;
-                        if (alpha <= 0.0f) continue;
-
-                        float width2 = 4.0f;
-                        float height2 = 32.0f;
-                        float x0 = w.x - width2 * 0.5f;
-                        float x1 = w.x + width2 * 0.5f;
-                        float y0 = w.y - height2;
-                        float y1 = w.y;
-
-                        glBegin(GL_QUADS);
-                        glColor4f(w.r, w.g, w.b, 0.0f);
-                        glVertex2f(x0, y1);
-                        glVertex2f(x1, y1);
-                        glColor4f(w.r, w.g, w.b, alpha);
-                        glVertex2f(x1, y0);
-                        glVertex2f(x0, y0);
-                        glEnd();
-                    }
+                    loseShards.drawSpinningShards();
+                    loseWisps.drawRisingStreaks(4.0f, 32.0f, 0.7f);
                 }
 
                 // Determine title text
                 const char* title = "GAME OVER";
                 const char* subtitle = nullptr;
-                if (koWin) {
+                if (match.koWin) {
                     title = "K.O.!";
                     if (singlePlayer) {
                         subtitle = lastAiWin ? "YOU LOSE" : "YOU WIN";
@@ -3130,65 +2783,68 @@ void Game::render() {
                     }
                 }
 
-                float baseScale = koWin ? 40.0f : (lastAiWin ? 26.0f : 30.0f);
-                float pulse = 1.0f + (koWin ? 0.15f : 0.08f) * std::sin((float)winLoseTimer * (koWin ? 6.0f : 4.0f));
+                float baseScale = match.koWin ? 40.0f : (lastAiWin ? 26.0f : 30.0f);
+                float pulse = oscillate((float)winLoseTimer, match.koWin ? 6.0f : 4.0f, 1.0f, match.koWin ? 0.15f : 0.08f);
                 float titleScale = baseScale * pulse;
 
                 float titleWidth = measureText(titleScale, title);
                 float tx = centerX - titleWidth * 0.5f;
-                float ty = centerY - titleScale * (koWin ? 1.8f : 1.2f);
+                float ty = centerY - titleScale * (match.koWin ? 1.8f : 1.2f);
 
                 // Drop shadow for pseudo-3D depth
-                float shadowOffset = koWin ? 4.0f : 3.0f;
-                glColor4f(0.0f, 0.0f, 0.0f, 0.8f);
+                float shadowOffset = match.koWin ? 4.0f : 3.0f;
+                gfx.color(0.0f, 0.0f, 0.0f, 0.8f);
                 drawText(tx + shadowOffset, ty + shadowOffset, titleScale, title);
 
                 // Main title color - KO is dramatic red/orange
-                if (koWin) {
-                    float koFlash = 0.7f + 0.3f * std::sin((float)winLoseTimer * 10.0f);
-                    glColor4f(1.0f * koFlash, 0.3f * koFlash, 0.1f, 1.0f);
+                if (match.koWin) {
+                    float koFlash = oscillate((float)winLoseTimer, 10.0f, 0.7f, 0.3f);
+                    gfx.color(1.0f * koFlash, 0.3f * koFlash, 0.1f, 1.0f);
                 } else if (lastAiWin) {
-                    glColor4f(accentR * 1.4f, accentG * 0.3f, accentB * 0.4f, 1.0f);
+                    gfx.color(accentR * 1.4f, accentG * 0.3f, accentB * 0.4f, 1.0f);
                 } else {
-                    glColor4f(accentR * 1.4f, accentG * 1.4f, accentB * 1.4f, 1.0f);
+                    gfx.color(accentR * 1.4f, accentG * 1.4f, accentB * 1.4f, 1.0f);
                 }
                 drawText(tx, ty, titleScale, title);
 
                 // KO subtitle (winner info)
-                if (koWin && subtitle) {
+                if (match.koWin && subtitle) {
                     float subScale = 20.0f;
                     float subWidth = measureText(subScale, subtitle);
                     float subX = centerX - subWidth * 0.5f;
                     float subY = ty + titleScale * 0.9f;
-                    glColor4f(0.0f, 0.0f, 0.0f, 0.7f);
+                    gfx.color(0.0f, 0.0f, 0.0f, 0.7f);
                     drawText(subX + 2.0f, subY + 2.0f, subScale, subtitle);
                     if (lastAiWin) {
-                        glColor4f(0.9f, 0.4f, 0.4f, 1.0f);
+                        gfx.color(0.9f, 0.4f, 0.4f, 1.0f);
                     } else {
-                        glColor4f(0.4f, 1.0f, 0.5f, 1.0f);
+                        gfx.color(0.4f, 1.0f, 0.5f, 1.0f);
                     }
                     drawText(subX, subY, subScale, subtitle);
                 }
 
                 // Final score under title
                 char scoreText[32];
-                std::snprintf(scoreText, sizeof(scoreText), "%d : %d", score1, score2);
+                std::snprintf(scoreText, sizeof(scoreText), "%d : %d", match.score1, match.score2);
                 float scoreScale = 18.0f;
                 float scoreWidth = measureText(scoreScale, scoreText);
                 float sx = centerX - scoreWidth * 0.5f;
                 float sy = ty + titleScale * 1.1f;
-                glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+                gfx.color(1.0f, 1.0f, 1.0f, 1.0f);
                 drawText(sx, sy, scoreScale, scoreText);
 
                 if (!lastAiWin && winDanceActive && orbitBallCount > 0) {
                     float centerScoreX = centerX;
                     float centerScoreY = sy + scoreScale * 0.3f;
 
+                    // Each ball is a comet trail plus a glow, two instanced draws in total
+                    RenderInstance trails[MaxOrbitBalls];
+                    RenderInstance glows[MaxOrbitBalls];
                     for (int i = 0; i < orbitBallCount; ++i) {
                         const OrbitBall& ob = orbitBalls[i];
                         float angle = ob.angle + ob.speed * (float)winLoseTimer;
-                        float ca = std::cos(angle);
-                        float sa = std::sin(angle);
+                        float ca = fastCos(angle);
+                        float sa = fastSin(angle);
 
                         float radius = ob.radius;
                         float bx = centerScoreX + ca * radius;
@@ -3198,50 +2854,28 @@ void Game::render() {
                         float size = ob.size * depth;
                         float alpha = 0.5f + 0.5f * depth;
 
-                        float tailLen = size * 3.0f;
+                        // Trail runs back along the (flattened) orbit tangent
                         float txDirX = -sa;
                         float txDirY = ca * 0.6f;
-
-                        float hx = bx;
-                        float hy = by;
-                        float tx2 = hx - txDirX * tailLen;
-                        float ty2 = hy - txDirY * tailLen;
-
-                        float px2 = -txDirY;
-                        float py2 = txDirX;
-                        float halfW = size * 0.4f;
-
-                        float ax = hx + px2 * halfW;
-                        float ay = hy + py2 * halfW;
-                        float bx2 = hx - px2 * halfW;
-                        float by2 = hy - py2 * halfW;
-                        float cx2 = tx2 - px2 * halfW * 0.4f;
-                        float cy2 = ty2 - py2 * halfW * 0.4f;
-                        float dx2 = tx2 + px2 * halfW * 0.4f;
-                        float dy2 = ty2 + py2 * halfW * 0.4f;
-
-                        glBegin(GL_QUADS);
-                        glColor4f(ob.r, ob.g, ob.b, alpha);
-                        glVertex2f(ax, ay);
-                        glVertex2f(bx2, by2);
-                        glColor4f(ob.r, ob.g, ob.b, 0.0f);
-                        glVertex2f(cx2, cy2);
-                        glVertex2f(dx2, dy2);
-                        glEnd();
-
-                        glBegin(GL_TRIANGLE_FAN);
-                        glColor4f(ob.r, ob.g, ob.b, alpha);
-                        glVertex2f(bx, by);
-                        int segments = 12;
-                        for (int k = 0; k <= segments; ++k) {
-                            float ang = (float)k / (float)segments * 6.2831853f;
-                            float rx = bx + std::cos(ang) * size;
-                            float ry = by + std::sin(ang) * size;
-                            glColor4f(ob.r, ob.g, ob.b, 0.0f);
-                            glVertex2f(rx, ry);
-                        }
-                        glEnd();
+                        float dirLen = std::sqrt(txDirX * txDirX + txDirY * txDirY);
+
+                        RenderInstance& trail = trails[i];
+                        trail.x = bx;
+                        trail.y = by;
+                        trail.sizeX = size * 3.0f * dirLen;
+                        trail.sizeY = size * 0.4f * dirLen;
+                        trail.angle = std::atan2(txDirY, txDirX);
+                        trail.setColor(ob.r, ob.g, ob.b, alpha);
+
+                        RenderInstance& glow = glows[i];
+                        glow.x = bx;
+                        glow.y = by;
+                        glow.sizeX = glow.sizeY = size;
+                        glow.angle = 0.0f;
+                        glow.setColor(ob.r, ob.g, ob.b, alpha);
                     }
+                    gfx.drawInstances(SHAPE_COMET, trails, orbitBallCount);
+                    gfx.drawInstances(SHAPE_GLOW_DISC, glows, orbitBallCount);
                 }
 
                 // AI loss countdown
@@ -3258,8 +2892,8 @@ void Game::render() {
                         float nx = centerX - numWidth * 0.5f;
                         float ny = sy + numScale * 1.4f;
 
-                        float jitter = 1.5f * std::sin((float)winLoseTimer * 10.0f);
-                        glColor4f(1.0f, 0.4f, 0.4f, 1.0f);
+                        float jitter = 1.5f * fastSin((float)winLoseTimer * 10.0f);
+                        gfx.color(1.0f, 0.4f, 0.4f, 1.0f);
                         drawText(nx + jitter, ny, numScale, num);
                     }
                 }
@@ -3272,11 +2906,11 @@ void Game::render() {
                     float px = centerX - promptWidth * 0.5f;
                     float py = sy + 40.0f;
 
-                    float blink = 0.5f + 0.5f * std::sin((float)winLoseTimer * 4.0f);
+                    float blink = oscillate((float)winLoseTimer, 4.0f, 0.5f, 0.5f);
                     float pr = lastAiWin ? 0.8f : 1.0f;
                     float pg = lastAiWin ? 0.8f : 1.0f;
                     float pb = 1.0f;
-                    glColor4f(pr, pg, pb, blink);
+                    gfx.color(pr, pg, pb, blink);
                     drawText(px, py, promptScale, prompt);
                 }
             } else if (currentMenu == MENU_PAUSE) {
@@ -3287,21 +2921,21 @@ void Game::render() {
                 float hx = (float)width * 0.5f - headerW * 0.5f;
                 float hy = (float)height * 0.3f;
 
-                glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
+                gfx.color(0.0f, 0.0f, 0.0f, 0.5f);
                 drawText(hx + 2.0f, hy + 2.0f, headerScale, headerText);
-                glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+                gfx.color(1.0f, 1.0f, 1.0f, 1.0f);
                 drawText(hx, hy, headerScale, headerText);
 
                 // Separator
                 float sepY = hy + headerScale * 1.3f;
                 float sepW = 160.0f;
-                glBegin(GL_QUADS);
-                glColor4f(0.3f, 0.5f, 0.8f, 0.5f);
-                glVertex2f((float)width * 0.5f - sepW * 0.5f, sepY);
-                glVertex2f((float)width * 0.5f + sepW * 0.5f, sepY);
-                glVertex2f((float)width * 0.5f + sepW * 0.5f, sepY + 2.0f);
-                glVertex2f((float)width * 0.5f - sepW * 0.5f, sepY + 2.0f);
-                glEnd();
+                gfx.begin(GL_QUADS);
+                gfx.color(0.3f, 0.5f, 0.8f, 0.5f);
+                gfx.vertex((float)width * 0.5f - sepW * 0.5f, sepY);
+                gfx.vertex((float)width * 0.5f + sepW * 0.5f, sepY);
+                gfx.vertex((float)width * 0.5f + sepW * 0.5f, sepY + 2.0f);
+                gfx.vertex((float)width * 0.5f - sepW * 0.5f, sepY + 2.0f);
+                gfx.end();
 
                 const char* pauseItems[3] = { "RESUME", "SETTINGS", "MAIN MENU" };
                 float menuScale = 20.0f;
@@ -3315,24 +2949,24 @@ void Game::render() {
                     float iy = startY + i * itemSpacing;
 
                     if (i == menuSelection) {
-                        float glowPulse = 0.6f + 0.4f * std::sin((float)menuAnimTimer * 5.0f);
+                        float glowPulse = oscillate((float)menuAnimTimer, 5.0f, 0.6f, 0.4f);
                         float bgPad = 8.0f;
-                        glBegin(GL_QUADS);
-                        glColor4f(0.2f, 0.4f, 0.8f, 0.25f * glowPulse);
-                        glVertex2f(ix - bgPad, iy - 2.0f);
-                        glVertex2f(ix + w + bgPad, iy - 2.0f);
-                        glVertex2f(ix + w + bgPad, iy + menuScale + 2.0f);
-                        glVertex2f(ix - bgPad, iy + menuScale + 2.0f);
-                        glEnd();
+                        gfx.begin(GL_QUADS);
+                        gfx.color(0.2f, 0.4f, 0.8f, 0.25f * glowPulse);
+                        gfx.vertex(ix - bgPad, iy - 2.0f);
+                        gfx.vertex(ix + w + bgPad, iy - 2.0f);
+                        gfx.vertex(ix + w + bgPad, iy + menuScale + 2.0f);
+                        gfx.vertex(ix - bgPad, iy + menuScale + 2.0f);
+                        gfx.end();
 
                         float bracketOffset = 12.0f;
-                        glColor4f(0.3f, 0.7f, 1.0f, 1.0f);
+                        gfx.color(0.3f, 0.7f, 1.0f, 1.0f);
                         drawText(ix - bracketOffset - measureText(menuScale, ">"), iy, menuScale, ">");
                         drawText(ix + w + bracketOffset, iy, menuScale, "<");
 
-                        glColor4f(1.0f, 1.0f, 0.3f, 1.0f);
+                        gfx.color(1.0f, 1.0f, 0.3f, 1.0f);
                     } else {
-                        glColor4f(0.8f, 0.8f, 0.85f, 1.0f);
+                        gfx.color(0.8f, 0.8f, 0.85f, 1.0f);
                     }
 
                     drawText(ix, iy, menuScale, label);
@@ -3340,49 +2974,288 @@ void Game::render() {
             }
         }
     }
+    prof.end(PROFILE_MENU);
 }
 
 void Game::run() {
+    if (benchFrames > 0) {
+        runRenderBenchmark();
+        return;
+    }
     while (isRunning) {
         Uint64 now = SDL_GetPerformanceCounter();
         double dt = (double)(now - lastCounter) / (double)perfFreq;
         lastCounter = now;
+        if (dt > MaxFrameTime) dt = MaxFrameTime;
 
+        Profiler& prof = Profiler::getInstance();
+        prof.begin(PROFILE_EVENTS);
         handleEvents();
+        AssetLoader::getInstance().pumpMainThread();
+        prof.end(PROFILE_EVENTS);
         
         // Handle splash screen timing
         if (inSplashScreen) {
             splashTimer += dt;
-            double totalDuration = splashFadeInDuration + splashHoldDuration + splashFadeOutDuration;
-            if (splashTimer >= totalDuration) {
-                // Splash screen finished, transition to start screen
-                inSplashScreen = false;
-                inStartScreen = true;
-                paused = true;
-                currentMenu = MENU_MAIN;
-                menuSelection = 0;
-                menuAnimTimer = 0.0;
+            // Loading has to finish before the menu can be reached
+            if (splashTimer >= splashDuration() && AssetLoader::getInstance().isIdle()) {
+                endSplashScreen();
             }
         } else {
             update(dt);
         }
         
+        Renderer& gfx = Renderer::getInstance();
+        prof.begin(PROFILE_RENDER);
+        gfx.beginFrame();
         render();
+        if (profilerOverlay && !inSplashScreen) {
+            drawProfilerOverlay();
+        }
+        gfx.endFrame();
+        prof.end(PROFILE_RENDER);
+
+        prof.begin(PROFILE_SWAP);
         SDL_GL_SwapWindow(window);
+        prof.end(PROFILE_SWAP);
+
+        double gpuMs = 0.0;
+        if (gfx.pollGpuFrameTime(gpuMs)) {
+            prof.record(PROFILE_GPU, gpuMs);
+        }
+        prof.endFrame();
+    }
+}
+
+void Game::setRenderBenchmark(int framesPerScene) {
+    benchFrames = framesPerScene > 0 ? framesPerScene : 0;
+    if (benchFrames > 0) {
+        soundEnabled = false;
+    }
+}
+
+void Game::setupBenchScene(BenchScene scene) {
+    fxRng.seed(BenchSeed, RNG_STREAM_COSMETIC);
+    inSplashScreen = false;
+    inStartScreen = false;
+    inColorMenu = false;
+    inWinLoseScreen = false;
+    gameOver = false;
+    loseShatterActive = false;
+    winDanceActive = false;
+    benchAutoplay = false;
+    menuSelection = 0;
+    menuAnimTimer = 0.0;
+    labelTimer = 0.0;
+    fxEnabled = true;
+
+    switch (scene) {
+    case BENCH_MAIN_MENU:
+    case BENCH_SETTINGS_MENU:
+        currentMenu = (scene == BENCH_MAIN_MENU) ? MENU_MAIN : MENU_SETTINGS;
+        paused = true;
+        hasActiveGame = false;
+        break;
+    case BENCH_BATTLE_RALLY:
+        singlePlayer = false;
+        gameMode = MODE_BATTLE;
+        freeMovement = true;
+        shieldEnabled = true;
+        endlessMode = true;
+        currentMenu = MENU_NONE;
+        paused = false;
+        hasActiveGame = true;
+        benchAutoplay = true;
+        startMatch(BenchSeed);
+        break;
+    case BENCH_LOSE_SHATTER:
+    case BENCH_WIN_DANCE:
+        singlePlayer = true;
+        playerSide = 1;
+        gameMode = MODE_BATTLE;
+        freeMovement = false;
+        endlessMode = false;
+        currentMenu = MENU_NONE;
+        hasActiveGame = false;
+        startMatch(BenchSeed);
+        match.winner = (scene == BENCH_LOSE_SHATTER) ? 2 : 1;
+        match.koWin = true;
+        beginWinLoseScreen();
+        break;
+    default:
+        break;
+    }
+}
+
+void Game::runRenderBenchmark() {
+    static const char* const sceneNames[BENCH_SCENE_COUNT] = {
+        "main menu", "settings menu", "battle rally", "lose shatter", "win dance"
+    };
+    // Fixed step so every run animates identically whatever the frame rate
+    const double frameDt = 1.0 / 60.0;
+
+    // Every scene draws with its real assets, so loading has to be done first
+    AssetLoader::getInstance().waitIdle();
+    Renderer& gfx = Renderer::getInstance();
+    gfx.setGpuTiming(true);
+
+    std::printf("Render benchmark: %d frames per scene, vsync off, %s path%s\n", benchFrames,
+                gfx.usingShaderPath() ? "shader" : "fixed", gfx.usingInstancing() ? " + instancing" : "");
+    std::printf("%-14s %8s %8s %8s %8s %8s %8s %9s %9s\n",
+                "scene", "min ms", "avg ms", "p50 ms", "p90 ms", "p99 ms", "max ms", "gpu avg", "gpu p99");
+
+    std::vector<float> cpuMs;
+    std::vector<float> gpuMs;
+    cpuMs.reserve(benchFrames);
+    gpuMs.reserve(benchFrames);
+    for (int sc = 0; sc < BENCH_SCENE_COUNT && isRunning; ++sc) {
+        BenchScene scene = (BenchScene)sc;
+        setupBenchScene(scene);
+        cpuMs.clear();
+        gpuMs.clear();
+
+        // Warm-up frames fill the text cache and the driver's queues, unrecorded
+        for (int f = -BenchWarmupFrames; f < benchFrames && isRunning; ++f) {
+            // One-shot screens replay so the whole run measures the busy part
+            bool oneShot = (scene == BENCH_LOSE_SHATTER || scene == BENCH_WIN_DANCE);
+            if ((oneShot && f > 0 && f % BenchReplayFrames == 0) ||
+                (scene == BENCH_BATTLE_RALLY && gameOver)) {
+                setupBenchScene(scene);
+            }
+
+            Uint64 start = SDL_GetPerformanceCounter();
+            SDL_Event e;
+            while (SDL_PollEvent(&e)) {
+                if (e.type == SDL_EVENT_QUIT ||
+                    (e.type == SDL_EVENT_KEY_DOWN && e.key.scancode == SDL_SCANCODE_ESCAPE)) {
+                    isRunning = false;
+                }
+            }
+            AssetLoader::getInstance().pumpMainThread();
+            update(frameDt);
+            gfx.beginFrame();
+            render();
+            gfx.endFrame();
+            SDL_GL_SwapWindow(window);
+            Uint64 end = SDL_GetPerformanceCounter();
+
+            double gpu = 0.0;
+            bool haveGpu = gfx.pollGpuFrameTime(gpu);
+            if (f >= 0) {
+                cpuMs.push_back((float)((double)(end - start) * 1000.0 / (double)perfFreq));
+                if (haveGpu) gpuMs.push_back((float)gpu);
+            }
+        }
+        if (cpuMs.empty()) {
+            break;
+        }
+
+        std::sort(cpuMs.begin(), cpuMs.end());
+        std::sort(gpuMs.begin(), gpuMs.end());
+        auto percentile = [](const std::vector<float>& v, int pct) {
+            size_t i = (v.size() * (size_t)pct + 99) / 100;
+            return v[i > 0 ? i - 1 : 0];
+        };
+        double sum = 0.0;
+        for (float ms : cpuMs) sum += ms;
+        double gpuSum = 0.0;
+        for (float ms : gpuMs) gpuSum += ms;
+
+        std::printf("%-14s %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f", sceneNames[sc],
+                    cpuMs.front(), sum / cpuMs.size(), percentile(cpuMs, 50), percentile(cpuMs, 90),
+                    percentile(cpuMs, 99), cpuMs.back());
+        if (gpuMs.empty()) {
+            std::printf(" %9s %9s\n", "n/a", "n/a");
+        } else {
+            std::printf(" %9.3f %9.3f\n", gpuSum / gpuMs.size(), percentile(gpuMs, 99));
+        }
+        std::fflush(stdout);
+    }
+    isRunning = false;
+}
+
+void Game::setProfiling(bool enabled) {
+    Profiler::getInstance().setEnabled(enabled);
+    if (glContext) {
+        Renderer::getInstance().setGpuTiming(enabled);
+    }
+}
+
+void Game::drawProfilerOverlay() {
+    Renderer& gfx = Renderer::getInstance();
+    Profiler& prof = Profiler::getInstance();
+    gfx.setDepthTest(false);
+    resetProjection();
+    gfx.loadIdentity();
+
+    const float scale = 11.0f;
+    const float lineH = scale * 1.5f;
+    const float x = 12.0f;
+    float y = 12.0f;
+    const int rows = PROFILE_ZONE_COUNT + 2;
+
+    gfx.color(0.0f, 0.0f, 0.0f, 0.7f);
+    gfx.begin(GL_QUADS);
+    gfx.vertex(x - 6.0f, y - 6.0f);
+    gfx.vertex(x + scale * 34.0f, y - 6.0f);
+    gfx.vertex(x + scale * 34.0f, y + lineH * rows);
+    gfx.vertex(x - 6.0f, y + lineH * rows);
+    gfx.end();
+
+    char line[96];
+    gfx.color(0.6f, 0.9f, 1.0f, 1.0f);
+    std::snprintf(line, sizeof(line), "ZONE        MIN    AVG    P99  MS");
+    drawText(x, y, scale, line);
+    y += lineH;
+
+    for (int z = 0; z < PROFILE_ZONE_COUNT; ++z) {
+        ProfileZone zone = (ProfileZone)z;
+        const ProfileStats& st = prof.stats(zone);
+        if (zone == PROFILE_GPU && !gfx.hasGpuTiming()) {
+            std::snprintf(line, sizeof(line), "%-9s   N/A", Profiler::zoneName(zone));
+        } else {
+            std::snprintf(line, sizeof(line), "%-9s %5.2f  %5.2f  %5.2f",
+                          Profiler::zoneName(zone), st.minMs, st.avgMs, st.p99Ms);
+        }
+        // Flag anything whose p99 blows a 60 Hz frame
+        if (st.p99Ms > 16.7f) gfx.color(1.0f, 0.4f, 0.3f, 1.0f);
+        else gfx.color(1.0f, 1.0f, 1.0f, 1.0f);
+        drawText(x, y, scale, line);
+        y += lineH;
     }
+
+    gfx.color(0.7f, 0.7f, 0.75f, 1.0f);
+    std::snprintf(line, sizeof(line), "%d DRAWS  %d VERTS", gfx.getDrawCalls(), gfx.getVertexCount());
+    drawText(x, y, scale, line);
 }
 
 void Game::clean() {
+    if (netplay) endNetplay();
+    if (spectating) endSpectating();
+    if (broadcaster.isOpen()) {
+        const SpectatorPublisher::Stats& st = broadcaster.stats();
+        std::printf("Broadcast: %u frames, %u KB sent in %u delta and %u full packets\n", st.frames,
+                    st.bytesSent / 1024, st.deltaPackets, st.fullPackets);
+        broadcaster.close();
+    }
+    saveMatchRecording();
+    Profiler& prof = Profiler::getInstance();
+    if (prof.recordedFrames() > 0) {
+        prof.writeCsv(profileCsvPath);
+    }
+    AssetLoader::getInstance().stop();
     cleanupSplashTexture();
     
     // Cleanup audio system
     AudioManager::getInstance().cleanup();
+    AssetPack::getInstance().close();
     
     delete ball;
     delete paddle1;
     delete paddle2;
 
     if (glContext) {
+        Renderer::getInstance().shutdown();
         SDL_GL_DestroyContext(glContext);
         glContext = nullptr;
     }
@@ -3394,13 +3267,42 @@ void Game::clean() {
 }
 
 // Splash screen implementation
-bool Game::loadSplashTexture(const char* filepath) {
+bool Game::decodeSplashImage(const char* filepath) {
+    // Loader worker: produce RGBA pixels only, no GL here
+    const AssetPack& pack = AssetPack::getInstance();
+    const AssetPackEntry* entry = pack.isOpen() ? pack.find(filepath) : nullptr;
+    // A stale or damaged pack could claim more pixels than the entry holds
+    if (entry && entry->type == ASSET_IMAGE_RGBA8 &&
+        (entry->width == 0 || entry->height == 0 ||
+         entry->size < (Uint64)entry->width * entry->height * 4)) {
+        std::fprintf(stderr, "Splash image in assets.pak is %ux%u but only %llu bytes; decoding %s instead\n",
+                     (unsigned)entry->width, (unsigned)entry->height, (unsigned long long)entry->size, filepath);
+        entry = nullptr;
+    }
+    if (entry && entry->type == ASSET_IMAGE_RGBA8) {
+        splashImageWidth = (int)entry->width;
+        splashImageHeight = (int)entry->height;
+        splashPixels = pack.data(*entry);
+        return true;
+    }
+
     int channels = 0;
-    unsigned char* data = stbi_load(filepath, &splashImageWidth, &splashImageHeight, &channels, 4);
-    if (!data) {
+    splashDecoded = stbi_load(filepath, &splashImageWidth, &splashImageHeight, &channels, 4);
+    if (!splashDecoded) {
         std::fprintf(stderr, "Failed to load splash image: %s\n", filepath);
         return false;
     }
+    splashPixels = splashDecoded;
+    return true;
+}
+
+void Game::uploadSplashTexture() {
+    if (!splashPixels) {
+        // Nothing to show: leave as soon as the rest has loaded
+        std::fprintf(stderr, "Warning: Could not load splash screen image. Continuing without it.\n");
+        splashTimer = splashDuration();
+        return;
+    }
 
     // No need to flip - we'll fix it with texture coordinates
 
@@ -3410,12 +3312,28 @@ bool Game::loadSplashTexture(const char* filepath) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, splashImageWidth, splashImageHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, splashImageWidth, splashImageHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, splashPixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    stbi_image_free(data);
+    if (splashDecoded) stbi_image_free(splashDecoded);
+    splashDecoded = nullptr;
+    splashPixels = nullptr;
     splashTextureLoaded = true;
-    return true;
+}
+
+void Game::endSplashScreen() {
+    inSplashScreen = false;
+    inStartScreen = true;
+    paused = true;
+    currentMenu = MENU_MAIN;
+    menuSelection = 0;
+    menuAnimTimer = 0.0;
+    labelTimer = 0.0;
+    if (replayMode) {
+        startReplayMatch();
+    }
 }
 
 void Game::renderSplashScreen() {
@@ -2,6 +2,12 @@
 #include "SDL3/SDL.h"
 #include "SDL3/SDL_opengl.h"
 #include "AudioManager_Fixed.h"  // Fixed audio system with real output
+#include "Simulation.h"
+#include "ParticleSystem.h"
+#include "Replay.h"
+#include "Netplay.h"
+#include "Spectator.h"
+#include <vector>
 
 class Paddle;
 class Ball;
@@ -13,45 +19,79 @@ public:
     void run();
     void clean();
 
+    // Simulation rate in ticks per second; independent of the display refresh
+    void setTickRate(int hz);
+
+    // Frame profiler: CPU zones plus GPU time, dumped to profileCsvPath on exit.
+    // F3 toggles the overlay (and switches recording on).
+    void setProfiling(bool enabled);
+
+    // Play a recorded match instead of taking input; false if it can't be read.
+    // Every live match is recorded to ReplayLastMatchPath when it ends.
+    bool loadReplay(const char* path);
+
+    // Online PvP with rollback instead of the menus: the host plays the left
+    // paddle with its own rules, the joining player the right one. Both play
+    // with P1's keys (or the mouse). Call before init().
+    void hostNetplay(unsigned short port);
+    bool joinNetplay(const char* address);    // false if it can't be resolved
+    void setNetplayInputDelay(int ticks);
+    void setNetplayLag(int ticks);            // testing: simulated one-way lag, in ticks
+
+    // Venue screens: the broadcasting game publishes every match it plays on a
+    // UDP port; a spectating game draws that stream instead of simulating.
+    // Call before init().
+    void broadcastMatches(unsigned short port);
+    bool spectate(const char* address);       // false if it can't be resolved
+
+    // --bench-render: play each scripted scene for framesPerScene frames with
+    // vsync off, print per-scene frame time distributions, then quit.
+    // Call before init().
+    void setRenderBenchmark(int framesPerScene);
+
 private:
     void handleEvents();
     void update(double dt);
+    void fixedUpdate(float dt);
     void render();
     void resetProjection();
     int menuHitTest(float my) const;
 
-private:
-    struct LoseShard {
-        float x;
-        float y;
-        float vx;
-        float vy;
-        float ax;
-        float ay;
-        float size;
-        float angle;
-        float angularVelocity;
-        float life;
-        float maxLife;
-        float r;
-        float g;
-        float b;
-        bool active;
-    };
+    // Bridges between Game and the headless match simulation
+    MatchConfig buildMatchConfig() const;
+    MatchInput gatherInput() const;
+    void startMatch(unsigned int seed = 0);   // 0 = seed from the clock
+    void adoptMatchConfig(const MatchConfig& cfg);
+    void enterMatch();
+    void syncRenderEntities();
+    bool ballServed(int index) const;   // re-served by a goal on the last tick
+    void handleMatchEvents(const SimEvents& queue, unsigned int events);   // the kinds to act on
+    void handleMatchEvent(const SimEvent& e, bool firstOfKind);
+    void beginWinLoseScreen();
+    void drawProfilerOverlay();
+    void startReplayMatch();
+    void finishReplay();
+    void saveMatchRecording();
+    bool openNetplay();
+    void updateNetplay();
+    void startNetMatch();
+    void endNetplay();
+    void updateSpectating();
+    void endSpectating();
 
-    struct LoseWisp {
-        float x;
-        float y;
-        float vx;
-        float vy;
-        float life;
-        float maxLife;
-        float r;
-        float g;
-        float b;
-        bool active;
+    // Render benchmark
+    enum BenchScene {
+        BENCH_MAIN_MENU = 0,
+        BENCH_SETTINGS_MENU,
+        BENCH_BATTLE_RALLY,
+        BENCH_LOSE_SHATTER,
+        BENCH_WIN_DANCE,
+        BENCH_SCENE_COUNT
     };
+    void runRenderBenchmark();
+    void setupBenchScene(BenchScene scene);
 
+private:
     struct OrbitBall {
         float angle;
         float radius;
@@ -62,34 +102,30 @@ private:
         float b;
     };
 
-    struct BoostParticle {
-        float x, y;
-        float vx, vy;
-        float life;
-        float maxLife;
-        float size;
-        float r, g, b;
-        bool active;
-    };
-
-    static const int MaxBoostParticles = 48;
-    static const int MaxLoseShards = 96;
-    static const int MaxLoseWisps = 64;
+    // Pool capacities; the burst sizes below are what a normal screen spawns
+    static const int MaxBoostParticles = 4096;
+    static const int MaxLoseShards = 8192;
+    static const int MaxLoseWisps = 4096;
+    static const int LoseShardBurst = 96;
+    static const int LoseWispBurst = 64;
     static const int MaxOrbitBalls = 10;
 
-    BoostParticle boostParticles1[MaxBoostParticles];
-    BoostParticle boostParticles2[MaxBoostParticles];
-    int boostParticleCount1 = 0;
-    int boostParticleCount2 = 0;
+    // Cosmetic randomness only; gameplay draws from MatchState::rng
+    Rng fxRng = {};
+
+    ParticleSystem boostParticles1{MaxBoostParticles};
+    ParticleSystem boostParticles2{MaxBoostParticles};
+    // A trail starts on EVENT_BOOST_START and runs until that paddle's boost ends
+    static constexpr float BoostEmitInterval = 0.03f;
+    bool boostTrail1 = false;
+    bool boostTrail2 = false;
     float boostEmitTimer1 = 0.0f;
     float boostEmitTimer2 = 0.0f;
 
-    LoseShard loseShards[MaxLoseShards];
-    LoseWisp loseWisps[MaxLoseWisps];
+    ParticleSystem loseShards{MaxLoseShards};
+    ParticleSystem loseWisps{MaxLoseWisps};
     OrbitBall orbitBalls[MaxOrbitBalls];
 
-    int loseShardCount = 0;
-    int loseWispCount = 0;
     int orbitBallCount = 0;
     bool loseShatterActive = false;
     bool winDanceActive = false;
@@ -120,10 +156,8 @@ private:
     bool soundEnabled = true;
     int volumePercent = 75;  // 25, 50, 75, 100
 
-    enum GameMode { MODE_CLASSIC = 0, MODE_BATTLE = 1 };
     GameMode gameMode = MODE_CLASSIC;
 
-    enum AIDifficulty { AI_EASY = 0, AI_MEDIUM = 1, AI_HARD = 2 };
     AIDifficulty aiDifficulty = AI_MEDIUM;
     int playerSide = 1; // 1 = left paddle (P1), 2 = right paddle (P2)
     bool inColorMenu = false;
@@ -154,49 +188,62 @@ private:
     Paddle* paddle2 = nullptr;
     Ball* ball = nullptr;
 
-    int score1 = 0;
-    int score2 = 0;
-    int lastScore1 = 0;
-    int lastScore2 = 0;
+    // Gameplay state; everything else in Game is menus, settings and effects
+    MatchState match = {};
+    MatchState prevMatch = {};   // state before the last tick, for render interpolation
+    SimEvents stepEvents = {};   // what the last tick raised; after a rollback, new ones only
+
+    // Fixed-timestep loop
+    static constexpr int DefaultTickRate = 120;
+    static constexpr int MaxTicksPerFrame = 8;      // spiral-of-death guard
+    static constexpr double MaxFrameTime = 0.25;    // clamp for hitches/debugger breaks
+    int tickRate = DefaultTickRate;
+    double simAccumulator = 0.0;
+    float renderAlpha = 1.0f;    // blend factor between prevMatch and match
+
+    // Replays
+    ReplayRecorder recorder;     // the live match, one entry per tick
+    ReplayPlayer replay;
+    bool replayMode = false;     // ticks come from `replay` instead of the keyboard
+
+    // Online PvP; the session owns the rules, seed and tick rate of the match
+    NetSession net;
+    bool netplay = false;        // this run plays online; cleared once the session ends
+    bool netHosting = false;
+    bool netMatchLive = false;   // connected, and `match` is stepped through the session
+    unsigned short netPort = NetDefaultPort;
+    NetAddress netHostAddress = {};
+    int netInputDelay = 2;
+    int netLagTicks = 0;
+
+    // Spectator broadcast: publishing this game's matches, or watching another's
+    SpectatorPublisher broadcaster;
+    unsigned short broadcastPort = 0;     // 0 = not broadcasting
+    SpectatorViewer viewer;
+    bool spectating = false;              // this run watches a broadcast; cleared once it ends
+    NetAddress spectateAddress = {};
+    unsigned int spectateConfigVersion = 0;
+    double spectateFrameAge = 0.0;        // since the newest frame arrived
+    double spectateFrameGap = 1.0 / 60.0; // smoothed time between frames, for the render blend
 
-    int health1 = 10;
-    int health2 = 10;
     int maxHealth = 10;
     static const int MaxHealthOptions[4];
     int maxHealthIndex = 1; // index into MaxHealthOptions (0=5, 1=10, 2=15, 3=20)
-    bool koWin = false;
-
-    float boostMeter1 = 0.0f;
-    float boostMeter2 = 0.0f;
-    bool boostActive1 = false;
-    bool boostActive2 = false;
-    bool boostActive1Prev = false;  // Track previous state for sound triggers
-    bool boostActive2Prev = false;  // Track previous state for sound triggers
-    bool autoBoostEnabled = false;
-    static constexpr float BoostMultiplier = 1.6f;
-    static constexpr float BoostDrainRate = 0.8f;
-    static constexpr float BoostFillAmount = 0.25f;
+    static const int BallCountOptions[6];
+    int ballCountIndex = 0; // index into BallCountOptions (1, 3, 10, 50, 100, 250)
 
+    bool autoBoostEnabled = false;
     bool shieldEnabled = true;
-    bool shieldHeld1 = false;
-    bool shieldHeld2 = false;
-    float shieldCooldown1 = 0.0f;  // fixed-mode: cooldown after consumption
-    float shieldCooldown2 = 0.0f;
-    static constexpr float ShieldCooldown = 3.0f;
-    static constexpr float ShieldSpeedBoost = 1.3f;
-
-    struct ShieldPickup {
-        float x, y;
-        float targetY;       // where it floats to after spawning
-        float bobTimer;
-        bool active;
-    };
-    ShieldPickup shieldPickup1 = {0, 0, 0, 0, false};
-    ShieldPickup shieldPickup2 = {0, 0, 0, 0, false};
 
     float ballExplosionX = 0.0f;
     float ballExplosionY = 0.0f;
 
+    bool profilerOverlay = false;
+    const char* profileCsvPath = "profile.csv";
+
+    int benchFrames = 0;          // frames per scene; 0 = normal run
+    bool benchAutoplay = false;   // both paddles scripted (battle rally scene)
+
     Uint64 perfFreq = 0;
     Uint64 lastCounter = 0;
 
@@ -210,8 +257,13 @@ private:
     int splashImageWidth = 0;
     int splashImageHeight = 0;
     bool splashTextureLoaded = false;
+    const void* splashPixels = nullptr;      // decoded on a loader worker
+    unsigned char* splashDecoded = nullptr;  // stb_image buffer behind splashPixels, if any
 
-    bool loadSplashTexture(const char* filepath);
+    double splashDuration() const { return splashFadeInDuration + splashHoldDuration + splashFadeOutDuration; }
+    bool decodeSplashImage(const char* filepath);
+    void uploadSplashTexture();
+    void endSplashScreen();
     void renderSplashScreen();
     void cleanupSplashTexture();
 };
\ No newline at end of file
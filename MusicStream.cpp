@@ -0,0 +1,112 @@
+#include "MusicStream.h"
+#include <cstdio>
+#include <cstring>
+
+// stb_vorbis is vendored next to stb_image.h
+#include "stb_vorbis.c"
+
+bool MusicStream::open(const char* path, const SDL_AudioSpec& deviceSpec) {
+    close();
+
+    int error = 0;
+    stb_vorbis* v = stb_vorbis_open_filename(path, &error, nullptr);
+    if (!v) {
+        std::fprintf(stderr, "Failed to open music '%s' (stb_vorbis error %d)\n", path, error);
+        return false;
+    }
+    stb_vorbis_info info = stb_vorbis_get_info(v);
+
+    // Decode at most two channels; the converter handles mono and the sample rate
+    sourceChannels = info.channels > 2 ? 2 : info.channels;
+    SDL_AudioSpec src;
+    SDL_zero(src);
+    src.format = SDL_AUDIO_F32;
+    src.channels = sourceChannels;
+    src.freq = (int)info.sample_rate;
+
+    converter = SDL_CreateAudioStream(&src, &deviceSpec);
+    if (!converter) {
+        std::fprintf(stderr, "Failed to create music conversion stream for '%s': %s\n", path, SDL_GetError());
+        stb_vorbis_close(v);
+        return false;
+    }
+    decoder = v;
+    writePos.store(0, std::memory_order_relaxed);
+    readPos.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void MusicStream::close() {
+    if (decoder) {
+        stb_vorbis_close(static_cast<stb_vorbis*>(decoder));
+    }
+    decoder = nullptr;
+    if (converter) {
+        SDL_DestroyAudioStream(converter);
+        converter = nullptr;
+    }
+}
+
+void MusicStream::writeRing(const float* frames, int count) {
+    Uint32 w = writePos.load(std::memory_order_relaxed);
+    int start = (int)(w % RingFrames);
+    int first = count < RingFrames - start ? count : RingFrames - start;
+    std::memcpy(ring + start * 2, frames, first * 2 * sizeof(float));
+    if (count > first) {
+        std::memcpy(ring, frames + first * 2, (count - first) * 2 * sizeof(float));
+    }
+    writePos.store(w + (Uint32)count, std::memory_order_release);
+}
+
+void MusicStream::fill() {
+    if (!decoder || !converter) return;
+    stb_vorbis* v = static_cast<stb_vorbis*>(decoder);
+    const int frameBytes = (int)(2 * sizeof(float));
+    bool rewound = false;
+
+    for (;;) {
+        Uint32 used = writePos.load(std::memory_order_relaxed) - readPos.load(std::memory_order_acquire);
+        int space = RingFrames - (int)used;
+        if (space <= 0) return;
+
+        // Move already converted audio into the ring first
+        int converted = SDL_GetAudioStreamAvailable(converter) / frameBytes;
+        if (converted > 0) {
+            int n = converted;
+            if (n > space) n = space;
+            if (n > DecodeChunkFrames) n = DecodeChunkFrames;
+            int got = SDL_GetAudioStreamData(converter, convertBuffer, n * frameBytes) / frameBytes;
+            if (got <= 0) return;
+            writeRing(convertBuffer, got);
+            continue;
+        }
+
+        // Decode the next chunk, looping back to the start at end of file
+        int frames = stb_vorbis_get_samples_float_interleaved(v, sourceChannels, decodeBuffer,
+                                                              DecodeChunkFrames * sourceChannels);
+        if (frames == 0) {
+            if (rewound) return;   // empty or broken file; don't spin
+            stb_vorbis_seek_start(v);
+            rewound = true;
+            continue;
+        }
+        rewound = false;
+        SDL_PutAudioStreamData(converter, decodeBuffer, frames * sourceChannels * (int)sizeof(float));
+    }
+}
+
+int MusicStream::read(float* out, int frames) {
+    Uint32 r = readPos.load(std::memory_order_relaxed);
+    Uint32 available = writePos.load(std::memory_order_acquire) - r;
+    int count = frames < (int)available ? frames : (int)available;
+    if (count <= 0) return 0;
+
+    int start = (int)(r % RingFrames);
+    int first = count < RingFrames - start ? count : RingFrames - start;
+    std::memcpy(out, ring + start * 2, first * 2 * sizeof(float));
+    if (count > first) {
+        std::memcpy(out + first * 2, ring, (count - first) * 2 * sizeof(float));
+    }
+    readPos.store(r + (Uint32)count, std::memory_order_release);
+    return count;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "SDL3/SDL.h"
+#include <atomic>
+
+// One streamed music track. The music worker thread decodes the OGG file in
+// small chunks, converts it to the device format and writes it into a ring
+// buffer; the audio callback reads from the ring. Only the ring and one decode
+// chunk are resident - the decoded file never is.
+//
+// Ownership moves through `state`: the worker opens a stream while it is IDLE
+// and publishes it as READY, the audio thread takes it to PLAYING and hands it
+// back as FINISHED once it has faded out, and the worker closes it to IDLE.
+class MusicStream {
+public:
+    enum State { STATE_IDLE = 0, STATE_READY, STATE_PLAYING, STATE_FINISHED };
+
+    MusicStream() = default;
+    ~MusicStream() { close(); }
+    MusicStream(const MusicStream&) = delete;
+    MusicStream& operator=(const MusicStream&) = delete;
+
+    // Worker thread
+    bool open(const char* path, const SDL_AudioSpec& deviceSpec);
+    void close();
+    void fill();                        // top up the ring; loops at end of file
+
+    // Audio thread: copies up to `frames` stereo frames, fewer on underrun
+    int read(float* out, int frames);
+
+    std::atomic<int> state{STATE_IDLE};
+    int fadeFrames = 0;                 // written by the worker before READY
+    Uint32 requestSeq = 0;              // which play request opened it
+
+private:
+    static const int RingFrames = 8192;         // ~186 ms at 44.1 kHz (64 KB)
+    static const int DecodeChunkFrames = 1024;
+
+    void writeRing(const float* frames, int count);
+
+    float ring[RingFrames * 2];
+    std::atomic<Uint32> writePos{0};    // free-running frame counters
+    std::atomic<Uint32> readPos{0};
+
+    void* decoder = nullptr;            // stb_vorbis*
+    SDL_AudioStream* converter = nullptr;
+    int sourceChannels = 0;
+    float decodeBuffer[DecodeChunkFrames * 2];
+    float convertBuffer[DecodeChunkFrames * 2];
+};
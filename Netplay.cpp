@@ -0,0 +1,688 @@
+#include "Netplay.h"
+#include "Replay.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char NetMagic[4] = { 'P', 'P', 'N', 'P' };
+const unsigned int NetVersion = 1;
+const int MaxPacketBytes = 1400;
+const int HandshakeIntervalMs = 100;   // HELLO resends, and keepalives while not advancing
+const int PeerTimeoutMs = 5000;
+
+typedef std::chrono::steady_clock Clock;
+
+int msSince(Clock::time_point t) {
+    return (int)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - t).count();
+}
+
+bool startSockets() {
+#ifdef _WIN32
+    static bool started = false;
+    if (!started) {
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+            std::fprintf(stderr, "Netplay: WSAStartup failed\n");
+            return false;
+        }
+        started = true;
+    }
+#endif
+    return true;
+}
+
+void closeHandle(intptr_t h) {
+#ifdef _WIN32
+    closesocket((SOCKET)h);
+#else
+    ::close((int)h);
+#endif
+}
+
+// Nothing waiting, or an ICMP "port unreachable" echoed back from an earlier send
+bool isSoftError() {
+#ifdef _WIN32
+    int err = WSAGetLastError();
+    return err == WSAEWOULDBLOCK || err == WSAECONNRESET;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNREFUSED || errno == EINTR;
+#endif
+}
+
+sockaddr_in toSockaddr(const NetAddress& a) {
+    sockaddr_in sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(a.ip);
+    sa.sin_port = htons(a.port);
+    return sa;
+}
+
+bool sameAddress(const NetAddress& a, const NetAddress& b) {
+    return a.ip == b.ip && a.port == b.port;
+}
+
+void beginPacket(std::vector<unsigned char>& out, unsigned char type) {
+    out.assign(NetMagic, NetMagic + 4);
+    out.push_back(type);
+}
+
+} // namespace
+
+bool parseNetAddress(const char* text, unsigned short defaultPort, NetAddress& out) {
+    if (!startSockets()) {
+        return false;
+    }
+    std::string host = text;
+    unsigned short port = defaultPort;
+    size_t colon = host.rfind(':');
+    if (colon != std::string::npos) {
+        port = (unsigned short)std::atoi(host.c_str() + colon + 1);
+        host.resize(colon);
+    }
+    if (host.empty()) host = "127.0.0.1";
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (port == 0 || getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        std::fprintf(stderr, "Netplay: cannot resolve '%s'\n", text);
+        return false;
+    }
+    const sockaddr_in* sa = reinterpret_cast<const sockaddr_in*>(result->ai_addr);
+    out.ip = ntohl(sa->sin_addr.s_addr);
+    out.port = port;
+    freeaddrinfo(result);
+    return true;
+}
+
+bool UdpSocket::open(unsigned short port) {
+    close();
+    if (!startSockets()) {
+        return false;
+    }
+    intptr_t h = (intptr_t)::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (h == InvalidHandle) {
+        std::fprintf(stderr, "Netplay: cannot create a UDP socket\n");
+        return false;
+    }
+
+    sockaddr_in sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_ANY);
+    sa.sin_port = htons(port);
+    if (::bind(h, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa)) != 0) {
+        std::fprintf(stderr, "Netplay: cannot bind UDP port %u\n", (unsigned)port);
+        closeHandle(h);
+        return false;
+    }
+
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    bool ok = ioctlsocket((SOCKET)h, FIONBIO, &nonBlocking) == 0;
+#else
+    int flags = fcntl((int)h, F_GETFL, 0);
+    bool ok = flags >= 0 && fcntl((int)h, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+    if (!ok) {
+        std::fprintf(stderr, "Netplay: cannot make the socket non-blocking\n");
+        closeHandle(h);
+        return false;
+    }
+
+    socklen_t len = sizeof(sa);
+    getsockname(h, reinterpret_cast<sockaddr*>(&sa), &len);
+    boundPort = ntohs(sa.sin_port);
+    handle = h;
+    return true;
+}
+
+void UdpSocket::close() {
+    if (handle != InvalidHandle) {
+        closeHandle(handle);
+        handle = InvalidHandle;
+    }
+    boundPort = 0;
+}
+
+bool UdpSocket::send(const NetAddress& to, const void* data, int size) {
+    if (handle == InvalidHandle) {
+        return false;
+    }
+    sockaddr_in sa = toSockaddr(to);
+    int sent = (int)sendto(handle, static_cast<const char*>(data), size, 0,
+                           reinterpret_cast<const sockaddr*>(&sa), sizeof(sa));
+    return sent == size;
+}
+
+int UdpSocket::receive(void* buffer, int capacity, NetAddress& from) {
+    if (handle == InvalidHandle) {
+        return -1;
+    }
+    sockaddr_in sa;
+    socklen_t len = sizeof(sa);
+    int n = (int)recvfrom(handle, static_cast<char*>(buffer), capacity, 0,
+                          reinterpret_cast<sockaddr*>(&sa), &len);
+    if (n < 0) {
+        return isSoftError() ? 0 : -1;
+    }
+    from.ip = ntohl(sa.sin_addr.s_addr);
+    from.port = ntohs(sa.sin_port);
+    return n;
+}
+
+void NetSession::reset() {
+    peer = NetAddress();
+    hosting = false;
+    havePeer = false;
+    connected = false;
+    lost = false;
+    desync = false;
+    matchSeed = 0;
+    rate = 0;
+    cfg = MatchConfig();
+
+    currentFrame = 0;
+    localLatest = 0;
+    wallTicks = 0;
+    std::memset(localInputs, 0, sizeof(localInputs));
+    std::memset(remoteInputs, 0, sizeof(remoteInputs));
+    std::memset(remoteTicks, 0, sizeof(remoteTicks));
+    std::memset(usedRemote, 0, sizeof(usedRemote));
+    remoteContiguous = 0;
+    remoteLatest = 0;
+    peerAck = 0;
+    peerFrame = 0;
+    peerAdvantage = 0;
+    rollbackFrom = 0;
+    lastYieldTick = 0;
+
+    if (snapshots.capacity() != SnapshotDepth) snapshots.reset(SnapshotDepth);
+    for (SimEvents& q : reported) clearEvents(q);
+    std::memset(syncs, 0, sizeof(syncs));
+    nextSyncTick = SyncInterval;
+    lastSyncTick = 0;
+    lastSyncChecksum = 0;
+
+    delayed.clear();
+    counters = Stats();
+    lastHeard = Clock::now();
+    lastSent = Clock::time_point();
+}
+
+bool NetSession::host(unsigned short port, unsigned int seed, int tickRate, const MatchConfig& rules) {
+    close();
+    reset();
+    if (!socket.open(port)) {
+        return false;
+    }
+    hosting = true;
+    matchSeed = seed;
+    rate = tickRate;
+    cfg = rules;
+    // Netplay is always human vs human; tool-only AI profiles never cross the wire
+    cfg.aiControlled1 = false;
+    cfg.aiControlled2 = false;
+    cfg.aiProfile1 = nullptr;
+    cfg.aiProfile2 = nullptr;
+    std::printf("Netplay: hosting on UDP port %u\n", (unsigned)socket.localPort());
+    return true;
+}
+
+bool NetSession::join(const NetAddress& hostAddress) {
+    close();
+    reset();
+    if (!socket.open(0)) {
+        return false;
+    }
+    peer = hostAddress;
+    havePeer = true;
+    sendHello();
+    return true;
+}
+
+void NetSession::close() {
+    if (socket.isOpen() && havePeer) {
+        beginPacket(packet, PACKET_BYE);
+        socket.send(peer, packet.data(), (int)packet.size());
+    }
+    socket.close();
+    havePeer = false;
+    connected = false;
+    delayed.clear();
+}
+
+void NetSession::setInputDelay(int ticks) {
+    if (ticks < 0) ticks = 0;
+    if (ticks > MaxInputDelay) ticks = MaxInputDelay;
+    inputDelay = ticks;
+}
+
+void NetSession::setSimulatedLag(int delayTicks, int jitterTicks, int lossPercent, unsigned int seed) {
+    lagDelay = delayTicks > 0 ? delayTicks : 0;
+    lagJitter = jitterTicks > 0 ? jitterTicks : 0;
+    if (lagJitter > lagDelay) lagJitter = lagDelay;
+    lagLoss = lossPercent < 0 ? 0 : (lossPercent > 100 ? 100 : lossPercent);
+    lagRng.seed(seed, RNG_STREAM_NETLAG);
+}
+
+bool NetSession::poll() {
+    if (!socket.isOpen()) {
+        return false;
+    }
+    receivePackets();
+    if (msSince(lastSent) >= HandshakeIntervalMs) {
+        if (!connected && !hosting) {
+            sendHello();
+        } else if (connected && !lost) {
+            // Keepalive while the game isn't advancing (paused, or between ticks)
+            sendInputs();
+        }
+    }
+    return connected;
+}
+
+void NetSession::startMatch(MatchState& s) {
+    resetMatch(s, cfg, matchSeed);
+    // The first inputDelay ticks have no local input scheduled: they play neutral
+    localLatest = (unsigned int)inputDelay;
+}
+
+unsigned int NetSession::confirmedFrame() const {
+    return remoteContiguous < currentFrame ? remoteContiguous : currentFrame;
+}
+
+int NetSession::confirmedWinner(const MatchState& s) const {
+    unsigned int confirmed = confirmedFrame();
+    if (confirmed == currentFrame) return s.winner;
+    const MatchSnapshot* snap = snapshots.find(confirmed);
+    return snap ? snapshotState(*snap).winner : 0;
+}
+
+bool NetSession::advance(MatchState& s, const PaddleInput& local, float dt, SimEvents* events) {
+    if (!connected || lost) {
+        return false;
+    }
+    ++wallTicks;
+    flushDelayed();
+    receivePackets();
+    if (lost) {
+        return false;
+    }
+
+    // Every tick simulated past the last confirmed input may need re-simulating,
+    // so cap the run-ahead; and give up a tick now and then if the peer is behind
+    if (currentFrame >= remoteContiguous + MaxPrediction || shouldYield()) {
+        ++counters.stallTicks;
+        sendInputs();
+        return false;
+    }
+
+    unsigned int target = currentFrame + (unsigned int)inputDelay;
+    localInputs[target % InputRing] = local;
+    if (target + 1 > localLatest) localLatest = target + 1;
+    sendInputs();
+
+    if (events) clearEvents(*events);
+    if (rollbackFrom < currentFrame) {
+        Clock::time_point start = Clock::now();
+        int depth = (int)(currentFrame - rollbackFrom);
+        snapshots.restore(rollbackFrom, s);
+        for (unsigned int t = rollbackFrom; t < currentFrame; ++t) {
+            simulateTick(s, t, dt, events);
+        }
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        ++counters.rollbacks;
+        counters.resimulatedTicks += (unsigned int)depth;
+        if (depth > counters.maxRollback) counters.maxRollback = depth;
+        if (ms > counters.maxRollbackMs) counters.maxRollbackMs = ms;
+    }
+
+    simulateTick(s, currentFrame, dt, events);
+    ++currentFrame;
+    rollbackFrom = currentFrame;
+    recordSyncChecksums(s);
+    return true;
+}
+
+void NetSession::simulateTick(MatchState& s, unsigned int tick, float dt, SimEvents* events) {
+    snapshots.save(tick, s);
+    PaddleInput remote = remoteInputFor(tick);
+    usedRemote[tick % InputRing] = remote;
+
+    MatchInput in;
+    in.p1 = hosting ? localInputs[tick % InputRing] : remote;
+    in.p2 = hosting ? remote : localInputs[tick % InputRing];
+    SimEvents raised;
+    stepMatch(s, cfg, in, dt, &raised);
+
+    // A re-simulated tick mostly repeats its first run; pass on only what is
+    // new, and remember it so a later rollback does not report it again
+    SimEvents& seen = reported[tick % SnapshotDepth];
+    const bool firstRun = (tick == currentFrame);
+    if (firstRun) clearEvents(seen);
+    bool matched[MaxQueuedEvents] = {};
+    const int seenBefore = seen.count;
+    for (int i = 0; i < raised.count; ++i) {
+        const SimEvent& e = raised.queue[i];
+        int j = 0;
+        while (j < seenBefore && (matched[j] || seen.queue[j].type != e.type ||
+                                  seen.queue[j].side != e.side || seen.queue[j].ball != e.ball)) {
+            ++j;
+        }
+        if (j < seenBefore) {
+            matched[j] = true;
+            continue;
+        }
+        pushEvent(seen, e);
+        if (events) pushEvent(*events, e);
+        if (!firstRun) ++counters.lateEvents;
+    }
+    // Kinds that overflowed the queue carry no details to compare; only the
+    // first run reports them
+    if (firstRun && events) {
+        events->kinds |= raised.kinds;
+        events->dropped += raised.dropped;
+    }
+}
+
+PaddleInput NetSession::remoteInputFor(unsigned int tick) const {
+    if (remoteTicks[tick % InputRing] == tick + 1) {
+        return remoteInputs[tick % InputRing];
+    }
+    // Prediction: the peer keeps doing whatever it did last
+    if (remoteContiguous > 0) {
+        return remoteInputs[(remoteContiguous - 1) % InputRing];
+    }
+    return PaddleInput();
+}
+
+void NetSession::storeRemoteInput(unsigned int tick, const PaddleInput& in) {
+    unsigned int slot = tick % InputRing;
+    if (tick < remoteContiguous || remoteTicks[slot] == tick + 1) {
+        return;   // already have it
+    }
+    if (tick >= remoteContiguous + InputRing - 1) {
+        return;   // would overwrite a slot still in use
+    }
+    remoteInputs[slot] = in;
+    remoteTicks[slot] = tick + 1;
+    if (tick + 1 > remoteLatest) remoteLatest = tick + 1;
+
+    // Already simulated with a guess: if the guess was wrong, rewind to here
+    if (tick < currentFrame && tick < rollbackFrom && !samePaddleInput(in, usedRemote[slot])) {
+        rollbackFrom = tick;
+    }
+    while (remoteTicks[remoteContiguous % InputRing] == remoteContiguous + 1) {
+        ++remoteContiguous;
+    }
+}
+
+bool NetSession::shouldYield() {
+    // Both sides see the other's frame one trip late, so the difference of the
+    // two advantages is twice the real lead with the latency cancelled out
+    if (wallTicks < lastYieldTick + 8) {
+        return false;
+    }
+    if (localAdvantage() - peerAdvantage < 3) {
+        return false;
+    }
+    lastYieldTick = wallTicks;
+    return true;
+}
+
+void NetSession::recordSyncChecksums(const MatchState& s) {
+    unsigned int confirmed = confirmedFrame();
+    while (nextSyncTick <= confirmed) {
+        unsigned int tick = nextSyncTick;
+        nextSyncTick += SyncInterval;
+        const MatchSnapshot* snap = snapshots.find(tick);
+        if (tick != currentFrame && !snap) continue;
+        unsigned int sum = matchChecksum(tick == currentFrame ? s : snapshotState(*snap));
+        lastSyncTick = tick;
+        lastSyncChecksum = sum;
+        noteSync(tick, sum, false);
+    }
+}
+
+void NetSession::noteSync(unsigned int tick, unsigned int checksum, bool fromRemote) {
+    SyncEntry& e = syncs[(tick / SyncInterval) % SyncRing];
+    if (e.tick != tick) {
+        std::memset(&e, 0, sizeof(e));
+        e.tick = tick;
+    } else if (fromRemote ? e.haveRemote : e.haveLocal) {
+        return;   // repeated in a later packet
+    }
+    if (fromRemote) {
+        e.remoteChecksum = checksum;
+        e.haveRemote = true;
+    } else {
+        e.localChecksum = checksum;
+        e.haveLocal = true;
+    }
+    if (e.haveLocal && e.haveRemote) {
+        ++counters.syncChecks;
+        if (e.localChecksum != e.remoteChecksum && !desync) {
+            std::fprintf(stderr, "Netplay: desync at tick %u (local %08x, remote %08x)\n",
+                         tick, e.localChecksum, e.remoteChecksum);
+            desync = true;
+        }
+    }
+}
+
+void NetSession::sendPacket(const std::vector<unsigned char>& bytes) {
+    ++counters.packetsSent;
+    counters.bytesSent += (unsigned int)bytes.size();
+    lastSent = Clock::now();
+    if (lagDelay == 0 && lagLoss == 0) {
+        socket.send(peer, bytes.data(), (int)bytes.size());
+        return;
+    }
+    if ((int)lagRng.below(100) < lagLoss) {
+        return;
+    }
+    int jitter = lagJitter > 0 ? (int)lagRng.below((uint32_t)(2 * lagJitter + 1)) - lagJitter : 0;
+    DelayedPacket d;
+    d.releaseTick = wallTicks + (unsigned int)(lagDelay + jitter);
+    d.bytes = bytes;
+    delayed.push_back(d);
+}
+
+void NetSession::flushDelayed() {
+    size_t kept = 0;
+    for (size_t i = 0; i < delayed.size(); ++i) {
+        if (delayed[i].releaseTick <= wallTicks) {
+            socket.send(peer, delayed[i].bytes.data(), (int)delayed[i].bytes.size());
+        } else {
+            if (kept != i) delayed[kept] = std::move(delayed[i]);
+            ++kept;
+        }
+    }
+    delayed.resize(kept);
+}
+
+void NetSession::sendHello() {
+    beginPacket(packet, PACKET_HELLO);
+    putU32(packet, NetVersion);
+    // Handshake packets skip the simulated lag: it is counted in ticks, and
+    // there are no ticks before the match starts
+    socket.send(peer, packet.data(), (int)packet.size());
+    ++counters.packetsSent;
+    counters.bytesSent += (unsigned int)packet.size();
+    lastSent = Clock::now();
+}
+
+void NetSession::sendWelcome() {
+    beginPacket(packet, PACKET_WELCOME);
+    putU32(packet, NetVersion);
+    putU32(packet, matchSeed);
+    putU32(packet, (unsigned int)rate);
+    putMatchConfig(packet, cfg);
+    socket.send(peer, packet.data(), (int)packet.size());
+    ++counters.packetsSent;
+    counters.bytesSent += (unsigned int)packet.size();
+}
+
+void NetSession::sendInputs() {
+    unsigned int first = peerAck;
+    unsigned int count = localLatest > first ? localLatest - first : 0;
+    if (count > (unsigned int)MaxInputsPerPacket) count = MaxInputsPerPacket;
+
+    beginPacket(packet, PACKET_INPUT);
+    putU32(packet, currentFrame);
+    putU32(packet, (unsigned int)localAdvantage());
+    putU32(packet, remoteContiguous);
+    putU32(packet, lastSyncTick);
+    putU32(packet, lastSyncChecksum);
+    putU32(packet, first);
+    packet.push_back((unsigned char)count);
+    for (unsigned int i = 0; i < count; ++i) {
+        putPaddleInput(packet, localInputs[(first + i) % InputRing]);
+    }
+    sendPacket(packet);
+}
+
+void NetSession::receivePackets() {
+    NetAddress from;
+    for (;;) {
+        incoming.resize(MaxPacketBytes);
+        int n = socket.receive(incoming.data(), MaxPacketBytes, from);
+        if (n <= 0) {
+            break;
+        }
+        incoming.resize((size_t)n);
+        ++counters.packetsReceived;
+        counters.bytesReceived += (unsigned int)n;
+        handlePacket(from, incoming);
+    }
+    if (connected && !lost && msSince(lastHeard) > PeerTimeoutMs) {
+        std::fprintf(stderr, "Netplay: no word from the other player for %d s\n", PeerTimeoutMs / 1000);
+        lost = true;
+    }
+}
+
+void NetSession::handlePacket(const NetAddress& from, const std::vector<unsigned char>& bytes) {
+    if (bytes.size() < 5 || std::memcmp(bytes.data(), NetMagic, 4) != 0) {
+        return;
+    }
+    unsigned char type = bytes[4];
+    // A host takes the first HELLO it gets; everyone else is ignored after that
+    bool fromPeer = havePeer && sameAddress(from, peer);
+    if (!fromPeer && !(hosting && !havePeer && type == PACKET_HELLO)) {
+        return;
+    }
+
+    size_t pos = 5;
+    ByteReader in{ bytes, pos };
+    switch (type) {
+    case PACKET_HELLO: {
+        if (!hosting) return;
+        unsigned int version = in.u32();
+        if (!in.ok || version != NetVersion) {
+            std::fprintf(stderr, "Netplay: ignoring a client with protocol version %u (expected %u)\n",
+                         version, NetVersion);
+            return;
+        }
+        if (!havePeer) {
+            peer = from;
+            havePeer = true;
+            connected = true;
+            std::printf("Netplay: player joined from %u.%u.%u.%u:%u\n", (from.ip >> 24) & 255,
+                        (from.ip >> 16) & 255, (from.ip >> 8) & 255, from.ip & 255, (unsigned)from.port);
+        }
+        // Also answers repeats, in case the first WELCOME was lost
+        sendWelcome();
+        break;
+    }
+    case PACKET_WELCOME: {
+        if (hosting || connected) break;
+        unsigned int version = in.u32();
+        unsigned int seed = in.u32();
+        unsigned int tickRate = in.u32();
+        MatchConfig rules = {};
+        in.config(rules);
+        if (!in.ok || version != NetVersion) {
+            std::fprintf(stderr, "Netplay: host speaks protocol version %u (expected %u)\n", version, NetVersion);
+            lost = true;
+            return;
+        }
+        if (tickRate < (unsigned int)MinTickRate || tickRate > (unsigned int)MaxTickRate || !validMatchConfig(rules)) {
+            std::fprintf(stderr, "Netplay: host sent invalid match settings (%u Hz, %dx%d, %d balls)\n",
+                         tickRate, rules.width, rules.height, rules.ballCount);
+            lost = true;
+            return;
+        }
+        matchSeed = seed;
+        rate = (int)tickRate;
+        cfg = rules;
+        connected = true;
+        std::printf("Netplay: joined, %d Hz, seed %08x\n", rate, matchSeed);
+        break;
+    }
+    case PACKET_INPUT:
+        if (connected) handleInputs(bytes, pos);
+        break;
+    case PACKET_BYE:
+        if (connected && !lost) std::printf("Netplay: the other player left\n");
+        lost = true;
+        break;
+    default:
+        return;
+    }
+    lastHeard = Clock::now();
+}
+
+void NetSession::handleInputs(const std::vector<unsigned char>& bytes, std::size_t pos) {
+    ByteReader in{ bytes, pos };
+    unsigned int frame = in.u32();
+    int advantage = (int)in.u32();
+    unsigned int ack = in.u32();
+    unsigned int syncTick = in.u32();
+    unsigned int syncChecksum = in.u32();
+    unsigned int first = in.u32();
+    unsigned int count = in.u8();
+    if (!in.ok || count > (unsigned int)MaxInputsPerPacket) {
+        return;
+    }
+    PaddleInput inputs[MaxInputsPerPacket];
+    for (unsigned int i = 0; i < count; ++i) {
+        in.paddleInput(inputs[i]);
+    }
+    if (!in.ok) {
+        return;
+    }
+
+    // Packets can arrive out of order; only ever move forward
+    if (frame >= peerFrame) {
+        peerFrame = frame;
+        peerAdvantage = advantage;
+    }
+    if (ack > peerAck && ack <= localLatest) peerAck = ack;
+    for (unsigned int i = 0; i < count; ++i) {
+        storeRemoteInput(first + i, inputs[i]);
+    }
+    if (syncTick != 0) {
+        noteSync(syncTick, syncChecksum, true);
+    }
+}
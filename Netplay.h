@@ -0,0 +1,216 @@
+#pragma once
+#include "Simulation.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Online two-player matches with rollback. Each peer runs the whole simulation
+// itself and only inputs cross the wire: the local input is scheduled a couple
+// of ticks ahead (input delay), the remote paddle is predicted by repeating its
+// last known input, and when the real input turns out to differ the session
+// restores the snapshot from before that tick and re-simulates up to the
+// present. Headless like Simulation and Replay: no SDL, plain UDP sockets.
+//
+// Packets, little-endian, all prefixed with "PPNP" u8 type:
+//   HELLO   (client -> host) u32 version
+//   WELCOME (host -> client) u32 version, u32 seed, u32 tickRate, config
+//   INPUT   u32 frame, i32 advantage, u32 ack, u32 syncTick, u32 syncChecksum,
+//           u32 firstTick, u8 count, count x paddle input (replay encoding)
+//   BYE     no payload
+// Every INPUT packet repeats all of the sender's inputs the peer has not
+// acknowledged yet, so a lost packet costs nothing but a later correction.
+
+static const unsigned short NetDefaultPort = 7777;
+
+// IPv4 address and port, both in host byte order
+struct NetAddress {
+    uint32_t ip;
+    unsigned short port;
+};
+
+// "host" or "host:port" (numeric or resolvable name); false if it can't be resolved
+bool parseNetAddress(const char* text, unsigned short defaultPort, NetAddress& out);
+
+// Non-blocking IPv4 UDP socket (BSD sockets or Winsock)
+class UdpSocket {
+public:
+    UdpSocket() = default;
+    ~UdpSocket() { close(); }
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    bool open(unsigned short port);    // 0 = any free port
+    void close();
+    bool isOpen() const { return handle != InvalidHandle; }
+    unsigned short localPort() const { return boundPort; }
+
+    bool send(const NetAddress& to, const void* data, int size);
+    // Bytes read, 0 when nothing is waiting, -1 on error
+    int receive(void* buffer, int capacity, NetAddress& from);
+
+private:
+    static const intptr_t InvalidHandle = -1;
+    intptr_t handle = InvalidHandle;
+    unsigned short boundPort = 0;
+};
+
+class NetSession {
+public:
+    // How far the local simulation may run past the last confirmed remote
+    // input; every rollback re-simulates at most this many ticks
+    static const int MaxPrediction = 12;
+    static const int MaxInputDelay = 4;
+
+    NetSession() = default;
+    ~NetSession() { close(); }
+    NetSession(const NetSession&) = delete;
+    NetSession& operator=(const NetSession&) = delete;
+
+    // The host plays the left paddle, picks the seed and owns the rules: cfg
+    // is sent to the client and used unchanged for the whole match
+    bool host(unsigned short port, unsigned int seed, int tickRate, const MatchConfig& cfg);
+    bool join(const NetAddress& hostAddress);
+    void close();                      // tells the peer, then drops the socket
+
+    // Local ticks of input delay, clamped to [0, MaxInputDelay]
+    void setInputDelay(int ticks);
+    // Testing aid: hold every outgoing input packet for delay +/- jitter ticks
+    // and drop lossPercent of them, so rollbacks show up on loopback. The
+    // jitter and loss draws come from `seed`, so a run that desyncs can be
+    // repeated.
+    void setSimulatedLag(int delayTicks, int jitterTicks, int lossPercent, unsigned int seed = 1);
+
+    // Handshake; call every frame until it returns true. The client learns
+    // the seed, tick rate and rules from the host here.
+    bool poll();
+    bool isOpen() const { return socket.isOpen(); }
+    unsigned short localPort() const { return socket.localPort(); }
+    bool isConnected() const { return connected; }
+    bool isHost() const { return hosting; }
+    int localSide() const { return hosting ? 1 : 2; }
+    unsigned int seed() const { return matchSeed; }
+    int tickRate() const { return rate; }
+    const MatchConfig& config() const { return cfg; }
+
+    // resetMatch with the agreed seed and rules
+    void startMatch(MatchState& s);
+
+    // One tick. Sends the local input, applies whatever arrived (rolling back
+    // and re-simulating if a prediction was wrong), then steps s by dt. Returns
+    // false without touching s while it has to wait for the peer: too far
+    // ahead of the last confirmed input, or letting a lagging peer catch up.
+    //
+    // `events` gets every event this call raised that no earlier call reported:
+    // all of the new tick's, plus whatever re-simulated ticks raised that their
+    // earlier run did not (same kind, side and ball counts as the same event).
+    // Events a rollback took back were reported already and are not retracted.
+    bool advance(MatchState& s, const PaddleInput& local, float dt, SimEvents* events = nullptr);
+
+    // Ticks simulated so far; every tick before confirmedFrame() used real
+    // inputs from both sides and can no longer change
+    unsigned int frame() const { return currentFrame; }
+    unsigned int confirmedFrame() const;
+    // Winner as of confirmedFrame(), given the live state s: unlike s.winner,
+    // no rollback can take it back. 0 = no winner yet.
+    int confirmedWinner(const MatchState& s) const;
+
+    // Peer went quiet for longer than the timeout, or said goodbye
+    bool peerLost() const { return lost; }
+    // Both peers checksum their confirmed states; true once two disagreed
+    bool desynced() const { return desync; }
+
+    struct Stats {
+        unsigned int rollbacks;        // corrections applied
+        unsigned int resimulatedTicks;
+        unsigned int lateEvents;       // reported from re-simulated ticks only
+        int maxRollback;               // deepest correction, in ticks
+        double maxRollbackMs;          // slowest restore + re-simulate
+        unsigned int stallTicks;       // advance() calls that had to wait
+        unsigned int packetsSent, packetsReceived;
+        unsigned int bytesSent, bytesReceived;
+        unsigned int syncChecks;       // confirmed checksums compared with the peer
+    };
+    const Stats& stats() const { return counters; }
+
+private:
+    static const int InputRing = 64;               // power of two, > MaxPrediction + MaxInputDelay + packet window
+    static const int SnapshotDepth = MaxPrediction + 2;
+    static const int SyncInterval = 16;            // checksum every Nth confirmed tick
+    static const int SyncRing = 32;
+    static const int MaxInputsPerPacket = 32;
+
+    enum PacketType { PACKET_HELLO = 1, PACKET_WELCOME, PACKET_INPUT, PACKET_BYE };
+
+    struct SyncEntry {
+        unsigned int tick;
+        unsigned int localChecksum, remoteChecksum;
+        bool haveLocal, haveRemote;
+    };
+
+    struct DelayedPacket {
+        unsigned int releaseTick;          // wallTicks
+        std::vector<unsigned char> bytes;
+    };
+
+    void reset();
+    void sendPacket(const std::vector<unsigned char>& bytes);
+    void flushDelayed();
+    void sendHello();
+    void sendWelcome();
+    void sendInputs();
+    void receivePackets();
+    void handlePacket(const NetAddress& from, const std::vector<unsigned char>& bytes);
+    void handleInputs(const std::vector<unsigned char>& bytes, std::size_t pos);
+    void storeRemoteInput(unsigned int tick, const PaddleInput& in);
+    PaddleInput remoteInputFor(unsigned int tick) const;
+    void simulateTick(MatchState& s, unsigned int tick, float dt, SimEvents* events);
+    void recordSyncChecksums(const MatchState& s);
+    void noteSync(unsigned int tick, unsigned int checksum, bool fromRemote);
+    int localAdvantage() const { return (int)(currentFrame - peerFrame); }
+    bool shouldYield();
+
+    UdpSocket socket;
+    NetAddress peer = {};
+    bool hosting = false;
+    bool havePeer = false;
+    bool connected = false;
+    bool lost = false;
+    bool desync = false;
+
+    unsigned int matchSeed = 0;
+    int rate = 0;
+    MatchConfig cfg = {};
+    int inputDelay = 2;
+
+    unsigned int currentFrame = 0;
+    unsigned int localLatest = 0;                  // local inputs are scheduled below this tick
+    unsigned int wallTicks = 0;                    // advance() calls, waiting or not
+    PaddleInput localInputs[InputRing] = {};       // by tick; written inputDelay ahead
+    PaddleInput remoteInputs[InputRing] = {};      // by tick, once known
+    unsigned int remoteTicks[InputRing] = {};      // tick + 1 stored in each slot, 0 = empty
+    PaddleInput usedRemote[InputRing] = {};        // what the last simulation of each tick assumed
+    unsigned int remoteContiguous = 0;             // every remote input below this is known
+    unsigned int remoteLatest = 0;                 // highest remote tick + 1 seen
+    unsigned int peerAck = 0;                      // the peer has our inputs below this
+    unsigned int peerFrame = 0;                    // the peer's frame when it last sent
+    int peerAdvantage = 0;                         // how far ahead the peer thinks it is
+    unsigned int rollbackFrom = 0;                 // earliest mispredicted tick, or currentFrame if none
+    unsigned int lastYieldTick = 0;                // wallTicks at the last time-sync wait
+
+    SnapshotRing snapshots;                        // state at the start of each recent tick
+    SimEvents reported[SnapshotDepth] = {};        // by tick: events advance() has handed out
+    SyncEntry syncs[SyncRing] = {};
+    unsigned int nextSyncTick = SyncInterval;
+    unsigned int lastSyncTick = 0;                 // newest local confirmed checksum, 0 = none yet
+    unsigned int lastSyncChecksum = 0;
+
+    Rng lagRng = {};
+    int lagDelay = 0, lagJitter = 0, lagLoss = 0;
+    std::vector<DelayedPacket> delayed;
+    std::vector<unsigned char> packet;             // send scratch
+    std::vector<unsigned char> incoming;           // receive scratch
+
+    std::chrono::steady_clock::time_point lastHeard;
+    std::chrono::steady_clock::time_point lastSent;
+    Stats counters = {};
+};
@@ -1,5 +1,5 @@
 #include "Paddle.h"
-#include "SDL3/SDL_opengl.h"
+#include "Renderer.h"
 
 Paddle::Paddle(float x_, float y_, int w, int h, float speed_,
                SDL_Scancode up, SDL_Scancode down,
@@ -11,38 +11,8 @@ Paddle::Paddle(float x_, float y_, int w, int h, float speed_,
     colorB = 1.0f;
 }
 
-void Paddle::handleInput(const bool* keyState, bool freeMove) {
-    vy = 0.0f;
-    vx = 0.0f;
-    if (keyState[upKey])   vy -= speed;
-    if (keyState[downKey]) vy += speed;
-    if (freeMove) {
-        if (keyState[leftKey])  vx -= speed;
-        if (keyState[rightKey]) vx += speed;
-    }
-}
-
-void Paddle::setVerticalSpeed(float v) {
-    vy = v;
-}
-
-void Paddle::setHorizontalSpeed(float v) {
-    vx = v;
-}
-
-void Paddle::move(double dt, int screenH, bool freeMove, float xMin, float xMax) {
-    y += vy * (float)dt;
-    if (y < 0.0f) y = 0.0f;
-    if (y > (float)(screenH - height)) y = (float)(screenH - height);
-
-    if (freeMove) {
-        x += vx * (float)dt;
-        if (x < xMin) x = xMin;
-        if (x > xMax) x = xMax;
-    }
-}
-
 void Paddle::render() const {
+    Renderer& gfx = Renderer::getInstance();
     float zFront = -10.0f;
     float zBack  = 0.0f;
 
@@ -65,59 +35,59 @@ void Paddle::render() const {
     float mg = colorG * 0.7f;
     float mb = colorB * 0.8f;
 
-    glBegin(GL_QUADS);
+    gfx.begin(GL_QUADS);
     // Front face
-    glColor4f(br, bg, bb, 1.0f);
-    glVertex3f(x0, y0, zFront);
-    glVertex3f(x1, y0, zFront);
-    glVertex3f(x1, y1, zFront);
-    glVertex3f(x0, y1, zFront);
+    gfx.color(br, bg, bb, 1.0f);
+    gfx.vertex(x0, y0, zFront);
+    gfx.vertex(x1, y0, zFront);
+    gfx.vertex(x1, y1, zFront);
+    gfx.vertex(x0, y1, zFront);
 
     // Back face
-    glColor4f(dr, dg, db, 1.0f);
-    glVertex3f(x0, y0, zBack);
-    glVertex3f(x0, y1, zBack);
-    glVertex3f(x1, y1, zBack);
-    glVertex3f(x1, y0, zBack);
+    gfx.color(dr, dg, db, 1.0f);
+    gfx.vertex(x0, y0, zBack);
+    gfx.vertex(x0, y1, zBack);
+    gfx.vertex(x1, y1, zBack);
+    gfx.vertex(x1, y0, zBack);
 
     // Left side
     if (isLeftPaddle) {
         // Outer side on the left paddle: slightly darker
-        glColor4f(dr, dg, db, 1.0f);
+        gfx.color(dr, dg, db, 1.0f);
     } else {
         // Inner side on the right paddle (toward center): brighter
-        glColor4f(br, bg, bb, 1.0f);
+        gfx.color(br, bg, bb, 1.0f);
     }
-    glVertex3f(x0, y0, zBack);
-    glVertex3f(x0, y0, zFront);
-    glVertex3f(x0, y1, zFront);
-    glVertex3f(x0, y1, zBack);
+    gfx.vertex(x0, y0, zBack);
+    gfx.vertex(x0, y0, zFront);
+    gfx.vertex(x0, y1, zFront);
+    gfx.vertex(x0, y1, zBack);
 
     // Right side
     if (isLeftPaddle) {
         // Inner side on the left paddle (toward center): brighter
-        glColor4f(br, bg, bb, 1.0f);
+        gfx.color(br, bg, bb, 1.0f);
     } else {
         // Outer side on the right paddle: slightly darker
-        glColor4f(dr, dg, db, 1.0f);
+        gfx.color(dr, dg, db, 1.0f);
     }
-    glVertex3f(x1, y0, zFront);
-    glVertex3f(x1, y0, zBack);
-    glVertex3f(x1, y1, zBack);
-    glVertex3f(x1, y1, zFront);
+    gfx.vertex(x1, y0, zFront);
+    gfx.vertex(x1, y0, zBack);
+    gfx.vertex(x1, y1, zBack);
+    gfx.vertex(x1, y1, zFront);
 
     // Top
-    glColor4f(mr, mg, mb, 1.0f);
-    glVertex3f(x0, y0, zBack);
-    glVertex3f(x1, y0, zBack);
-    glVertex3f(x1, y0, zFront);
-    glVertex3f(x0, y0, zFront);
+    gfx.color(mr, mg, mb, 1.0f);
+    gfx.vertex(x0, y0, zBack);
+    gfx.vertex(x1, y0, zBack);
+    gfx.vertex(x1, y0, zFront);
+    gfx.vertex(x0, y0, zFront);
 
     // Bottom
-    glColor4f(dr, dg, db, 1.0f);
-    glVertex3f(x0, y1, zFront);
-    glVertex3f(x1, y1, zFront);
-    glVertex3f(x1, y1, zBack);
-    glVertex3f(x0, y1, zBack);
-    glEnd();
+    gfx.color(dr, dg, db, 1.0f);
+    gfx.vertex(x0, y1, zFront);
+    gfx.vertex(x1, y1, zFront);
+    gfx.vertex(x1, y1, zBack);
+    gfx.vertex(x0, y1, zBack);
+    gfx.end();
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "ParticleSystem.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PARTICLE_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define PARTICLE_HAVE_SSE2 0
+#endif
+
+ParticleSystem::ParticleSystem(int capacity)
+    : maxCount(capacity > 0 ? capacity : 1) {
+    stride = (maxCount + 3) & ~3;
+    storage.assign((size_t)stride * FieldCount, 0.0f);
+
+    float* base = storage.data();
+    float** fields[FieldCount] = { &x, &y, &vx, &vy, &ax, &ay, &angle, &spin,
+                                   &life, &maxLife, &size, &r, &g, &b };
+    for (int i = 0; i < FieldCount; ++i) {
+        *fields[i] = base + (size_t)i * stride;
+    }
+}
+
+int ParticleSystem::spawn() {
+    if (liveCount >= maxCount) return -1;
+    int i = liveCount++;
+    for (int f = 0; f < FieldCount; ++f) {
+        storage[(size_t)f * stride + i] = 0.0f;
+    }
+    return i;
+}
+
+void ParticleSystem::moveParticle(int from, int to) {
+    for (int f = 0; f < FieldCount; ++f) {
+        storage[(size_t)f * stride + to] = storage[(size_t)f * stride + from];
+    }
+}
+
+void ParticleSystem::integrate(float dt) {
+    const int n = liveCount;
+    int i = 0;
+#if PARTICLE_HAVE_SSE2
+    const __m128 d = _mm_set1_ps(dt);
+    for (; i + 4 <= n; i += 4) {
+        __m128 nvx = _mm_add_ps(_mm_loadu_ps(vx + i), _mm_mul_ps(_mm_loadu_ps(ax + i), d));
+        __m128 nvy = _mm_add_ps(_mm_loadu_ps(vy + i), _mm_mul_ps(_mm_loadu_ps(ay + i), d));
+        _mm_storeu_ps(vx + i, nvx);
+        _mm_storeu_ps(vy + i, nvy);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(nvx, d)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(nvy, d)));
+        _mm_storeu_ps(angle + i, _mm_add_ps(_mm_loadu_ps(angle + i), _mm_mul_ps(_mm_loadu_ps(spin + i), d)));
+    }
+#endif
+    for (; i < n; ++i) {
+        vx[i] += ax[i] * dt;
+        vy[i] += ay[i] * dt;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        angle[i] += spin[i] * dt;
+    }
+}
+
+void ParticleSystem::age(float dt) {
+    int n = liveCount;
+
+    // Advance every life, and note whether anything expired at all
+    int i = 0;
+    bool anyDead = false;
+#if PARTICLE_HAVE_SSE2
+    const __m128 d = _mm_set1_ps(dt);
+    __m128 dead = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        __m128 l = _mm_add_ps(_mm_loadu_ps(life + i), d);
+        _mm_storeu_ps(life + i, l);
+        dead = _mm_or_ps(dead, _mm_cmpge_ps(l, _mm_loadu_ps(maxLife + i)));
+    }
+    anyDead = _mm_movemask_ps(dead) != 0;
+#endif
+    for (; i < n; ++i) {
+        life[i] += dt;
+        anyDead |= life[i] >= maxLife[i];
+    }
+    if (!anyDead) return;
+
+    // Swap-remove, walking down so the particle moved into a hole was already checked
+    for (i = n - 1; i >= 0; --i) {
+        if (life[i] >= maxLife[i]) {
+            --n;
+            if (i != n) moveParticle(n, i);
+        }
+    }
+    liveCount = n;
+}
+
+void ParticleSystem::drawFadingSquares(float alphaScale) {
+    if (liveCount == 0) return;
+    instances.resize(liveCount);
+    for (int i = 0; i < liveCount; ++i) {
+        float t = 1.0f - life[i] / maxLife[i];
+        RenderInstance& inst = instances[i];
+        inst.x = x[i];
+        inst.y = y[i];
+        inst.sizeX = inst.sizeY = size[i] * t;
+        inst.angle = 0.0f;
+        inst.setColor(r[i], g[i], b[i], t * alphaScale);
+    }
+    Renderer::getInstance().drawInstances(SHAPE_QUAD, instances.data(), liveCount);
+}
+
+void ParticleSystem::drawSpinningShards() {
+    if (liveCount == 0) return;
+    instances.resize(liveCount);
+    for (int i = 0; i < liveCount; ++i) {
+        float alpha = 1.0f - life[i] / maxLife[i];
+        RenderInstance& inst = instances[i];
+        inst.x = x[i];
+        inst.y = y[i];
+        inst.sizeX = inst.sizeY = size[i] * 0.5f;
+        inst.angle = angle[i];
+        inst.setColor(r[i], g[i], b[i], alpha * alpha);
+    }
+    Renderer::getInstance().drawInstances(SHAPE_QUAD, instances.data(), liveCount);
+}
+
+void ParticleSystem::drawRisingStreaks(float streakWidth, float streakHeight, float alphaScale) {
+    if (liveCount == 0) return;
+    instances.resize(liveCount);
+    for (int i = 0; i < liveCount; ++i) {
+        RenderInstance& inst = instances[i];
+        inst.x = x[i];
+        inst.y = y[i];
+        inst.sizeX = streakWidth;
+        inst.sizeY = streakHeight;
+        inst.angle = 0.0f;
+        inst.setColor(r[i], g[i], b[i], (1.0f - life[i] / maxLife[i]) * alphaScale);
+    }
+    Renderer::getInstance().drawInstances(SHAPE_STREAK, instances.data(), liveCount);
+}
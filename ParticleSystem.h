@@ -0,0 +1,60 @@
+#pragma once
+#include "Renderer.h"
+#include <vector>
+
+// Structure-of-arrays particle pool used by the boost trails and the lose
+// screen shards/wisps. Every attribute is its own contiguous float array, so
+// integrate() and age() are straight SIMD loops; dead particles are
+// swap-removed, keeping [0, count()) live with no `active` flags to skip.
+// Each draw call submits the whole pool as one instanced shape draw.
+class ParticleSystem {
+public:
+    explicit ParticleSystem(int capacity);
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    // Index of a fresh particle with every attribute zeroed, or -1 when full
+    int spawn();
+    void clear() { liveCount = 0; }
+    int count() const { return liveCount; }
+    int capacity() const { return maxCount; }
+
+    // v += a * dt; p += v * dt; angle += spin * dt
+    void integrate(float dt);
+    // life += dt, then swap-remove everything with life >= maxLife
+    void age(float dt);
+
+    // Axis-aligned squares shrinking with remaining life; alpha = remaining * alphaScale
+    void drawFadingSquares(float alphaScale);
+    // Squares of side `size` rotated by angle; alpha = (1 - life/maxLife)^2
+    void drawSpinningShards();
+    // Vertical streaks rising from (x, y), transparent at the base
+    void drawRisingStreaks(float streakWidth, float streakHeight, float alphaScale);
+
+    // Attribute arrays, valid for [0, count())
+    float* x;
+    float* y;
+    float* vx;
+    float* vy;
+    float* ax;
+    float* ay;
+    float* angle;
+    float* spin;
+    float* life;       // seconds lived
+    float* maxLife;
+    float* size;
+    float* r;
+    float* g;
+    float* b;
+
+private:
+    static const int FieldCount = 14;
+
+    void moveParticle(int from, int to);
+
+    std::vector<float> storage;
+    std::vector<RenderInstance> instances;   // draw scratch, one record per particle
+    int maxCount;
+    int stride;        // floats per field, rounded up for whole SIMD blocks
+    int liveCount = 0;
+};
@@ -0,0 +1,116 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static const char* const kZoneNames[PROFILE_ZONE_COUNT] = {
+    "frame", "events", "update", "sim", "ai", "ball", "particles",
+    "render", "world", "hud", "menu", "swap", "gpu"
+};
+
+Profiler& Profiler::getInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler() = default;
+
+const char* Profiler::zoneName(ProfileZone zone) {
+    return kZoneNames[zone];
+}
+
+void Profiler::setEnabled(bool on) {
+    if (on == enabled) {
+        return;
+    }
+    enabled = on;
+    if (enabled) {
+        if (history.empty()) {
+            history.assign((size_t)HistoryFrames * PROFILE_ZONE_COUNT, 0.0f);
+            sortScratch.reserve(StatsFrames);
+        }
+        std::memset(zoneNs, 0, sizeof(zoneNs));
+        // Zones already open (the toggle usually comes from inside PROFILE_EVENTS)
+        // were begun as no-ops; count them from here, like the frame itself
+        frameStart = now();
+        for (int z = 0; z < PROFILE_ZONE_COUNT; ++z) {
+            zoneStart[z] = frameStart;
+        }
+    }
+}
+
+void Profiler::endFrame() {
+    if (!enabled) {
+        return;
+    }
+    long long t = now();
+    zoneNs[PROFILE_FRAME] = t - frameStart;
+    frameStart = t;
+
+    float* row = &history[(size_t)(frameCount % HistoryFrames) * PROFILE_ZONE_COUNT];
+    for (int z = 0; z < PROFILE_ZONE_COUNT; ++z) {
+        row[z] = (float)((double)zoneNs[z] * 1.0e-6);
+        zoneNs[z] = 0;
+    }
+    ++frameCount;
+
+    if (frameCount % StatsInterval == 0) {
+        refreshStats();
+    }
+}
+
+void Profiler::refreshStats() {
+    int n = frameCount < StatsFrames ? frameCount : StatsFrames;
+    if (n == 0) {
+        return;
+    }
+    for (int z = 0; z < PROFILE_ZONE_COUNT; ++z) {
+        sortScratch.clear();
+        double sum = 0.0;
+        for (int i = frameCount - n; i < frameCount; ++i) {
+            float ms = history[(size_t)(i % HistoryFrames) * PROFILE_ZONE_COUNT + z];
+            sortScratch.push_back(ms);
+            sum += ms;
+        }
+        // p99 = the value 99% of the window sits at or below
+        int p99 = (n * 99 + 99) / 100 - 1;
+        std::nth_element(sortScratch.begin(), sortScratch.begin() + p99, sortScratch.end());
+
+        ProfileStats& st = zoneStats[z];
+        st.p99Ms = sortScratch[p99];
+        st.minMs = *std::min_element(sortScratch.begin(), sortScratch.end());
+        st.avgMs = (float)(sum / n);
+        st.lastMs = history[(size_t)((frameCount - 1) % HistoryFrames) * PROFILE_ZONE_COUNT + z];
+    }
+}
+
+bool Profiler::writeCsv(const char* path) const {
+    std::FILE* f = std::fopen(path, "w");
+    if (!f) {
+        std::fprintf(stderr, "Profiler: cannot write '%s'\n", path);
+        return false;
+    }
+
+    std::fprintf(f, "frame");
+    for (int z = 0; z < PROFILE_ZONE_COUNT; ++z) {
+        std::fprintf(f, ",%s_ms", kZoneNames[z]);
+    }
+    std::fprintf(f, "\n");
+
+    int first = frameCount > HistoryFrames ? frameCount - HistoryFrames : 0;
+    for (int i = first; i < frameCount; ++i) {
+        const float* row = &history[(size_t)(i % HistoryFrames) * PROFILE_ZONE_COUNT];
+        std::fprintf(f, "%d", i);
+        for (int z = 0; z < PROFILE_ZONE_COUNT; ++z) {
+            std::fprintf(f, ",%.3f", row[z]);
+        }
+        std::fprintf(f, "\n");
+    }
+
+    bool ok = std::ferror(f) == 0;
+    std::fclose(f);
+    if (ok) {
+        std::fprintf(stderr, "Profiler: wrote %d frames to %s\n", frameCount - first, path);
+    }
+    return ok;
+}
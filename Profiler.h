@@ -0,0 +1,106 @@
+#pragma once
+#include <chrono>
+#include <vector>
+
+// Frame-time profiler. Scoped CPU timers add into per-frame zone totals (a
+// zone entered several times in a frame, like AI over several ticks, sums);
+// endFrame() files the totals into a history ring that the overlay
+// summarises and that is dumped as CSV. Zones nest, so each total is
+// inclusive of the zones inside it. No SDL or GL here: the simulation is
+// instrumented too and stays headless.
+enum ProfileZone {
+    PROFILE_FRAME = 0,    // endFrame to endFrame
+    PROFILE_EVENTS,       // event polling + loader finish steps
+    PROFILE_UPDATE,       // Game::update
+    PROFILE_SIM,          //   fixed ticks
+    PROFILE_AI,           //     AI paddle steering
+    PROFILE_BALL,         //     ball motion and collisions
+    PROFILE_PARTICLES,    //   particle integrate/age/emit
+    PROFILE_RENDER,       // Game::render through Renderer::endFrame
+    PROFILE_WORLD,        //   3D pass and field effects
+    PROFILE_HUD,          //   scores, meters, labels
+    PROFILE_MENU,         //   menus and win/lose screen
+    PROFILE_SWAP,         // SDL_GL_SwapWindow (includes vsync wait)
+    PROFILE_GPU,          // GL timer query; lags the CPU zones by a few frames
+    PROFILE_ZONE_COUNT
+};
+
+struct ProfileStats {
+    float minMs;
+    float avgMs;
+    float p99Ms;
+    float lastMs;
+};
+
+class Profiler {
+public:
+    static Profiler& getInstance();
+
+    static const char* zoneName(ProfileZone zone);
+
+    // Nothing is timed or recorded while disabled; begin/end are a branch.
+    // Safe to call mid-frame: the first frame recorded starts at the call.
+    void setEnabled(bool on);
+    bool isEnabled() const { return enabled; }
+
+    void begin(ProfileZone zone) {
+        if (enabled) zoneStart[zone] = now();
+    }
+    void end(ProfileZone zone) {
+        if (enabled) zoneNs[zone] += now() - zoneStart[zone];
+    }
+    // For measurements that arrive as a value (GPU time)
+    void record(ProfileZone zone, double ms) {
+        if (enabled) zoneNs[zone] += (long long)(ms * 1.0e6);
+    }
+
+    // Close the current frame; also times PROFILE_FRAME between calls
+    void endFrame();
+
+    // Over the last StatsFrames frames, refreshed every StatsInterval frames
+    const ProfileStats& stats(ProfileZone zone) const { return zoneStats[zone]; }
+    int recordedFrames() const { return frameCount; }
+
+    // Every frame still in the history ring, oldest first, in milliseconds
+    bool writeCsv(const char* path) const;
+
+private:
+    Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    static long long now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    void refreshStats();
+
+    static const int HistoryFrames = 18000;   // ~5 minutes at 60 Hz
+    static const int StatsFrames = 240;
+    static const int StatsInterval = 30;
+
+    bool enabled = false;
+    long long zoneStart[PROFILE_ZONE_COUNT] = {};
+    long long zoneNs[PROFILE_ZONE_COUNT] = {};
+    long long frameStart = 0;
+
+    std::vector<float> history;   // HistoryFrames rows of PROFILE_ZONE_COUNT ms values
+    int frameCount = 0;           // frames recorded since enabling (may exceed the ring)
+    ProfileStats zoneStats[PROFILE_ZONE_COUNT] = {};
+    std::vector<float> sortScratch;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileZone z) : zone(z) { Profiler::getInstance().begin(zone); }
+    ~ProfileScope() { Profiler::getInstance().end(zone); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileZone zone;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(zone) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(zone)
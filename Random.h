@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+// PCG32 (XSH-RR output on a 64-bit LCG): 16 bytes of plain data, a few
+// cycles per draw and no locks, unlike std::rand. The increment picks one of
+// 2^63 independent streams, so every subsystem gets its own generator and
+// draws in one can never shift the sequence another sees.
+enum RngStream {
+    RNG_STREAM_GAMEPLAY = 1,   // MatchState: serves and pickup spawns
+    RNG_STREAM_COSMETIC = 2,   // Game: particles, shards, colors
+    RNG_STREAM_NETLAG = 3      // NetSession: simulated packet loss and jitter
+};
+
+struct Rng {
+    uint64_t state;
+    uint64_t inc;              // always odd
+
+    void seed(uint64_t seedValue, uint64_t stream) {
+        state = 0;
+        inc = (stream << 1) | 1u;
+        next();
+        state += seedValue;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ull + inc;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        uint32_t rot = (uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    // Uniform in [0, n), multiply-shift instead of a modulo
+    uint32_t below(uint32_t n) { return (uint32_t)(((uint64_t)next() * n) >> 32); }
+
+    // Uniform in [0, 1), 24 random bits
+    float nextFloat() { return (float)(next() >> 8) * (1.0f / 16777216.0f); }
+    float range(float lo, float hi) { return lo + (hi - lo) * nextFloat(); }
+};
@@ -0,0 +1,52 @@
+#include "RenderMath.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const int SineTableSize = 1024;   // power of two, so wrapping is a mask
+
+struct SineTable {
+    float values[SineTableSize + 1];
+    SineTable() {
+        for (int i = 0; i <= SineTableSize; ++i) {
+            values[i] = (float)std::sin((double)i / SineTableSize * 6.283185307179586);
+        }
+    }
+};
+
+const SineTable& sineTable() {
+    static const SineTable table;
+    return table;
+}
+
+} // namespace
+
+float fastSin(float radians) {
+    const float* values = sineTable().values;
+    float pos = radians * (SineTableSize / 6.2831853f);
+    float base = std::floor(pos);
+    float frac = pos - base;
+    int i = (int)(long long)base & (SineTableSize - 1);
+    return values[i] + (values[i + 1] - values[i]) * frac;
+}
+
+const float* unitCircle(int segments) {
+    static std::vector<float> circles[MaxCircleSegments + 1];
+
+    if (segments < 3) segments = 3;
+    if (segments > MaxCircleSegments) segments = MaxCircleSegments;
+
+    std::vector<float>& circle = circles[segments];
+    if (circle.empty()) {
+        circle.resize((size_t)(segments + 1) * 2);
+        for (int i = 0; i < segments; ++i) {
+            double ang = (double)i / segments * 6.283185307179586;
+            circle[i * 2 + 0] = (float)std::cos(ang);
+            circle[i * 2 + 1] = (float)std::sin(ang);
+        }
+        circle[segments * 2 + 0] = circle[0];
+        circle[segments * 2 + 1] = circle[1];
+    }
+    return circle.data();
+}
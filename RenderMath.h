@@ -0,0 +1,21 @@
+#pragma once
+
+// Table-driven trig for render effects. Nothing here is used by the
+// simulation; it trades a few ulps of accuracy for skipping libm calls in
+// per-vertex and per-frame animation code.
+
+// Unit circle split into `segments` slices: segments + 1 (cos, sin) pairs
+// starting at angle 0, the last one repeating the first so fans and loops
+// close without wrapping. Built on first use and cached for the process
+// lifetime; segments is clamped to [3, MaxCircleSegments]. Render thread only.
+static const int MaxCircleSegments = 256;
+const float* unitCircle(int segments);
+
+// sin/cos from a 1024-entry table with linear interpolation (abs error ~2e-5)
+float fastSin(float radians);
+inline float fastCos(float radians) { return fastSin(radians + 1.5707963f); }
+
+// base + amp * sin(t * rate), the shape of every label pulse and blink
+inline float oscillate(float t, float rate, float base, float amp) {
+    return base + amp * fastSin(t * rate);
+}
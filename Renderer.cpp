@@ -0,0 +1,814 @@
+#include "Renderer.h"
+#include "RenderMath.h"
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <cstddef>
+
+// GL entry points beyond 1.1 (opengl32 on Windows only exports 1.1)
+static PFNGLGENBUFFERSPROC pglGenBuffers = nullptr;
+static PFNGLDELETEBUFFERSPROC pglDeleteBuffers = nullptr;
+static PFNGLBINDBUFFERPROC pglBindBuffer = nullptr;
+static PFNGLBUFFERDATAPROC pglBufferData = nullptr;
+static PFNGLBUFFERSUBDATAPROC pglBufferSubData = nullptr;
+static PFNGLBUFFERSTORAGEPROC pglBufferStorage = nullptr;
+static PFNGLMAPBUFFERRANGEPROC pglMapBufferRange = nullptr;
+static PFNGLUNMAPBUFFERPROC pglUnmapBuffer = nullptr;
+static PFNGLGENVERTEXARRAYSPROC pglGenVertexArrays = nullptr;
+static PFNGLDELETEVERTEXARRAYSPROC pglDeleteVertexArrays = nullptr;
+static PFNGLBINDVERTEXARRAYPROC pglBindVertexArray = nullptr;
+static PFNGLVERTEXATTRIBPOINTERPROC pglVertexAttribPointer = nullptr;
+static PFNGLENABLEVERTEXATTRIBARRAYPROC pglEnableVertexAttribArray = nullptr;
+static PFNGLCREATESHADERPROC pglCreateShader = nullptr;
+static PFNGLSHADERSOURCEPROC pglShaderSource = nullptr;
+static PFNGLCOMPILESHADERPROC pglCompileShader = nullptr;
+static PFNGLGETSHADERIVPROC pglGetShaderiv = nullptr;
+static PFNGLGETSHADERINFOLOGPROC pglGetShaderInfoLog = nullptr;
+static PFNGLDELETESHADERPROC pglDeleteShader = nullptr;
+static PFNGLCREATEPROGRAMPROC pglCreateProgram = nullptr;
+static PFNGLATTACHSHADERPROC pglAttachShader = nullptr;
+static PFNGLBINDATTRIBLOCATIONPROC pglBindAttribLocation = nullptr;
+static PFNGLLINKPROGRAMPROC pglLinkProgram = nullptr;
+static PFNGLGETPROGRAMIVPROC pglGetProgramiv = nullptr;
+static PFNGLGETPROGRAMINFOLOGPROC pglGetProgramInfoLog = nullptr;
+static PFNGLDELETEPROGRAMPROC pglDeleteProgram = nullptr;
+static PFNGLUSEPROGRAMPROC pglUseProgram = nullptr;
+static PFNGLGETUNIFORMLOCATIONPROC pglGetUniformLocation = nullptr;
+static PFNGLUNIFORMMATRIX4FVPROC pglUniformMatrix4fv = nullptr;
+static PFNGLFENCESYNCPROC pglFenceSync = nullptr;
+static PFNGLCLIENTWAITSYNCPROC pglClientWaitSync = nullptr;
+static PFNGLDELETESYNCPROC pglDeleteSync = nullptr;
+static PFNGLDRAWARRAYSINSTANCEDPROC pglDrawArraysInstanced = nullptr;
+static PFNGLVERTEXATTRIBDIVISORPROC pglVertexAttribDivisor = nullptr;
+static PFNGLGENQUERIESPROC pglGenQueries = nullptr;
+static PFNGLDELETEQUERIESPROC pglDeleteQueries = nullptr;
+static PFNGLBEGINQUERYPROC pglBeginQuery = nullptr;
+static PFNGLENDQUERYPROC pglEndQuery = nullptr;
+static PFNGLGETQUERYOBJECTIVPROC pglGetQueryObjectiv = nullptr;
+static PFNGLGETQUERYOBJECTUI64VPROC pglGetQueryObjectui64v = nullptr;
+
+#define LOAD_GL(type, name) \
+    p##name = (type)SDL_GL_GetProcAddress(#name); \
+    if (!p##name) { std::fprintf(stderr, "Renderer: missing %s\n", #name); return false; }
+
+static const char* kVertexShader =
+    "#version 150\n"
+    "in vec3 aPos;\n"
+    "in vec4 aColor;\n"
+    "uniform mat4 uMVP;\n"
+    "out vec4 vColor;\n"
+    "void main() {\n"
+    "    vColor = aColor;\n"
+    "    gl_Position = uMVP * vec4(aPos, 1.0);\n"
+    "}\n";
+
+// Per-vertex unit mesh (xy + alpha factor) and per-instance placement
+static const char* kInstanceVertexShader =
+    "#version 150\n"
+    "in vec3 aCorner;\n"
+    "in vec4 aPlacement;\n"
+    "in float aAngle;\n"
+    "in vec4 aColor;\n"
+    "uniform mat4 uMVP;\n"
+    "out vec4 vColor;\n"
+    "void main() {\n"
+    "    vec2 local = aCorner.xy * aPlacement.zw;\n"
+    "    float c = cos(aAngle);\n"
+    "    float s = sin(aAngle);\n"
+    "    vec2 p = aPlacement.xy + vec2(local.x * c - local.y * s, local.x * s + local.y * c);\n"
+    "    vColor = vec4(aColor.rgb, aColor.a * aCorner.z);\n"
+    "    gl_Position = uMVP * vec4(p, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* kFragmentShader =
+    "#version 150\n"
+    "in vec4 vColor;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragColor = vColor;\n"
+    "}\n";
+
+static const GLuint64 kFenceTimeoutNs = 1000000000ull;
+
+static void setIdentity(float* m) {
+    std::memset(m, 0, sizeof(float) * 16);
+    m[0] = m[5] = m[10] = m[15] = 1.0f;
+}
+
+static void multiply(float* out, const float* a, const float* b) {
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            out[c * 4 + r] = a[0 * 4 + r] * b[c * 4 + 0] + a[1 * 4 + r] * b[c * 4 + 1] +
+                             a[2 * 4 + r] * b[c * 4 + 2] + a[3 * 4 + r] * b[c * 4 + 3];
+        }
+    }
+}
+
+static Uint8 toByte(float v) {
+    if (v <= 0.0f) return 0;
+    if (v >= 1.0f) return 255;
+    return (Uint8)(v * 255.0f + 0.5f);
+}
+
+static GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = pglCreateShader(type);
+    pglShaderSource(shader, 1, &source, nullptr);
+    pglCompileShader(shader);
+    GLint ok = 0;
+    pglGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[512] = {};
+        pglGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::fprintf(stderr, "Renderer: shader compile failed: %s\n", log);
+        pglDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+Renderer& Renderer::getInstance() {
+    static Renderer instance;
+    return instance;
+}
+
+void Renderer::init() {
+    setIdentity(projection);
+    setIdentity(modelview[0]);
+    matrixTop = 0;
+    matricesDirty = true;
+    lineWidth = 1.0f;
+    glLineWidth(lineWidth);
+
+    staging = new Vertex[FrameVertices];
+    buildShapeMeshes();
+
+    shaderPath = initShaderPath();
+    std::fprintf(stderr, "Renderer: %s path%s%s\n", shaderPath ? "shader" : "fixed",
+                 persistent ? " (persistent mapped VBO)" : "",
+                 instancing ? ", instanced shapes" : "");
+}
+
+void Renderer::buildShapeMeshes() {
+    float* out = shapeMesh;
+    int used = 0;
+    auto add = [&](float x, float y, float alpha) {
+        out[used * 3 + 0] = x;
+        out[used * 3 + 1] = y;
+        out[used * 3 + 2] = alpha;
+        used++;
+    };
+
+    shapeFirst[SHAPE_QUAD] = used;
+    add(-1.0f, -1.0f, 1.0f); add(1.0f, -1.0f, 1.0f); add(1.0f, 1.0f, 1.0f);
+    add(-1.0f, -1.0f, 1.0f); add(1.0f, 1.0f, 1.0f); add(-1.0f, 1.0f, 1.0f);
+    shapeVertices[SHAPE_QUAD] = used - shapeFirst[SHAPE_QUAD];
+
+    // The only trig in the whole instanced path, done once
+    shapeFirst[SHAPE_GLOW_DISC] = used;
+    for (int k = 0; k < DiscSegments; ++k) {
+        float a0 = (float)k / (float)DiscSegments * 6.2831853f;
+        float a1 = (float)(k + 1) / (float)DiscSegments * 6.2831853f;
+        add(0.0f, 0.0f, 1.0f);
+        add(std::cos(a0), std::sin(a0), 0.0f);
+        add(std::cos(a1), std::sin(a1), 0.0f);
+    }
+    shapeVertices[SHAPE_GLOW_DISC] = used - shapeFirst[SHAPE_GLOW_DISC];
+
+    shapeFirst[SHAPE_STREAK] = used;
+    add(-0.5f, 0.0f, 0.0f); add(0.5f, 0.0f, 0.0f); add(0.5f, -1.0f, 1.0f);
+    add(-0.5f, 0.0f, 0.0f); add(0.5f, -1.0f, 1.0f); add(-0.5f, -1.0f, 1.0f);
+    shapeVertices[SHAPE_STREAK] = used - shapeFirst[SHAPE_STREAK];
+
+    shapeFirst[SHAPE_COMET] = used;
+    add(0.0f, 1.0f, 1.0f); add(0.0f, -1.0f, 1.0f); add(-1.0f, -0.4f, 0.0f);
+    add(0.0f, 1.0f, 1.0f); add(-1.0f, -0.4f, 0.0f); add(-1.0f, 0.4f, 0.0f);
+    shapeVertices[SHAPE_COMET] = used - shapeFirst[SHAPE_COMET];
+}
+
+bool Renderer::initShaderPath() {
+    int major = 0, minor = 0;
+    const char* version = (const char*)glGetString(GL_VERSION);
+    if (!version || std::sscanf(version, "%d.%d", &major, &minor) != 2) return false;
+    if (major < 3 || (major == 3 && minor < 2)) return false;
+
+    LOAD_GL(PFNGLGENBUFFERSPROC, glGenBuffers);
+    LOAD_GL(PFNGLDELETEBUFFERSPROC, glDeleteBuffers);
+    LOAD_GL(PFNGLBINDBUFFERPROC, glBindBuffer);
+    LOAD_GL(PFNGLBUFFERDATAPROC, glBufferData);
+    LOAD_GL(PFNGLBUFFERSUBDATAPROC, glBufferSubData);
+    LOAD_GL(PFNGLMAPBUFFERRANGEPROC, glMapBufferRange);
+    LOAD_GL(PFNGLUNMAPBUFFERPROC, glUnmapBuffer);
+    LOAD_GL(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays);
+    LOAD_GL(PFNGLDELETEVERTEXARRAYSPROC, glDeleteVertexArrays);
+    LOAD_GL(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray);
+    LOAD_GL(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer);
+    LOAD_GL(PFNGLENABLEVERTEXATTRIBARRAYPROC, glEnableVertexAttribArray);
+    LOAD_GL(PFNGLCREATESHADERPROC, glCreateShader);
+    LOAD_GL(PFNGLSHADERSOURCEPROC, glShaderSource);
+    LOAD_GL(PFNGLCOMPILESHADERPROC, glCompileShader);
+    LOAD_GL(PFNGLGETSHADERIVPROC, glGetShaderiv);
+    LOAD_GL(PFNGLGETSHADERINFOLOGPROC, glGetShaderInfoLog);
+    LOAD_GL(PFNGLDELETESHADERPROC, glDeleteShader);
+    LOAD_GL(PFNGLCREATEPROGRAMPROC, glCreateProgram);
+    LOAD_GL(PFNGLATTACHSHADERPROC, glAttachShader);
+    LOAD_GL(PFNGLBINDATTRIBLOCATIONPROC, glBindAttribLocation);
+    LOAD_GL(PFNGLLINKPROGRAMPROC, glLinkProgram);
+    LOAD_GL(PFNGLGETPROGRAMIVPROC, glGetProgramiv);
+    LOAD_GL(PFNGLGETPROGRAMINFOLOGPROC, glGetProgramInfoLog);
+    LOAD_GL(PFNGLDELETEPROGRAMPROC, glDeleteProgram);
+    LOAD_GL(PFNGLUSEPROGRAMPROC, glUseProgram);
+    LOAD_GL(PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation);
+    LOAD_GL(PFNGLUNIFORMMATRIX4FVPROC, glUniformMatrix4fv);
+    LOAD_GL(PFNGLFENCESYNCPROC, glFenceSync);
+    LOAD_GL(PFNGLCLIENTWAITSYNCPROC, glClientWaitSync);
+    LOAD_GL(PFNGLDELETESYNCPROC, glDeleteSync);
+
+    GLuint vs = compileShader(GL_VERTEX_SHADER, kVertexShader);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, kFragmentShader);
+    if (!vs || !fs) {
+        if (vs) pglDeleteShader(vs);
+        if (fs) pglDeleteShader(fs);
+        return false;
+    }
+
+    program = pglCreateProgram();
+    pglAttachShader(program, vs);
+    pglAttachShader(program, fs);
+    pglBindAttribLocation(program, 0, "aPos");
+    pglBindAttribLocation(program, 1, "aColor");
+    pglLinkProgram(program);
+    pglDeleteShader(vs);
+    pglDeleteShader(fs);
+
+    GLint linked = 0;
+    pglGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        char log[512] = {};
+        pglGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::fprintf(stderr, "Renderer: program link failed: %s\n", log);
+        pglDeleteProgram(program);
+        program = 0;
+        return false;
+    }
+    mvpLocation = pglGetUniformLocation(program, "uMVP");
+
+    pglGenVertexArrays(1, &vao);
+    pglBindVertexArray(vao);
+    pglGenBuffers(1, &vbo);
+    pglBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    // Persistent mapping lets vertices be written straight into GPU-visible memory
+    pglBufferStorage = (PFNGLBUFFERSTORAGEPROC)SDL_GL_GetProcAddress("glBufferStorage");
+    bool hasStorage = pglBufferStorage &&
+                      (major > 4 || (major == 4 && minor >= 4) ||
+                       SDL_GL_ExtensionSupported("GL_ARB_buffer_storage"));
+    if (hasStorage) {
+        GLsizeiptr bytes = (GLsizeiptr)sizeof(Vertex) * FrameVertices * RingFrames;
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        pglBufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, flags);
+        mapped = (Vertex*)pglMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags);
+        persistent = (mapped != nullptr);
+    }
+    if (!persistent) {
+        pglBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(Vertex) * FrameVertices, nullptr, GL_STREAM_DRAW);
+    }
+
+    pglEnableVertexAttribArray(0);
+    pglVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)0);
+    pglEnableVertexAttribArray(1);
+    pglVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (const void*)(3 * sizeof(float)));
+
+    pglBindVertexArray(0);
+    pglBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    instancing = initInstancing(major, minor);
+    timerQueries = initTimerQueries(major, minor);
+    return true;
+}
+
+bool Renderer::initTimerQueries(int major, int minor) {
+    if (!(major > 3 || (major == 3 && minor >= 3)) && !SDL_GL_ExtensionSupported("GL_ARB_timer_query")) {
+        return false;
+    }
+    pglGenQueries = (PFNGLGENQUERIESPROC)SDL_GL_GetProcAddress("glGenQueries");
+    pglDeleteQueries = (PFNGLDELETEQUERIESPROC)SDL_GL_GetProcAddress("glDeleteQueries");
+    pglBeginQuery = (PFNGLBEGINQUERYPROC)SDL_GL_GetProcAddress("glBeginQuery");
+    pglEndQuery = (PFNGLENDQUERYPROC)SDL_GL_GetProcAddress("glEndQuery");
+    pglGetQueryObjectiv = (PFNGLGETQUERYOBJECTIVPROC)SDL_GL_GetProcAddress("glGetQueryObjectiv");
+    pglGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)SDL_GL_GetProcAddress("glGetQueryObjectui64v");
+    if (!pglGenQueries || !pglDeleteQueries || !pglBeginQuery || !pglEndQuery ||
+        !pglGetQueryObjectiv || !pglGetQueryObjectui64v) {
+        return false;
+    }
+    pglGenQueries(TimerQueryFrames, gpuQueries);
+    return true;
+}
+
+void Renderer::setGpuTiming(bool enabled) {
+    gpuTiming = enabled && timerQueries;
+    gpuResultReady = false;
+}
+
+bool Renderer::pollGpuFrameTime(double& ms) {
+    if (!gpuResultReady) return false;
+    gpuResultReady = false;
+    ms = gpuFrameMs;
+    return true;
+}
+
+bool Renderer::initInstancing(int major, int minor) {
+    pglDrawArraysInstanced = (PFNGLDRAWARRAYSINSTANCEDPROC)SDL_GL_GetProcAddress("glDrawArraysInstanced");
+    if (major > 3 || (major == 3 && minor >= 3)) {
+        pglVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC)SDL_GL_GetProcAddress("glVertexAttribDivisor");
+    } else if (SDL_GL_ExtensionSupported("GL_ARB_instanced_arrays")) {
+        pglVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC)SDL_GL_GetProcAddress("glVertexAttribDivisorARB");
+    }
+    if (!pglDrawArraysInstanced || !pglVertexAttribDivisor) return false;
+
+    GLuint vs = compileShader(GL_VERTEX_SHADER, kInstanceVertexShader);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, kFragmentShader);
+    if (!vs || !fs) {
+        if (vs) pglDeleteShader(vs);
+        if (fs) pglDeleteShader(fs);
+        return false;
+    }
+
+    instanceProgram = pglCreateProgram();
+    pglAttachShader(instanceProgram, vs);
+    pglAttachShader(instanceProgram, fs);
+    pglBindAttribLocation(instanceProgram, 0, "aCorner");
+    pglBindAttribLocation(instanceProgram, 1, "aPlacement");
+    pglBindAttribLocation(instanceProgram, 2, "aAngle");
+    pglBindAttribLocation(instanceProgram, 3, "aColor");
+    pglLinkProgram(instanceProgram);
+    pglDeleteShader(vs);
+    pglDeleteShader(fs);
+
+    GLint linked = 0;
+    pglGetProgramiv(instanceProgram, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        char log[512] = {};
+        pglGetProgramInfoLog(instanceProgram, sizeof(log), nullptr, log);
+        std::fprintf(stderr, "Renderer: instance program link failed: %s\n", log);
+        pglDeleteProgram(instanceProgram);
+        instanceProgram = 0;
+        return false;
+    }
+    instanceMvpLocation = pglGetUniformLocation(instanceProgram, "uMVP");
+
+    pglGenVertexArrays(1, &instanceVao);
+    pglBindVertexArray(instanceVao);
+
+    pglGenBuffers(1, &meshVbo);
+    pglBindBuffer(GL_ARRAY_BUFFER, meshVbo);
+    pglBufferData(GL_ARRAY_BUFFER, sizeof(shapeMesh), shapeMesh, GL_STATIC_DRAW);
+    pglEnableVertexAttribArray(0);
+    pglVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (const void*)0);
+
+    pglGenBuffers(1, &instanceVbo);
+    pglBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    pglBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(RenderInstance) * MaxInstancesPerDraw, nullptr, GL_STREAM_DRAW);
+    pglEnableVertexAttribArray(1);
+    pglVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(RenderInstance), (const void*)offsetof(RenderInstance, x));
+    pglVertexAttribDivisor(1, 1);
+    pglEnableVertexAttribArray(2);
+    pglVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(RenderInstance), (const void*)offsetof(RenderInstance, angle));
+    pglVertexAttribDivisor(2, 1);
+    pglEnableVertexAttribArray(3);
+    pglVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(RenderInstance), (const void*)offsetof(RenderInstance, r));
+    pglVertexAttribDivisor(3, 1);
+
+    pglBindVertexArray(0);
+    pglBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void Renderer::shutdown() {
+    if (shaderPath) {
+        for (int i = 0; i < RingFrames; ++i) {
+            if (fences[i]) {
+                pglDeleteSync(fences[i]);
+                fences[i] = nullptr;
+            }
+        }
+        if (mapped) {
+            pglBindBuffer(GL_ARRAY_BUFFER, vbo);
+            pglUnmapBuffer(GL_ARRAY_BUFFER);
+            pglBindBuffer(GL_ARRAY_BUFFER, 0);
+            mapped = nullptr;
+        }
+        if (vbo) pglDeleteBuffers(1, &vbo);
+        if (vao) pglDeleteVertexArrays(1, &vao);
+        if (program) pglDeleteProgram(program);
+        vbo = vao = program = 0;
+        if (meshVbo) pglDeleteBuffers(1, &meshVbo);
+        if (instanceVbo) pglDeleteBuffers(1, &instanceVbo);
+        if (instanceVao) pglDeleteVertexArrays(1, &instanceVao);
+        if (instanceProgram) pglDeleteProgram(instanceProgram);
+        meshVbo = instanceVbo = instanceVao = instanceProgram = 0;
+        if (timerQueries) {
+            if (gpuTimerRunning) pglEndQuery(GL_TIME_ELAPSED);
+            pglDeleteQueries(TimerQueryFrames, gpuQueries);
+            for (int i = 0; i < TimerQueryFrames; ++i) {
+                gpuQueries[i] = 0;
+                gpuQueryPending[i] = false;
+            }
+        }
+    }
+    shaderPath = false;
+    instancing = false;
+    timerQueries = false;
+    gpuTiming = false;
+    gpuTimerRunning = false;
+    persistent = false;
+
+    delete[] staging;
+    staging = nullptr;
+}
+
+void Renderer::beginFrame() {
+    drawCalls = 0;
+    vertexCount = 0;
+    batchCount = 0;
+    // Anything outside the renderer (the splash screen) may have touched GL matrices
+    matricesDirty = true;
+
+    if (persistent) {
+        // Don't overwrite a slice the GPU may still be reading from RingFrames frames ago
+        if (fences[frameSlice]) {
+            pglClientWaitSync(fences[frameSlice], GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeoutNs);
+            pglDeleteSync(fences[frameSlice]);
+            fences[frameSlice] = nullptr;
+        }
+        batchFirst = frameSlice * FrameVertices;
+        sliceEnd = batchFirst + FrameVertices;
+    } else {
+        batchFirst = 0;
+        sliceEnd = FrameVertices;
+    }
+
+    if (gpuTiming) {
+        // Collect this slot's old query if the GPU is done with it; a late
+        // result is dropped rather than stalling the frame
+        GLuint query = gpuQueries[gpuQuerySlot];
+        if (gpuQueryPending[gpuQuerySlot]) {
+            GLint available = 0;
+            pglGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                GLuint64 ns = 0;
+                pglGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+                gpuFrameMs = (double)ns * 1.0e-6;
+                gpuResultReady = true;
+            }
+            gpuQueryPending[gpuQuerySlot] = false;
+        }
+        pglBeginQuery(GL_TIME_ELAPSED, query);
+        gpuTimerRunning = true;
+    }
+}
+
+void Renderer::endFrame() {
+    flush();
+
+    if (persistent) {
+        fences[frameSlice] = pglFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        frameSlice = (frameSlice + 1) % RingFrames;
+    }
+    if (bound) {
+        pglUseProgram(0);
+        pglBindVertexArray(0);
+        bound = false;
+    }
+
+    if (gpuTimerRunning) {
+        pglEndQuery(GL_TIME_ELAPSED);
+        gpuQueryPending[gpuQuerySlot] = true;
+        gpuQuerySlot = (gpuQuerySlot + 1) % TimerQueryFrames;
+        gpuTimerRunning = false;
+    }
+
+    lastDrawCalls = drawCalls;
+    lastVertexCount = vertexCount;
+}
+
+void Renderer::flush() {
+    if (batchCount == 0) return;
+
+    if (shaderPath) {
+        if (!bound) {
+            pglUseProgram(program);
+            pglBindVertexArray(vao);
+            pglBindBuffer(GL_ARRAY_BUFFER, vbo);
+            bound = true;
+            matricesDirty = true;
+        }
+        if (matricesDirty) {
+            float mvp[16];
+            multiply(mvp, projection, modelview[matrixTop]);
+            pglUniformMatrix4fv(mvpLocation, 1, GL_FALSE, mvp);
+            matricesDirty = false;
+        }
+        if (persistent) {
+            glDrawArrays(batchMode, batchFirst, batchCount);
+        } else {
+            // Orphan the old storage so the driver doesn't stall on the previous draw
+            pglBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(Vertex) * FrameVertices, nullptr, GL_STREAM_DRAW);
+            pglBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)sizeof(Vertex) * batchCount, staging);
+            glDrawArrays(batchMode, 0, batchCount);
+        }
+    } else {
+        if (matricesDirty) {
+            glMatrixMode(GL_PROJECTION);
+            glLoadMatrixf(projection);
+            glMatrixMode(GL_MODELVIEW);
+            glLoadMatrixf(modelview[matrixTop]);
+            matricesDirty = false;
+        }
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(3, GL_FLOAT, sizeof(Vertex), &staging[0].x);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &staging[0].r);
+        glDrawArrays(batchMode, 0, batchCount);
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+    }
+
+    drawCalls++;
+    vertexCount += batchCount;
+    if (persistent) batchFirst += batchCount;
+    batchCount = 0;
+}
+
+Renderer::Vertex* Renderer::reserve(int count) {
+    int capacity = persistent ? sliceEnd - batchFirst : FrameVertices;
+    if (batchCount + count > capacity) {
+        flush();
+        if (persistent && batchFirst + count > sliceEnd) {
+            // Slice used up mid-frame: wait for its draws to finish, then reuse it
+            GLsync fence = pglFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            pglClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeoutNs);
+            pglDeleteSync(fence);
+            batchFirst = frameSlice * FrameVertices;
+        }
+    }
+    Vertex* base = persistent ? mapped + batchFirst : staging;
+    Vertex* out = base + batchCount;
+    batchCount += count;
+    return out;
+}
+
+void Renderer::emitTriangle(const Vertex& a, const Vertex& b, const Vertex& c) {
+    Vertex* out = reserve(3);
+    out[0] = a;
+    out[1] = b;
+    out[2] = c;
+}
+
+void Renderer::emitLine(const Vertex& a, const Vertex& b) {
+    Vertex* out = reserve(2);
+    out[0] = a;
+    out[1] = b;
+}
+
+void Renderer::begin(GLenum mode) {
+    bool lines = (mode == GL_LINES || mode == GL_LINE_STRIP || mode == GL_LINE_LOOP);
+    GLenum drawMode = lines ? GL_LINES : GL_TRIANGLES;
+    if (batchCount > 0 && drawMode != batchMode) {
+        flush();
+    }
+    batchMode = drawMode;
+    primMode = mode;
+    primVerts = 0;
+}
+
+void Renderer::end() {
+    if (primMode == GL_LINE_LOOP && primVerts >= 2) {
+        emitLine(primPrev, primFirst);
+    }
+    primVerts = 0;
+}
+
+void Renderer::color(float r, float g, float b, float a) {
+    curR = toByte(r);
+    curG = toByte(g);
+    curB = toByte(b);
+    curA = toByte(a);
+}
+
+void Renderer::vertex(float x, float y, float z) {
+    Vertex v = { x, y, z, curR, curG, curB, curA };
+
+    switch (primMode) {
+    case GL_TRIANGLES:
+        primQuad[primVerts++] = v;
+        if (primVerts == 3) {
+            emitTriangle(primQuad[0], primQuad[1], primQuad[2]);
+            primVerts = 0;
+        }
+        break;
+    case GL_QUADS:
+        if (primVerts < 3) {
+            primQuad[primVerts++] = v;
+        } else {
+            emitTriangle(primQuad[0], primQuad[1], primQuad[2]);
+            emitTriangle(primQuad[0], primQuad[2], v);
+            primVerts = 0;
+        }
+        break;
+    case GL_TRIANGLE_FAN:
+        if (primVerts == 0) {
+            primFirst = v;
+        } else if (primVerts >= 2) {
+            emitTriangle(primFirst, primPrev, v);
+        }
+        primPrev = v;
+        primVerts++;
+        break;
+    case GL_LINES:
+        if (primVerts == 0) {
+            primPrev = v;
+            primVerts = 1;
+        } else {
+            emitLine(primPrev, v);
+            primVerts = 0;
+        }
+        break;
+    case GL_LINE_STRIP:
+    case GL_LINE_LOOP:
+        if (primVerts == 0) {
+            primFirst = v;
+        } else {
+            emitLine(primPrev, v);
+        }
+        primPrev = v;
+        primVerts++;
+        break;
+    default:
+        break;
+    }
+}
+
+void Renderer::triangles(const float* xy, int vertexCount, float x, float y) {
+    if (batchCount > 0 && batchMode != GL_TRIANGLES) {
+        flush();
+    }
+    batchMode = GL_TRIANGLES;
+
+    // Copy in chunks so a long run never exceeds what one slice can hold
+    const int chunk = 3 * 1024;
+    while (vertexCount > 0) {
+        int n = vertexCount < chunk ? vertexCount : chunk;
+        Vertex* out = reserve(n);
+        for (int i = 0; i < n; ++i) {
+            out[i].x = xy[i * 2 + 0] + x;
+            out[i].y = xy[i * 2 + 1] + y;
+            out[i].z = 0.0f;
+            out[i].r = curR;
+            out[i].g = curG;
+            out[i].b = curB;
+            out[i].a = curA;
+        }
+        xy += n * 2;
+        vertexCount -= n;
+    }
+}
+
+void Renderer::drawInstances(InstanceShape shape, const RenderInstance* instances, int count) {
+    if (count <= 0) return;
+    if (!instancing) {
+        expandInstances(shape, instances, count);
+        return;
+    }
+
+    // Keep submission order: whatever is batched so far goes first
+    flush();
+    pglUseProgram(instanceProgram);
+    pglBindVertexArray(instanceVao);
+    pglBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    float mvp[16];
+    multiply(mvp, projection, modelview[matrixTop]);
+    pglUniformMatrix4fv(instanceMvpLocation, 1, GL_FALSE, mvp);
+
+    while (count > 0) {
+        int n = count < MaxInstancesPerDraw ? count : MaxInstancesPerDraw;
+        // Orphan, then upload: the instance records are the only per-frame data
+        pglBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(RenderInstance) * MaxInstancesPerDraw, nullptr, GL_STREAM_DRAW);
+        pglBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)sizeof(RenderInstance) * n, instances);
+        pglDrawArraysInstanced(GL_TRIANGLES, shapeFirst[shape], shapeVertices[shape], n);
+        drawCalls++;
+        vertexCount += shapeVertices[shape] * n;
+        instances += n;
+        count -= n;
+    }
+
+    // The next flush rebinds the batch program and VAO
+    bound = false;
+}
+
+void Renderer::expandInstances(InstanceShape shape, const RenderInstance* instances, int count) {
+    if (batchCount > 0 && batchMode != GL_TRIANGLES) {
+        flush();
+    }
+    batchMode = GL_TRIANGLES;
+
+    const float* mesh = shapeMesh + shapeFirst[shape] * 3;
+    const int meshCount = shapeVertices[shape];
+    for (int i = 0; i < count; ++i) {
+        const RenderInstance& inst = instances[i];
+        // One sin/cos per instance, none per vertex
+        float c = 1.0f, s = 0.0f;
+        if (inst.angle != 0.0f) {
+            c = fastCos(inst.angle);
+            s = fastSin(inst.angle);
+        }
+        Vertex* out = reserve(meshCount);
+        for (int v = 0; v < meshCount; ++v) {
+            float lx = mesh[v * 3 + 0] * inst.sizeX;
+            float ly = mesh[v * 3 + 1] * inst.sizeY;
+            out[v].x = inst.x + lx * c - ly * s;
+            out[v].y = inst.y + lx * s + ly * c;
+            out[v].z = 0.0f;
+            out[v].r = inst.r;
+            out[v].g = inst.g;
+            out[v].b = inst.b;
+            out[v].a = (Uint8)((float)inst.a * mesh[v * 3 + 2] + 0.5f);
+        }
+    }
+}
+
+void Renderer::setDepthTest(bool enabled) {
+    flush();
+    if (enabled) glEnable(GL_DEPTH_TEST);
+    else glDisable(GL_DEPTH_TEST);
+}
+
+void Renderer::setLineWidth(float w) {
+    if (w == lineWidth) return;
+    flush();
+    lineWidth = w;
+    glLineWidth(w);
+}
+
+void Renderer::ortho(float left, float right, float bottom, float top, float zNear, float zFar) {
+    flush();
+    setIdentity(projection);
+    projection[0] = 2.0f / (right - left);
+    projection[5] = 2.0f / (top - bottom);
+    projection[10] = -2.0f / (zFar - zNear);
+    projection[12] = -(right + left) / (right - left);
+    projection[13] = -(top + bottom) / (top - bottom);
+    projection[14] = -(zFar + zNear) / (zFar - zNear);
+    matricesDirty = true;
+}
+
+void Renderer::frustum(float left, float right, float bottom, float top, float zNear, float zFar) {
+    flush();
+    std::memset(projection, 0, sizeof(projection));
+    projection[0] = 2.0f * zNear / (right - left);
+    projection[5] = 2.0f * zNear / (top - bottom);
+    projection[8] = (right + left) / (right - left);
+    projection[9] = (top + bottom) / (top - bottom);
+    projection[10] = -(zFar + zNear) / (zFar - zNear);
+    projection[11] = -1.0f;
+    projection[14] = -2.0f * zFar * zNear / (zFar - zNear);
+    matricesDirty = true;
+}
+
+void Renderer::loadIdentity() {
+    flush();
+    setIdentity(modelview[matrixTop]);
+    matricesDirty = true;
+}
+
+void Renderer::translate(float x, float y, float z) {
+    flush();
+    float* m = modelview[matrixTop];
+    for (int r = 0; r < 4; ++r) {
+        m[12 + r] += m[r] * x + m[4 + r] * y + m[8 + r] * z;
+    }
+    matricesDirty = true;
+}
+
+void Renderer::scale(float x, float y, float z) {
+    flush();
+    float* m = modelview[matrixTop];
+    for (int r = 0; r < 4; ++r) {
+        m[r] *= x;
+        m[4 + r] *= y;
+        m[8 + r] *= z;
+    }
+    matricesDirty = true;
+}
+
+void Renderer::pushMatrix() {
+    if (matrixTop + 1 >= MaxMatrixDepth) return;
+    std::memcpy(modelview[matrixTop + 1], modelview[matrixTop], sizeof(modelview[0]));
+    matrixTop++;
+}
+
+void Renderer::popMatrix() {
+    if (matrixTop == 0) return;
+    flush();
+    matrixTop--;
+    matricesDirty = true;
+}
@@ -0,0 +1,187 @@
+#pragma once
+#include "SDL3/SDL.h"
+#include "SDL3/SDL_opengl.h"
+
+// Batched replacement for glBegin/glEnd immediate mode.
+// Call sites keep the familiar begin/color/vertex/end shape, but vertices are
+// appended to one big buffer and only reach the driver when something that
+// breaks a batch changes (primitive class, depth test, line width, matrices)
+// or at the end of the frame. Quads and fans are split into triangles and line
+// loops into line pairs, so a whole HUD is a handful of draw calls.
+//
+// Paths, picked at init from what the context offers:
+//  - shader:     GLSL 150 program + VAO, no fixed-function state; vertices go
+//                into a persistently mapped VBO (GL 4.4 / ARB_buffer_storage)
+//                or are copied with glBufferSubData when that is missing
+//  - fixed:      client-side vertex arrays with glLoadMatrixf (GL 1.1)
+
+// Instanced shapes: one record per particle, expanded from a small unit mesh.
+// Mesh vertices are scaled by (sizeX, sizeY), rotated by angle and moved to
+// (x, y); each carries an alpha factor so glows and trails fade across the shape.
+enum InstanceShape {
+    SHAPE_QUAD = 0,     // [-1, 1] square, solid
+    SHAPE_GLOW_DISC,    // unit disc, opaque centre fading to a clear rim
+    SHAPE_STREAK,       // x in [-0.5, 0.5], rising from y = 0 (clear) to y = -1 (opaque)
+    SHAPE_COMET,        // head edge at x = 0 (y = +-1, opaque) tapering to x = -1 (clear)
+    SHAPE_COUNT
+};
+
+struct RenderInstance {
+    float x, y;
+    float sizeX, sizeY;
+    float angle;                 // radians
+    Uint8 r, g, b, a;
+
+    void setColor(float cr, float cg, float cb, float ca) {
+        r = (Uint8)(cr <= 0.0f ? 0 : cr >= 1.0f ? 255 : cr * 255.0f + 0.5f);
+        g = (Uint8)(cg <= 0.0f ? 0 : cg >= 1.0f ? 255 : cg * 255.0f + 0.5f);
+        b = (Uint8)(cb <= 0.0f ? 0 : cb >= 1.0f ? 255 : cb * 255.0f + 0.5f);
+        a = (Uint8)(ca <= 0.0f ? 0 : ca >= 1.0f ? 255 : ca * 255.0f + 0.5f);
+    }
+};
+
+class Renderer {
+public:
+    static Renderer& getInstance();
+
+    void init();        // needs a current GL context; falls back to the fixed path on failure
+    void shutdown();
+
+    void beginFrame();
+    void endFrame();    // flushes; call before swapping buffers
+
+    // Immediate-mode style submission. Supported modes: GL_TRIANGLES, GL_QUADS,
+    // GL_TRIANGLE_FAN, GL_LINES, GL_LINE_STRIP, GL_LINE_LOOP.
+    void begin(GLenum mode);
+    void end();
+    void color(float r, float g, float b, float a = 1.0f);
+    void vertex(float x, float y, float z = 0.0f);
+
+    // Append a prebuilt run of 2D triangles (xy pairs, z = 0) offset by (x, y)
+    // in the current color; used for cached text
+    void triangles(const float* xy, int vertexCount, float x, float y);
+
+    // One `shape` per instance, in submission order with the rest of the batch.
+    // Expanded in a vertex shader with instanced draws when the context has
+    // them (GL 3.3 / ARB_instanced_arrays), otherwise on the CPU into the batch.
+    void drawInstances(InstanceShape shape, const RenderInstance* instances, int count);
+
+    void flush();
+
+    // State that splits a batch
+    void setDepthTest(bool enabled);
+    void setLineWidth(float w);
+
+    // Matrices; replaces the fixed-function projection/modelview stacks
+    void ortho(float left, float right, float bottom, float top, float zNear, float zFar);
+    void frustum(float left, float right, float bottom, float top, float zNear, float zFar);
+    void loadIdentity();
+    void translate(float x, float y, float z);
+    void scale(float x, float y, float z);
+    void pushMatrix();
+    void popMatrix();
+
+    // Stats for the last completed frame
+    int getDrawCalls() const { return lastDrawCalls; }
+    int getVertexCount() const { return lastVertexCount; }
+    bool usingShaderPath() const { return shaderPath; }
+    bool usingInstancing() const { return instancing; }
+
+    // GPU time per frame from GL timer queries (GL 3.3 / ARB_timer_query),
+    // bracketing beginFrame..endFrame. Results are read a few frames late and
+    // never waited on; poll returns true when a new one has arrived.
+    void setGpuTiming(bool enabled);
+    bool pollGpuFrameTime(double& ms);
+    bool hasGpuTiming() const { return timerQueries; }
+
+private:
+    Renderer() = default;
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
+    struct Vertex {
+        float x, y, z;
+        Uint8 r, g, b, a;
+    };
+
+    static const int FrameVertices = 65536;   // per frame slice of the buffer
+    static const int RingFrames = 3;          // slices in flight (persistent path)
+    static const int MaxMatrixDepth = 8;
+
+    static const int MaxInstancesPerDraw = 8192;
+    static const int DiscSegments = 12;
+    static const int MeshVertices = 6 + DiscSegments * 3 + 6 + 6;
+    static const int TimerQueryFrames = 4;    // queries in flight before one is reused
+
+    bool initShaderPath();
+    bool initInstancing(int major, int minor);
+    bool initTimerQueries(int major, int minor);
+    void buildShapeMeshes();
+    void expandInstances(InstanceShape shape, const RenderInstance* instances, int count);
+    Vertex* reserve(int count);
+    void emitTriangle(const Vertex& a, const Vertex& b, const Vertex& c);
+    void emitLine(const Vertex& a, const Vertex& b);
+
+    bool shaderPath = false;
+    bool persistent = false;
+
+    // GL objects (shader path)
+    GLuint program = 0;
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLint mvpLocation = -1;
+    bool bound = false;
+
+    // Instanced shapes: unit meshes as (x, y, alpha) triples, shared by both paths
+    float shapeMesh[MeshVertices * 3] = {};
+    int shapeFirst[SHAPE_COUNT] = {};
+    int shapeVertices[SHAPE_COUNT] = {};
+    bool instancing = false;
+    GLuint instanceProgram = 0;
+    GLuint instanceVao = 0;
+    GLuint meshVbo = 0;
+    GLuint instanceVbo = 0;
+    GLint instanceMvpLocation = -1;
+
+    // GPU frame timing
+    bool timerQueries = false;     // supported by the context
+    bool gpuTiming = false;        // requested and supported
+    bool gpuTimerRunning = false;
+    GLuint gpuQueries[TimerQueryFrames] = {};
+    bool gpuQueryPending[TimerQueryFrames] = {};
+    int gpuQuerySlot = 0;
+    bool gpuResultReady = false;
+    double gpuFrameMs = 0.0;
+
+    // Vertex storage
+    Vertex* mapped = nullptr;      // persistent mapping of the whole ring
+    Vertex* staging = nullptr;     // CPU copy for the non-persistent paths
+    GLsync fences[RingFrames] = {};
+    int frameSlice = 0;
+    int batchFirst = 0;            // first vertex of the pending batch in the buffer
+    int batchCount = 0;
+    int sliceEnd = 0;
+    GLenum batchMode = GL_TRIANGLES;
+
+    // Primitive assembly
+    GLenum primMode = GL_TRIANGLES;
+    bool inPrimitive = false;
+    int primVerts = 0;
+    Vertex primFirst = {};
+    Vertex primPrev = {};
+    Vertex primQuad[3] = {};
+    Uint8 curR = 255, curG = 255, curB = 255, curA = 255;
+
+    // Matrices (column-major, like GL)
+    float projection[16] = {};
+    float modelview[MaxMatrixDepth][16] = {};
+    int matrixTop = 0;
+    bool matricesDirty = true;
+
+    float lineWidth = 1.0f;
+
+    int drawCalls = 0;
+    int vertexCount = 0;
+    int lastDrawCalls = 0;
+    int lastVertexCount = 0;
+};
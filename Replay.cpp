@@ -0,0 +1,400 @@
+#include "Replay.h"
+#include <cstdio>
+#include <cstring>
+
+static const char ReplayMagic[4] = { 'P', 'P', 'R', 'P' };
+static const unsigned int ReplayVersion = 3;   // 2: PCG32 gameplay stream, 3: ball count
+static const size_t HeaderBytes = 4 + 5 * 4;
+
+enum ReplayRecordFlags {
+    RECORD_INPUT = 1,
+    RECORD_CONFIG = 2
+};
+
+enum PaddleButtons {
+    BUTTON_UP = 1 << 0,
+    BUTTON_DOWN = 1 << 1,
+    BUTTON_LEFT = 1 << 2,
+    BUTTON_RIGHT = 1 << 3,
+    BUTTON_BOOST = 1 << 4,
+    BUTTON_SHIELD = 1 << 5,
+    BUTTON_POINTER = 1 << 6
+};
+
+namespace {
+
+struct Fnv {
+    unsigned int h = 2166136261u;
+    void bytes(const void* data, size_t n) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < n; ++i) {
+            h = (h ^ p[i]) * 16777619u;
+        }
+    }
+    void f(float v) { bytes(&v, sizeof(v)); }
+    void i(int v) { bytes(&v, sizeof(v)); }
+    void u(unsigned int v) { bytes(&v, sizeof(v)); }
+    void b(bool v) { unsigned char c = v ? 1 : 0; bytes(&c, 1); }
+};
+
+void hashPaddle(Fnv& h, const SimPaddle& p) {
+    h.f(p.x); h.f(p.y); h.f(p.vx); h.f(p.vy); h.f(p.speed);
+    h.i(p.width); h.i(p.height);
+}
+
+void hashPickup(Fnv& h, const ShieldPickup& p) {
+    h.f(p.x); h.f(p.y); h.f(p.targetY); h.f(p.bobTimer); h.b(p.active);
+}
+
+} // namespace
+
+unsigned int matchChecksum(const MatchState& s) {
+    Fnv h;
+    hashPaddle(h, s.paddle1);
+    hashPaddle(h, s.paddle2);
+    h.i(s.ballCount);
+    for (int i = 0; i < s.ballCount; ++i) {
+        const SimBall& b = s.balls[i];
+        h.f(b.x); h.f(b.y); h.f(b.velX); h.f(b.velY);
+        h.f(b.trailBoost); h.f(b.rallyEnergy);
+        h.b(b.isPiercing); h.i(b.wallBounceCount); h.i(b.radius);
+    }
+    h.i(s.score1); h.i(s.score2);
+    h.i(s.health1); h.i(s.health2);
+    h.f(s.boostMeter1); h.f(s.boostMeter2);
+    h.b(s.boostActive1); h.b(s.boostActive2);
+    h.b(s.shieldHeld1); h.b(s.shieldHeld2);
+    h.f(s.shieldCooldown1); h.f(s.shieldCooldown2);
+    hashPickup(h, s.shieldPickup1);
+    hashPickup(h, s.shieldPickup2);
+    h.i(s.winner); h.b(s.koWin);
+    h.bytes(&s.rng.state, sizeof(s.rng.state)); h.u(s.tick);
+    return h.h;
+}
+
+void putU32(std::vector<unsigned char>& out, unsigned int v) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back((unsigned char)(v >> (i * 8)));
+    }
+}
+
+void putF32(std::vector<unsigned char>& out, float v) {
+    unsigned int bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    putU32(out, bits);
+}
+
+void putVarint(std::vector<unsigned char>& out, unsigned int v) {
+    while (v >= 0x80) {
+        out.push_back((unsigned char)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((unsigned char)v);
+}
+
+void putMatchConfig(std::vector<unsigned char>& out, const MatchConfig& c) {
+    putU32(out, (unsigned int)c.width);
+    putU32(out, (unsigned int)c.height);
+    putU32(out, (unsigned int)c.mode);
+    putU32(out, c.freeMovement ? 1u : 0u);
+    putU32(out, c.autoBoost ? 1u : 0u);
+    putU32(out, c.shieldEnabled ? 1u : 0u);
+    putU32(out, (unsigned int)c.maxHealth);
+    putU32(out, (unsigned int)c.targetScore);
+    putU32(out, c.aiControlled1 ? 1u : 0u);
+    putU32(out, c.aiControlled2 ? 1u : 0u);
+    putU32(out, (unsigned int)c.aiDifficulty1);
+    putU32(out, (unsigned int)c.aiDifficulty2);
+    putU32(out, (unsigned int)c.ballCount);
+}
+
+static unsigned char packButtons(const PaddleInput& p) {
+    return (unsigned char)((p.up ? BUTTON_UP : 0) | (p.down ? BUTTON_DOWN : 0) |
+                           (p.left ? BUTTON_LEFT : 0) | (p.right ? BUTTON_RIGHT : 0) |
+                           (p.boost ? BUTTON_BOOST : 0) | (p.shield ? BUTTON_SHIELD : 0) |
+                           (p.usePointer ? BUTTON_POINTER : 0));
+}
+
+void putPaddleInput(std::vector<unsigned char>& out, const PaddleInput& p) {
+    out.push_back(packButtons(p));
+    if (p.usePointer) {
+        putF32(out, p.pointerX);
+        putF32(out, p.pointerY);
+    }
+}
+
+bool samePaddleInput(const PaddleInput& a, const PaddleInput& b) {
+    if (packButtons(a) != packButtons(b)) return false;
+    // The pointer only matters to the simulation while it is in use
+    if (!a.usePointer) return true;
+    return std::memcmp(&a.pointerX, &b.pointerX, sizeof(float)) == 0 &&
+           std::memcmp(&a.pointerY, &b.pointerY, sizeof(float)) == 0;
+}
+
+static bool sameConfig(const MatchConfig& a, const MatchConfig& b) {
+    return a.width == b.width && a.height == b.height && a.mode == b.mode &&
+           a.freeMovement == b.freeMovement && a.autoBoost == b.autoBoost &&
+           a.shieldEnabled == b.shieldEnabled && a.maxHealth == b.maxHealth &&
+           a.targetScore == b.targetScore && a.aiControlled1 == b.aiControlled1 &&
+           a.aiControlled2 == b.aiControlled2 && a.aiDifficulty1 == b.aiDifficulty1 &&
+           a.aiDifficulty2 == b.aiDifficulty2 && a.ballCount == b.ballCount;
+}
+
+void ReplayRecorder::begin(unsigned int matchSeed, int rate) {
+    records.clear();
+    seed = matchSeed;
+    tickRate = rate;
+    ticks = 0;
+    lastRecordTick = 0;
+    checksum = 0;
+    recording = true;
+    sealed = false;
+}
+
+void ReplayRecorder::record(const MatchConfig& cfg, const MatchInput& in) {
+    if (!recording) {
+        return;
+    }
+    unsigned char flags = 0;
+    if (ticks == 0) {
+        flags = RECORD_INPUT | RECORD_CONFIG;
+    } else {
+        if (!samePaddleInput(in.p1, lastInput.p1) || !samePaddleInput(in.p2, lastInput.p2)) {
+            flags |= RECORD_INPUT;
+        }
+        if (!sameConfig(cfg, lastConfig)) {
+            flags |= RECORD_CONFIG;
+        }
+    }
+
+    if (flags) {
+        putVarint(records, ticks - lastRecordTick);
+        records.push_back(flags);
+        if (flags & RECORD_INPUT) {
+            putPaddleInput(records, in.p1);
+            putPaddleInput(records, in.p2);
+            lastInput = in;
+        }
+        if (flags & RECORD_CONFIG) {
+            putMatchConfig(records, cfg);
+            lastConfig = cfg;
+        }
+        lastRecordTick = ticks;
+    }
+    ++ticks;
+}
+
+void ReplayRecorder::finish(const MatchState& s) {
+    if (!recording) {
+        return;
+    }
+    checksum = matchChecksum(s);
+    recording = false;
+    sealed = true;
+}
+
+bool ReplayRecorder::save(const char* path) const {
+    if (!sealed || ticks == 0) {
+        return false;
+    }
+    std::vector<unsigned char> header;
+    header.insert(header.end(), ReplayMagic, ReplayMagic + 4);
+    putU32(header, ReplayVersion);
+    putU32(header, seed);
+    putU32(header, (unsigned int)tickRate);
+    putU32(header, ticks);
+    putU32(header, checksum);
+
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) {
+        std::fprintf(stderr, "Replay: cannot write '%s'\n", path);
+        return false;
+    }
+    std::fwrite(header.data(), 1, header.size(), f);
+    std::fwrite(records.data(), 1, records.size(), f);
+    bool ok = std::ferror(f) == 0;
+    std::fclose(f);
+    if (!ok) {
+        std::fprintf(stderr, "Replay: write error on '%s'\n", path);
+    }
+    return ok;
+}
+
+unsigned char ByteReader::u8() {
+    if (pos >= data.size()) { ok = false; return 0; }
+    return data[pos++];
+}
+
+unsigned int ByteReader::u32() {
+    unsigned int v = 0;
+    for (int i = 0; i < 4; ++i) v |= (unsigned int)u8() << (i * 8);
+    return v;
+}
+
+float ByteReader::f32() {
+    unsigned int bits = u32();
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+unsigned int ByteReader::varint() {
+    unsigned int v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        unsigned char c = u8();
+        v |= (unsigned int)(c & 0x7F) << shift;
+        if (!(c & 0x80)) return v;
+    }
+    ok = false;
+    return 0;
+}
+
+void ByteReader::paddleInput(PaddleInput& p) {
+    unsigned char buttons = u8();
+    p = PaddleInput();
+    p.up = (buttons & BUTTON_UP) != 0;
+    p.down = (buttons & BUTTON_DOWN) != 0;
+    p.left = (buttons & BUTTON_LEFT) != 0;
+    p.right = (buttons & BUTTON_RIGHT) != 0;
+    p.boost = (buttons & BUTTON_BOOST) != 0;
+    p.shield = (buttons & BUTTON_SHIELD) != 0;
+    p.usePointer = (buttons & BUTTON_POINTER) != 0;
+    if (p.usePointer) {
+        p.pointerX = f32();
+        p.pointerY = f32();
+    }
+}
+
+void ByteReader::config(MatchConfig& c) {
+    c.width = (int)u32();
+    c.height = (int)u32();
+    c.mode = (GameMode)u32();
+    c.freeMovement = u32() != 0;
+    c.autoBoost = u32() != 0;
+    c.shieldEnabled = u32() != 0;
+    c.maxHealth = (int)u32();
+    c.targetScore = (int)u32();
+    c.aiControlled1 = u32() != 0;
+    c.aiControlled2 = u32() != 0;
+    c.aiDifficulty1 = (AIDifficulty)u32();
+    c.aiDifficulty2 = (AIDifficulty)u32();
+    c.ballCount = (int)u32();
+}
+
+bool ReplayPlayer::load(const char* path) {
+    loaded = false;
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        std::fprintf(stderr, "Replay: cannot open '%s'\n", path);
+        return false;
+    }
+    std::vector<unsigned char> file;
+    unsigned char chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        file.insert(file.end(), chunk, chunk + n);
+    }
+    std::fclose(f);
+
+    if (file.size() < HeaderBytes || std::memcmp(file.data(), ReplayMagic, 4) != 0) {
+        std::fprintf(stderr, "Replay: '%s' is not a replay file\n", path);
+        return false;
+    }
+    size_t pos = 4;
+    ByteReader header{ file, pos };
+    unsigned int version = header.u32();
+    if (version != ReplayVersion) {
+        std::fprintf(stderr, "Replay: '%s' has version %u, expected %u\n", path, version, ReplayVersion);
+        return false;
+    }
+    seed = header.u32();
+    rate = (int)header.u32();
+    ticks = header.u32();
+    expectedChecksum = header.u32();
+    // Playing back at any other rate than the one recorded would diverge
+    if (rate < MinTickRate || rate > MaxTickRate) {
+        std::fprintf(stderr, "Replay: '%s' was recorded at an unsupported %d Hz\n", path, rate);
+        return false;
+    }
+    records.assign(file.begin() + (std::ptrdiff_t)HeaderBytes, file.end());
+
+    // The first record always carries the starting config
+    readPos = 0;
+    nextRecordTick = 0;
+    if (!readRecord() || nextRecordTick != 0 || !(pendingFlags & RECORD_CONFIG)) {
+        std::fprintf(stderr, "Replay: '%s' is truncated or corrupt\n", path);
+        return false;
+    }
+    firstConfig = pendingConfig;
+    loaded = true;
+    return true;
+}
+
+bool ReplayPlayer::readRecord() {
+    haveRecord = false;
+    if (readPos >= records.size()) {
+        return false;
+    }
+    ByteReader in{ records, readPos };
+    unsigned int delta = in.varint();
+    pendingFlags = in.u8();
+    if (pendingFlags & RECORD_INPUT) {
+        in.paddleInput(pendingInput.p1);
+        in.paddleInput(pendingInput.p2);
+    }
+    if (pendingFlags & RECORD_CONFIG) {
+        in.config(pendingConfig);
+    }
+    // A config the game could not have played is corruption, not a rule change
+    if (!in.ok || ((pendingFlags & RECORD_CONFIG) && !validMatchConfig(pendingConfig))) {
+        return false;
+    }
+    nextRecordTick += delta;
+    haveRecord = true;
+    return true;
+}
+
+void ReplayPlayer::restart(MatchState& s) {
+    readPos = 0;
+    nextRecordTick = 0;
+    played = 0;
+    config = firstConfig;
+    input = MatchInput();
+    readRecord();
+    resetMatch(s, firstConfig, seed);
+}
+
+bool ReplayPlayer::next(MatchConfig& cfg, MatchInput& in) {
+    if (!loaded || played >= ticks) {
+        return false;
+    }
+    if (haveRecord && nextRecordTick == played) {
+        if (pendingFlags & RECORD_INPUT) input = pendingInput;
+        if (pendingFlags & RECORD_CONFIG) config = pendingConfig;
+        readRecord();
+    }
+    cfg = config;
+    in = input;
+    ++played;
+    return true;
+}
+
+bool verifyReplay(const char* path) {
+    ReplayPlayer replay;
+    if (!replay.load(path)) {
+        return false;
+    }
+    MatchState s;
+    replay.restart(s);
+    const float dt = 1.0f / (float)replay.tickRate();
+    MatchConfig cfg;
+    MatchInput in;
+    while (replay.next(cfg, in)) {
+        stepMatch(s, cfg, in, dt);
+    }
+
+    bool ok = replay.matches(s);
+    std::printf("%s: %u ticks at %d Hz, final score %d-%d: %s\n", path, replay.tickCount(),
+                replay.tickRate(), s.score1, s.score2, ok ? "replay matches" : "REPLAY DIVERGED");
+    return ok;
+}
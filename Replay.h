@@ -0,0 +1,114 @@
+#pragma once
+#include "Simulation.h"
+#include <cstddef>
+#include <vector>
+
+// Match replays. The simulation is deterministic given its seed, config and
+// per-tick inputs, so a replay stores exactly those: the seed and tick rate in
+// a header, then a record for every tick whose MatchInput or MatchConfig
+// differs from the previous tick (ticks where nothing changed cost nothing).
+// A checksum of the final MatchState is stored too, so playback can prove it
+// re-simulated bit-exactly. Headless like Simulation: no SDL.
+//
+// File layout, little-endian:
+//   "PPRP" u32 version, u32 seed, u32 tickRate, u32 tickCount, u32 checksum
+//   records: varint tickDelta, u8 flags (1 = input, 2 = config), payloads
+//   input payload, per paddle: u8 buttons [, f32 pointerX, f32 pointerY]
+//   config payload: the MatchConfig fields as u32
+
+static const char* const ReplayLastMatchPath = "last_match.ppr";
+
+// FNV-1a over every gameplay field of the state
+unsigned int matchChecksum(const MatchState& s);
+
+// Little-endian encoding behind the records; netplay and spectator packets reuse it
+void putU32(std::vector<unsigned char>& out, unsigned int v);
+void putF32(std::vector<unsigned char>& out, float v);
+void putVarint(std::vector<unsigned char>& out, unsigned int v);
+void putPaddleInput(std::vector<unsigned char>& out, const PaddleInput& p);
+void putMatchConfig(std::vector<unsigned char>& out, const MatchConfig& c);
+// Same controls as far as the simulation can tell
+bool samePaddleInput(const PaddleInput& a, const PaddleInput& b);
+
+// Bounds-checked reader; a short read clears `ok` and yields zeros
+struct ByteReader {
+    const std::vector<unsigned char>& data;
+    std::size_t& pos;
+    bool ok = true;
+
+    unsigned char u8();
+    unsigned int u32();
+    float f32();
+    unsigned int varint();
+    void paddleInput(PaddleInput& p);
+    void config(MatchConfig& c);
+};
+
+class ReplayRecorder {
+public:
+    // Call right after resetMatch(s, cfg, seed)
+    void begin(unsigned int seed, int tickRate);
+    // Once per tick, with exactly what is passed to stepMatch
+    void record(const MatchConfig& cfg, const MatchInput& in);
+    // Seal the recording with the state after the last recorded tick
+    void finish(const MatchState& s);
+
+    bool isRecording() const { return recording; }
+    unsigned int tickCount() const { return ticks; }
+    bool save(const char* path) const;
+
+private:
+    std::vector<unsigned char> records;
+    MatchConfig lastConfig = {};
+    MatchInput lastInput = {};
+    unsigned int seed = 0;
+    int tickRate = 0;
+    unsigned int ticks = 0;
+    unsigned int lastRecordTick = 0;
+    unsigned int checksum = 0;
+    bool recording = false;
+    bool sealed = false;
+};
+
+class ReplayPlayer {
+public:
+    bool load(const char* path);
+    bool isLoaded() const { return loaded; }
+
+    int tickRate() const { return rate; }
+    unsigned int tickCount() const { return ticks; }
+    const MatchConfig& initialConfig() const { return firstConfig; }
+
+    // resetMatch with the recorded seed and first config; rewinds the input stream
+    void restart(MatchState& s);
+    // Config and input for the next tick; false once every recorded tick was played
+    bool next(MatchConfig& cfg, MatchInput& in);
+    bool atEnd() const { return played >= ticks; }
+    // After the last tick: does the state match the one that was recorded?
+    bool matches(const MatchState& s) const { return matchChecksum(s) == expectedChecksum; }
+
+private:
+    bool readRecord();
+
+    std::vector<unsigned char> records;
+    std::size_t readPos = 0;
+    unsigned int nextRecordTick = 0;   // tick the pending record applies to
+    bool haveRecord = false;
+    unsigned char pendingFlags = 0;
+    MatchConfig pendingConfig = {};
+    MatchInput pendingInput = {};
+
+    MatchConfig firstConfig = {};
+    MatchConfig config = {};
+    MatchInput input = {};
+    unsigned int seed = 0;
+    int rate = 0;
+    unsigned int ticks = 0;
+    unsigned int played = 0;
+    unsigned int expectedChecksum = 0;
+    bool loaded = false;
+};
+
+// Re-simulate a replay file without any window or GL context and check the
+// final state; prints the verdict, returns true when it matched
+bool verifyReplay(const char* path);
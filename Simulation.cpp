@@ -0,0 +1,1077 @@
+#include "Simulation.h"
+#include "Profiler.h"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+static inline bool aabbOverlap(float ax, float ay, float aw, float ah,
+                               float bx, float by, float bw, float bh) {
+    return (ax < bx + bw) && (ax + aw > bx) && (ay < by + bh) && (ay + ah > by);
+}
+
+static inline void tickDown(float& timer, float dt) {
+    if (timer > 0.0f) {
+        timer -= dt;
+        if (timer < 0.0f) timer = 0.0f;
+    }
+}
+
+static const AIProfile kAIPresets[] = {
+    // behaviour  speed reaction predict drift advance aimError
+    { AI_EASY,    0.55f, 2.0f,   0.4f,   0.15f, 0.05f,  0.0f },
+    { AI_MEDIUM,  0.75f, 3.5f,   0.75f,  0.35f, 0.15f,  0.0f },
+    { AI_HARD,    0.95f, 5.0f,   1.0f,   0.55f, 0.25f,  0.0f },
+};
+
+const AIProfile& aiPreset(AIDifficulty difficulty) {
+    return (difficulty >= AI_EASY && difficulty <= AI_HARD) ? kAIPresets[difficulty] : kAIPresets[AI_HARD];
+}
+
+static const AIProfile& aiProfileFor(const MatchConfig& cfg, int side) {
+    const AIProfile* profile = (side == 1) ? cfg.aiProfile1 : cfg.aiProfile2;
+    return profile ? *profile : aiPreset((side == 1) ? cfg.aiDifficulty1 : cfg.aiDifficulty2);
+}
+
+BallPath ballPathFrom(const SimBall& b, int fieldHeight) {
+    BallPath p = {};
+    p.x0 = b.x;
+    p.y0 = b.y;
+    p.velX = b.velX;
+    p.velY = b.velY;
+    p.top = (float)b.radius;
+    p.bottom = (float)(fieldHeight - b.radius);
+    return p;
+}
+
+BallArrival predictArrival(const BallPath& path, float x) {
+    BallArrival a = {};
+    a.x = x;
+    a.serial = path.serial;
+    a.y = path.y0;
+    if (path.velX == 0.0f) {
+        return a;
+    }
+    a.time = (x - path.x0) / path.velX;
+    a.valid = (a.time >= 0.0f);
+
+    // Bounces mirror the court, so unfold the line into a stack of mirrored bands,
+    // find which band the unfolded y lands in, and fold it back: odd bands are flipped
+    float span = path.bottom - path.top;
+    if (span <= 0.0f) {
+        return a;
+    }
+    float u = path.y0 + path.velY * a.time - path.top;
+    float bands = u / span;
+    int bandIndex = (int)bands;
+    if ((float)bandIndex > bands) bandIndex--;   // floor
+    float offset = u - (float)bandIndex * span;  // 0..span within that band
+    a.y = path.top + ((bandIndex & 1) ? span - offset : offset);
+    a.wallBounces = bandIndex < 0 ? -bandIndex : bandIndex;
+    return a;
+}
+
+// A ball's velocity changed (hit, bounce or serve): re-anchor its path there
+static void rebuildBallPath(MatchState& s, const MatchConfig& cfg, SimBall& b) {
+    b.path = ballPathFrom(b, cfg.height);
+    b.path.serial = ++s.pathSerial;
+}
+
+// A ball's arrival at an AI paddle's face; recomputed only when that ball's path
+// has changed, another ball became the target, or the paddle stepped sideways
+static const BallArrival& arrivalAtPaddle(MatchState& s, int side, const SimBall& b) {
+    const SimPaddle& pad = (side == 1) ? s.paddle1 : s.paddle2;
+    BallArrival& cached = (side == 1) ? s.aiArrival1 : s.aiArrival2;
+    float r = (float)b.radius;
+    float faceX = (side == 1) ? pad.x + (float)pad.width + r : pad.x - r;
+    if (cached.serial != b.path.serial || cached.x != faceX) {
+        cached = predictArrival(b.path, faceX);
+    }
+    return cached;
+}
+
+// The ball that will reach this side's paddle soonest. With a single ball that is
+// always balls[0], coming or going; in multi-ball, balls[0] when none is coming.
+static int incomingBall(const MatchState& s, int side) {
+    if (s.ballCount <= 1) return 0;
+    const SimPaddle& pad = (side == 1) ? s.paddle1 : s.paddle2;
+    float faceX = (side == 1) ? pad.x + (float)pad.width : pad.x;
+    int best = 0;
+    bool found = false;
+    float bestTime = 0.0f;
+    for (int i = 0; i < s.ballCount; ++i) {
+        const SimBall& b = s.balls[i];
+        bool toward = (side == 2) ? (b.velX > 0.0f) : (b.velX < 0.0f);
+        if (!toward) continue;
+        float t = (faceX - b.x) / b.velX;
+        if (t >= 0.0f && (!found || t < bestTime)) {
+            best = i;
+            bestTime = t;
+            found = true;
+        }
+    }
+    return best;
+}
+
+void serveBall(MatchState& s, const MatchConfig& cfg, int index) {
+    SimBall& b = s.balls[index];
+    b.radius = BallRadius;
+    b.x = cfg.width * 0.5f;
+    b.y = cfg.height * 0.5f;
+    if (index > 0) {
+        // Extra balls spread over the middle so a big pool doesn't start as one clump
+        b.x += s.rng.range(-0.15f, 0.15f) * (float)cfg.width;
+        b.y = s.rng.range((float)b.radius, (float)(cfg.height - b.radius));
+    }
+    b.trailBoost = 0.0f;
+    b.rallyEnergy = 0.0f;
+    b.leftImpactTimer = 0.0f;
+    b.rightImpactTimer = 0.0f;
+    b.topImpactTimer = 0.0f;
+    b.bottomImpactTimer = 0.0f;
+    b.isPiercing = false;
+    b.wallBounceCount = 0;
+    // Randomize initial direction slightly
+    float dirX = (s.rng.below(2) == 0) ? 1.0f : -1.0f;
+    float dirY = s.rng.range(-1.0f, 1.0f);
+    float speed = 450.0f;
+    b.velX = dirX * speed;
+    b.velY = dirY * (speed * 0.4f);
+    rebuildBallPath(s, cfg, b);
+}
+
+static int configuredBallCount(const MatchConfig& cfg) {
+    if (cfg.ballCount < 1) return 1;
+    return cfg.ballCount > MaxBalls ? MaxBalls : cfg.ballCount;
+}
+
+bool validMatchConfig(const MatchConfig& cfg) {
+    if (cfg.width < MinCourtWidth || cfg.width > MaxCourtWidth) return false;
+    if (cfg.height < MinCourtHeight || cfg.height > MaxCourtHeight) return false;
+    if (cfg.mode != MODE_CLASSIC && cfg.mode != MODE_BATTLE) return false;
+    if (cfg.aiDifficulty1 < AI_EASY || cfg.aiDifficulty1 > AI_HARD) return false;
+    if (cfg.aiDifficulty2 < AI_EASY || cfg.aiDifficulty2 > AI_HARD) return false;
+    if (cfg.ballCount < 1 || cfg.ballCount > MaxBalls) return false;
+    // Battle starts both sides at maxHealth, so 0 would be a KO on the first step.
+    // targetScore 0 is endless, which either mode may play.
+    if (cfg.mode == MODE_BATTLE && cfg.maxHealth < 1) return false;
+    return cfg.maxHealth >= 0 && cfg.targetScore >= 0;
+}
+
+void resetMatch(MatchState& s, const MatchConfig& cfg, unsigned int seed) {
+    s = MatchState();
+    s.rng.seed(seed, RNG_STREAM_GAMEPLAY);
+
+    s.paddle1.width = PaddleWidth;
+    s.paddle1.height = PaddleHeight;
+    s.paddle1.speed = PaddleSpeed;
+    s.paddle1.x = PaddleInset;
+    s.paddle1.y = (float)(cfg.height - PaddleHeight) * 0.5f;
+
+    s.paddle2 = s.paddle1;
+    s.paddle2.x = (float)cfg.width - PaddleInset - (float)PaddleWidth;
+
+    s.ballCount = configuredBallCount(cfg);
+    for (int i = 0; i < s.ballCount; ++i) {
+        s.balls[i].lastScoreX = cfg.width * 0.5f;
+        s.balls[i].lastScoreY = cfg.height * 0.5f;
+        serveBall(s, cfg, i);
+    }
+
+    s.health1 = cfg.maxHealth;
+    s.health2 = cfg.maxHealth;
+}
+
+void pushEvent(SimEvents& q, const SimEvent& e) {
+    q.kinds |= e.type;
+    if (q.count == MaxQueuedEvents) {
+        ++q.dropped;
+        return;
+    }
+    q.queue[q.count++] = e;
+}
+
+// Queue an event for this step if the caller asked for them
+static void raiseEvent(SimEvents* q, MatchEvent type, int side, int ball, float x, float y) {
+    if (q) {
+        pushEvent(*q, SimEvent{ type, (short)side, (short)ball, x, y });
+    }
+}
+
+// Resolve a paddle hit: reflect, speed up, apply piercing damage or shield deflect.
+// dirX is +1 when the ball leaves toward the right (left paddle) and -1 otherwise.
+static void bounceOffPaddle(MatchState& s, const MatchConfig& cfg, SimEvents* q, SimBall& b, const SimPaddle& p,
+                            float dirX, int& health, bool& shieldHeld, float& boost) {
+    float paddleCenterY = p.y + p.height * 0.5f;
+    float hitPos = (b.y - paddleCenterY) / (p.height * 0.5f); // -1..1
+    float speed = std::sqrt(b.velX * b.velX + b.velY * b.velY);
+
+    // Rally speed boost: increase speed on each hit (capped at 900)
+    float baseSpeed = 380.0f;
+    speed = speed * 1.03f; // 3% increase per hit
+    if (speed < baseSpeed) speed = baseSpeed;
+    if (speed > MaxBallSpeed) speed = MaxBallSpeed;
+
+    b.velX = dirX * std::fabs(speed * 0.95f);
+    b.velY = hitPos * speed * 0.8f;
+
+    b.trailBoost = 1.0f;
+    b.rallyEnergy += 0.3f;
+    if (b.rallyEnergy > 1.0f) b.rallyEnergy = 1.0f;
+    if (dirX > 0.0f) b.leftImpactTimer = 0.12f;
+    else b.rightImpactTimer = 0.12f;
+    int side = dirX > 0.0f ? 1 : 2;
+    int index = (int)(&b - s.balls);
+    raiseEvent(q, EVENT_PADDLE_HIT, side, index, b.x, b.y);
+
+    // Deal damage if ball was piercing (red ricochet) - Battle Mode only
+    // Shield blocks piercing damage and adds speed boost
+    if (cfg.mode == MODE_BATTLE && b.isPiercing) {
+        if (shieldHeld) {
+            // Shield deflect: consume shield, no damage, speed boost
+            shieldHeld = false;
+            raiseEvent(q, EVENT_SHIELD_CONSUMED, side, index, b.x, b.y);
+            float spd = std::sqrt(b.velX * b.velX + b.velY * b.velY);
+            if (spd > 0.0f) {
+                float boosted = spd * ShieldSpeedBoost;
+                if (boosted > MaxBallSpeed) boosted = MaxBallSpeed;
+                float ratio = boosted / spd;
+                b.velX *= ratio;
+                b.velY *= ratio;
+            }
+        } else if (health > 0) {
+            health--;
+            raiseEvent(q, EVENT_HEALTH_LOSS, side, index, b.x, b.y);
+        }
+    }
+    b.isPiercing = false;
+    b.wallBounceCount = 0;
+
+    boost += BoostFillAmount;
+    if (boost > 1.0f) boost = 1.0f;
+}
+
+// Time of impact of a moving point against a box, via the slab method.
+// Returns false if the path over [0, tMax] never enters the box.
+static bool sweepPointBox(float px, float py, float vx, float vy, float tMax,
+                          float minX, float minY, float maxX, float maxY, float& tHit) {
+    float tEnter = 0.0f;
+    float tExit = tMax;
+
+    auto slab = [&](float p, float v, float lo, float hi) {
+        if (v == 0.0f) {
+            return p >= lo && p <= hi;
+        }
+        float t0 = (lo - p) / v;
+        float t1 = (hi - p) / v;
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > tEnter) tEnter = t0;
+        if (t1 < tExit) tExit = t1;
+        return tEnter <= tExit;
+    };
+
+    if (!slab(px, vx, minX, maxX)) return false;
+    if (!slab(py, vy, minY, maxY)) return false;
+    tHit = tEnter;
+    return true;
+}
+
+// Time of impact of a moving point against a circle. A point already inside
+// counts as t = 0. Returns false if the path over [0, tMax] never reaches it.
+static bool sweepPointCircle(float px, float py, float vx, float vy, float tMax,
+                             float cx, float cy, float r, float& tHit) {
+    float mx = px - cx, my = py - cy;
+    float c = mx * mx + my * my - r * r;
+    if (c <= 0.0f) {
+        tHit = 0.0f;
+        return true;
+    }
+    float b = mx * vx + my * vy;
+    if (b >= 0.0f) return false;                  // outside and moving away
+    float a = vx * vx + vy * vy;
+    float disc = b * b - a * c;
+    if (disc < 0.0f) return false;
+    float t = (-b - std::sqrt(disc)) / a;
+    if (t > tMax) return false;
+    tHit = t;
+    return true;
+}
+
+// Earliest contact of the ball with a paddle's front face within tMax. The paddle is
+// the AABB grown by the ball radius, with its corners rounded to that radius; a ball
+// already overlapping it counts as t = 0.
+static bool sweepBallPaddle(const SimBall& b, const SimPaddle& p, float dirX, float tMax, float& tHit) {
+    // Only a ball travelling into the face can hit it; one leaving is already resolved
+    if (b.velX * dirX >= 0.0f) return false;
+    float r = (float)b.radius;
+    float right = p.x + p.width, bottom = p.y + p.height;
+    if (!sweepPointBox(b.x, b.y, b.velX, b.velY, tMax, p.x - r, p.y - r, right + r, bottom + r, tHit)) {
+        return false;
+    }
+    // Entering the grown box beside an edge is a hit. Entering one of its corner
+    // squares is only a hit if the path reaches the circle round the paddle corner;
+    // a path that misses it leaves the box through the same square.
+    float hx = b.x + b.velX * tHit;
+    float hy = b.y + b.velY * tHit;
+    bool cornerX = hx < p.x || hx > right;
+    bool cornerY = hy < p.y || hy > bottom;
+    if (!cornerX || !cornerY) return true;
+    float cx = (hx < p.x) ? p.x : right;
+    float cy = (hy < p.y) ? p.y : bottom;
+    return sweepPointCircle(b.x, b.y, b.velX, b.velY, tMax, cx, cy, r, tHit);
+}
+
+// The ball is heading somewhere new: the AI it now approaches picks how far off
+// its intercept will be. Profiles without aim error never touch the rng.
+static void rollAimError(MatchState& s, const MatchConfig& cfg, const SimBall& b) {
+    int side = (b.velX > 0.0f) ? 2 : 1;
+    bool ai = (side == 1) ? cfg.aiControlled1 : cfg.aiControlled2;
+    float spread = ai ? aiProfileFor(cfg, side).aimError : 0.0f;
+    float error = (spread > 0.0f) ? s.rng.range(-spread, spread) : 0.0f;
+    if (side == 1) s.aiAimError1 = error;
+    else s.aiAimError2 = error;
+}
+
+static void scoreGoal(MatchState& s, const MatchConfig& cfg, SimEvents* q, int index, int scorer, float x) {
+    SimBall& b = s.balls[index];
+    b.lastScoreX = x;
+    b.lastScoreY = b.y;
+    if (scorer == 1) s.score1++;
+    else s.score2++;
+    raiseEvent(q, EVENT_GOAL, scorer, index, x, b.y);
+    serveBall(s, cfg, index);
+}
+
+// Move one ball through its step. nearPaddles has bit 0/1 set for each paddle
+// the broadphase found within reach; the others are not swept at all.
+static void stepOneBall(MatchState& s, const MatchConfig& cfg, SimEvents* q, int index, unsigned int nearPaddles,
+                        float dt) {
+    SimBall& b = s.balls[index];
+    bool battleMode = (cfg.mode == MODE_BATTLE);
+    float r = (float)b.radius;
+    float top = r;
+    float bottom = (float)cfg.height - r;
+    bool bounced = false;
+    bool hitPaddle = false;
+
+    tickDown(b.trailBoost, dt * 1.5f);
+    tickDown(b.rallyEnergy, dt * 0.3f);
+    tickDown(b.leftImpactTimer, dt);
+    tickDown(b.rightImpactTimer, dt);
+    tickDown(b.topImpactTimer, dt);
+    tickDown(b.bottomImpactTimer, dt);
+
+    // Continuous collision: find the earliest wall or paddle contact in the remaining
+    // time, move the ball exactly there, respond, and repeat with what is left. Each
+    // paddle is hit at most once per step, so a corner shot can't rattle in place.
+    enum Contact { CONTACT_NONE, CONTACT_TOP, CONTACT_BOTTOM, CONTACT_PADDLE1, CONTACT_PADDLE2 };
+    const int MaxContacts = 4;
+    // Paddles the broadphase ruled out count as already done
+    bool paddle1Done = (nearPaddles & 1) == 0;
+    bool paddle2Done = (nearPaddles & 2) == 0;
+    float remaining = dt;
+
+    for (int i = 0; i < MaxContacts && remaining > 0.0f; ++i) {
+        Contact contact = CONTACT_NONE;
+        float tContact = remaining;
+
+        // Top/bottom walls
+        if (b.velY < 0.0f) {
+            float t = (b.y <= top) ? 0.0f : (top - b.y) / b.velY;
+            if (t <= tContact) { tContact = t; contact = CONTACT_TOP; }
+        } else if (b.velY > 0.0f) {
+            float t = (b.y >= bottom) ? 0.0f : (bottom - b.y) / b.velY;
+            if (t <= tContact) { tContact = t; contact = CONTACT_BOTTOM; }
+        }
+
+        // Paddles; a paddle hit at the same instant as a wall takes priority
+        float t;
+        if (!paddle1Done && sweepBallPaddle(b, s.paddle1, 1.0f, tContact, t)) {
+            tContact = t;
+            contact = CONTACT_PADDLE1;
+        }
+        if (!paddle2Done && sweepBallPaddle(b, s.paddle2, -1.0f, tContact, t)) {
+            tContact = t;
+            contact = CONTACT_PADDLE2;
+        }
+
+        b.x += b.velX * tContact;
+        b.y += b.velY * tContact;
+        remaining -= tContact;
+
+        if (contact == CONTACT_NONE) {
+            break;
+        } else if (contact == CONTACT_TOP || contact == CONTACT_BOTTOM) {
+            // Wall ricochet - ball becomes piercing (red)
+            if (contact == CONTACT_TOP) {
+                b.y = top;
+                b.topImpactTimer = 0.12f;
+            } else {
+                b.y = bottom;
+                b.bottomImpactTimer = 0.12f;
+            }
+            b.velY = -b.velY;
+            b.rallyEnergy += 0.15f;
+            if (b.rallyEnergy > 1.0f) b.rallyEnergy = 1.0f;
+            if (battleMode) {
+                b.isPiercing = true;
+                b.wallBounceCount++;
+            }
+            raiseEvent(q, EVENT_WALL_BOUNCE, 0, index, b.x, b.y);
+            bounced = true;
+        } else if (contact == CONTACT_PADDLE1) {
+            bounceOffPaddle(s, cfg, q, b, s.paddle1, 1.0f, s.health1, s.shieldHeld1, s.boostMeter1);
+            paddle1Done = true;
+            hitPaddle = true;
+        } else {
+            bounceOffPaddle(s, cfg, q, b, s.paddle2, -1.0f, s.health2, s.shieldHeld2, s.boostMeter2);
+            paddle2Done = true;
+            hitPaddle = true;
+        }
+    }
+
+    // Out of contacts for this step: coast the rest, kept inside the court vertically
+    if (remaining > 0.0f) {
+        b.x += b.velX * remaining;
+        b.y += b.velY * remaining;
+        if (b.y < top) b.y = top;
+        if (b.y > bottom) b.y = bottom;
+    }
+
+    // Scoring: left/right bounds
+    if (b.x + b.radius < 0.0f) {
+        scoreGoal(s, cfg, q, index, 2, 0.0f);
+        rollAimError(s, cfg, b);
+    } else if (b.x - b.radius > (float)cfg.width) {
+        scoreGoal(s, cfg, q, index, 1, (float)cfg.width);
+        rollAimError(s, cfg, b);
+    } else if (hitPaddle || bounced) {
+        rebuildBallPath(s, cfg, b);
+        if (hitPaddle) rollAimError(s, cfg, b);
+    }
+}
+
+// Uniform grid over the court for the multi-ball broadphase. Built with a counting
+// sort, so each cell's balls are one contiguous run of `items` and nothing is
+// allocated. Cells are at least two ball diameters wide, so any two touching balls
+// sit in the same or neighbouring cells.
+struct BallGrid {
+    static const int MaxCols = 64;
+    static const int MaxRows = 36;
+
+    float cellSize;
+    int cols, rows;
+    unsigned short cellStart[MaxCols * MaxRows + 1];
+    unsigned short items[MaxBalls];
+    unsigned short ballCell[MaxBalls];
+
+    void build(const MatchState& s, const MatchConfig& cfg) {
+        cellSize = (float)(BallRadius * 4);
+        if (cellSize < (float)cfg.width / MaxCols) cellSize = (float)cfg.width / MaxCols;
+        if (cellSize < (float)cfg.height / MaxRows) cellSize = (float)cfg.height / MaxRows;
+        cols = (int)((float)cfg.width / cellSize) + 1;
+        rows = (int)((float)cfg.height / cellSize) + 1;
+        cols = cols < 1 ? 1 : (cols > MaxCols ? MaxCols : cols);
+        rows = rows < 1 ? 1 : (rows > MaxRows ? MaxRows : rows);
+
+        const int cellCount = cols * rows;
+        for (int c = 0; c <= cellCount; ++c) cellStart[c] = 0;
+        for (int i = 0; i < s.ballCount; ++i) {
+            ballCell[i] = (unsigned short)cellAt(s.balls[i].x, s.balls[i].y);
+            cellStart[ballCell[i] + 1]++;
+        }
+        for (int c = 0; c < cellCount; ++c) cellStart[c + 1] += cellStart[c];
+        unsigned short fill[MaxCols * MaxRows];
+        for (int c = 0; c < cellCount; ++c) fill[c] = cellStart[c];
+        for (int i = 0; i < s.ballCount; ++i) items[fill[ballCell[i]]++] = (unsigned short)i;
+    }
+
+    int column(float x) const {
+        int c = (int)(x / cellSize);
+        return c < 0 ? 0 : (c >= cols ? cols - 1 : c);
+    }
+    int row(float y) const {
+        int r = (int)(y / cellSize);
+        return r < 0 ? 0 : (r >= rows ? rows - 1 : r);
+    }
+    int cellAt(float x, float y) const { return row(y) * cols + column(x); }
+};
+
+// Flag every ball whose cell overlaps the paddle's reach this step: the paddle box
+// grown by a ball radius plus the furthest any ball can travel in dt
+static void markBallsNearPaddle(const BallGrid& grid, const SimPaddle& p, float reach,
+                                unsigned int bit, unsigned char* nearPaddles) {
+    int c0 = grid.column(p.x - reach), c1 = grid.column(p.x + (float)p.width + reach);
+    int r0 = grid.row(p.y - reach), r1 = grid.row(p.y + (float)p.height + reach);
+    for (int row = r0; row <= r1; ++row) {
+        for (int col = c0; col <= c1; ++col) {
+            int cell = row * grid.cols + col;
+            for (int k = grid.cellStart[cell]; k < grid.cellStart[cell + 1]; ++k) {
+                nearPaddles[grid.items[k]] |= (unsigned char)bit;
+            }
+        }
+    }
+}
+
+// Equal-mass elastic contact: separate the pair, then swap the velocity components
+// along the line between centres if they are closing
+static void collideBallPair(MatchState& s, const MatchConfig& cfg, SimBall& a, SimBall& b) {
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float minDist = (float)(a.radius + b.radius);
+    float distSq = dx * dx + dy * dy;
+    if (distSq >= minDist * minDist) return;
+
+    float dist = std::sqrt(distSq);
+    float nx = 1.0f, ny = 0.0f;   // exactly coincident: split them sideways
+    if (dist > 0.0f) {
+        nx = dx / dist;
+        ny = dy / dist;
+    }
+    float push = (minDist - dist) * 0.5f;
+    a.x -= nx * push;
+    a.y -= ny * push;
+    b.x += nx * push;
+    b.y += ny * push;
+
+    float closing = (b.velX - a.velX) * nx + (b.velY - a.velY) * ny;
+    if (closing < 0.0f) {
+        a.velX += closing * nx;
+        a.velY += closing * ny;
+        b.velX -= closing * nx;
+        b.velY -= closing * ny;
+    }
+
+    // Keep both in the court and under the speed cap, then re-anchor their paths
+    auto settle = [&](SimBall& ball) {
+        float r = (float)ball.radius;
+        if (ball.y < r) ball.y = r;
+        if (ball.y > (float)cfg.height - r) ball.y = (float)cfg.height - r;
+        float speed = std::sqrt(ball.velX * ball.velX + ball.velY * ball.velY);
+        if (speed > MaxBallSpeed) {
+            ball.velX *= MaxBallSpeed / speed;
+            ball.velY *= MaxBallSpeed / speed;
+        }
+        rebuildBallPath(s, cfg, ball);
+    };
+    settle(a);
+    settle(b);
+}
+
+static void stepBalls(MatchState& s, const MatchConfig& cfg, SimEvents* q, float dt) {
+    PROFILE_SCOPE(PROFILE_BALL);
+    if (s.ballCount == 1) {
+        stepOneBall(s, cfg, q, 0, 3u, dt);
+        return;
+    }
+
+    // Broadphase: only balls in cells a paddle can reach this step run its sweep
+    BallGrid grid;
+    grid.build(s, cfg);
+    unsigned char nearPaddles[MaxBalls] = {};
+    float reach = (float)BallRadius + MaxBallSpeed * dt;
+    markBallsNearPaddle(grid, s.paddle1, reach, 1u, nearPaddles);
+    markBallsNearPaddle(grid, s.paddle2, reach, 2u, nearPaddles);
+
+    for (int i = 0; i < s.ballCount; ++i) {
+        stepOneBall(s, cfg, q, i, nearPaddles[i], dt);
+    }
+
+    // Ball-ball contacts at the new positions: each ball checks its own cell and the
+    // neighbours, and only pairs where it has the lower index
+    grid.build(s, cfg);
+    for (int i = 0; i < s.ballCount; ++i) {
+        int col = grid.ballCell[i] % grid.cols;
+        int row = grid.ballCell[i] / grid.cols;
+        for (int nr = row - 1; nr <= row + 1; ++nr) {
+            if (nr < 0 || nr >= grid.rows) continue;
+            for (int nc = col - 1; nc <= col + 1; ++nc) {
+                if (nc < 0 || nc >= grid.cols) continue;
+                int cell = nr * grid.cols + nc;
+                for (int k = grid.cellStart[cell]; k < grid.cellStart[cell + 1]; ++k) {
+                    int j = grid.items[k];
+                    if (j > i) collideBallPair(s, cfg, s.balls[i], s.balls[j]);
+                }
+            }
+        }
+    }
+}
+
+static void stepBoost(MatchState& s, const MatchConfig& cfg, SimEvents* q, int side, const PaddleInput& in, bool ai,
+                      float& meter, bool& active, float dt) {
+    // AI paddles never boost
+    if (ai) {
+        active = false;
+        return;
+    }
+
+    bool wasActive = active;
+    if (cfg.autoBoost) {
+        // Auto-boost: activate automatically when meter > 0
+        active = (meter > 0.0f);
+    } else {
+        // Manual boost: hold key while having meter
+        active = (in.boost && meter > 0.0f);
+    }
+    if (active && !wasActive) {
+        const SimPaddle& pad = side == 1 ? s.paddle1 : s.paddle2;
+        raiseEvent(q, EVENT_BOOST_START, side, -1, pad.x + pad.width * 0.5f, pad.y + pad.height * 0.5f);
+    }
+
+    // Drain boost meter while active
+    if (active) {
+        meter -= BoostDrainRate * dt;
+        if (meter <= 0.0f) {
+            meter = 0.0f;
+            active = false;
+        }
+    }
+}
+
+// Free movement x range for a paddle side
+static void paddleXRange(const MatchConfig& cfg, const SimPaddle& p, int side, float& xMin, float& xMax) {
+    if (side == 1) {
+        xMin = 0.0f;
+        xMax = (float)cfg.width * 0.45f - (float)p.width;
+    } else {
+        xMin = (float)cfg.width * 0.55f;
+        xMax = (float)cfg.width - (float)p.width;
+    }
+}
+
+static void stepShields(MatchState& s, const MatchConfig& cfg, SimEvents* q, const MatchInput& in, float dt) {
+    // Pickups follow whether any ball in play is piercing
+    bool anyPiercing = false;
+    for (int i = 0; i < s.ballCount && !anyPiercing; ++i) {
+        anyPiercing = s.balls[i].isPiercing;
+    }
+
+    // Tick down cooldowns (used in fixed movement mode)
+    tickDown(s.shieldCooldown1, dt);
+    tickDown(s.shieldCooldown2, dt);
+
+    if (cfg.freeMovement) {
+        // --- COLLECTIBLE SHIELD MODE ---
+        // Spawn pickups when ball is piercing, no active pickup, player doesn't hold one
+        float pickupSize = ShieldPickupSize;
+        float floatInset = 60.0f; // how far from wall edge the pickup floats to
+
+        auto spawnPickup = [&](ShieldPickup& pickup, bool held, float xMin, float xMax) {
+            if (pickup.active || held || !anyPiercing) return;
+            pickup.x = s.rng.range(xMin, xMax);
+            bool fromTop = (s.rng.below(2) == 0);
+            pickup.y = fromTop ? -pickupSize : (float)cfg.height + pickupSize;
+            pickup.targetY = fromTop ? floatInset : ((float)cfg.height - floatInset);
+            pickup.bobTimer = 0.0f;
+            pickup.active = true;
+        };
+
+        float p1XMin = 0.0f;
+        float p1XMax = (float)cfg.width * 0.45f - pickupSize;
+        float p2XMin = (float)cfg.width * 0.55f;
+        float p2XMax = (float)cfg.width - pickupSize;
+
+        spawnPickup(s.shieldPickup1, s.shieldHeld1, p1XMin, p1XMax);
+        spawnPickup(s.shieldPickup2, s.shieldHeld2, p2XMin, p2XMax);
+
+        // Animate pickups sliding in and bobbing
+        auto updatePickup = [&](ShieldPickup& pickup) {
+            if (!pickup.active) return;
+            // Slide toward target Y
+            float dy = pickup.targetY - pickup.y;
+            float slideSpeed = 200.0f;
+            if (std::fabs(dy) > 1.0f) {
+                float step = (dy > 0 ? 1.0f : -1.0f) * slideSpeed * dt;
+                if (std::fabs(step) > std::fabs(dy)) step = dy;
+                pickup.y += step;
+            }
+            pickup.bobTimer += dt;
+        };
+        updatePickup(s.shieldPickup1);
+        updatePickup(s.shieldPickup2);
+
+        // Despawn pickups if no ball is piercing any more
+        if (!anyPiercing) {
+            s.shieldPickup1.active = false;
+            s.shieldPickup2.active = false;
+        }
+
+        // Check paddle-pickup collection
+        auto checkCollect = [&](int side, ShieldPickup& pickup, const SimPaddle& pad, bool& held) {
+            if (!pickup.active || held) return;
+            float sx0 = pickup.x - pickupSize * 0.5f;
+            float sy0 = pickup.y - pickupSize * 0.5f;
+            if (aabbOverlap(pad.x, pad.y, (float)pad.width, (float)pad.height,
+                            sx0, sy0, pickupSize, pickupSize)) {
+                held = true;
+                pickup.active = false;
+                raiseEvent(q, EVENT_SHIELD_COLLECT, side, -1, pickup.x, pickup.y);
+            }
+        };
+        checkCollect(1, s.shieldPickup1, s.paddle1, s.shieldHeld1);
+        checkCollect(2, s.shieldPickup2, s.paddle2, s.shieldHeld2);
+    } else {
+        // --- FIXED MOVEMENT: KEY-ACTIVATED ONE-USE SHIELD ---
+        auto armShield = [&](int side, const PaddleInput& pin, bool ai,
+                             const SimPaddle& pad, bool& held, float cooldown) {
+            if (held || cooldown > 0.0f) return;
+            if (!ai) {
+                if (pin.shield) {
+                    held = true;
+                    raiseEvent(q, EVENT_SHIELD_ARMED, side, -1, pad.x + pad.width * 0.5f, pad.y + pad.height * 0.5f);
+                }
+                return;
+            }
+            const SimBall& b = s.balls[incomingBall(s, side)];
+            if (!b.isPiercing) return;
+            bool ballTowardAI = (side == 2) ? (b.velX > 0) : (b.velX < 0);
+            if (!ballTowardAI) return;
+            float dist = std::fabs(b.x - (pad.x + pad.width * 0.5f));
+            bool activate = false;
+            switch (aiProfileFor(cfg, side).behaviour) {
+                case AI_EASY: activate = false; break;
+                case AI_MEDIUM:
+                    activate = (dist < 200.0f && b.wallBounceCount + arrivalAtPaddle(s, side, b).wallBounces >= 2);
+                    break;
+                case AI_HARD: activate = (dist < 300.0f); break;
+            }
+            if (activate) {
+                held = true;
+                raiseEvent(q, EVENT_SHIELD_AI_ARMED, side, -1, pad.x + pad.width * 0.5f, pad.y + pad.height * 0.5f);
+            }
+        };
+        armShield(1, in.p1, cfg.aiControlled1, s.paddle1, s.shieldHeld1, s.shieldCooldown1);
+        armShield(2, in.p2, cfg.aiControlled2, s.paddle2, s.shieldHeld2, s.shieldCooldown2);
+    }
+}
+
+// Human control: pointer puts the paddle centre under the cursor, keys set velocity
+static void drivePlayerPaddle(const MatchConfig& cfg, SimPaddle& pad, int side, const PaddleInput& in) {
+    if (in.usePointer) {
+        float targetY = in.pointerY - pad.height * 0.5f;
+        if (targetY < 0.0f) targetY = 0.0f;
+        if (targetY > (float)(cfg.height - pad.height)) targetY = (float)(cfg.height - pad.height);
+        pad.y = targetY;
+        pad.vy = 0.0f;
+        if (cfg.freeMovement) {
+            float minX, maxX;
+            paddleXRange(cfg, pad, side, minX, maxX);
+            float targetX = in.pointerX - pad.width * 0.5f;
+            if (targetX < minX) targetX = minX;
+            if (targetX > maxX) targetX = maxX;
+            pad.x = targetX;
+            pad.vx = 0.0f;
+        }
+        return;
+    }
+
+    pad.vy = 0.0f;
+    pad.vx = 0.0f;
+    if (in.up)   pad.vy -= pad.speed;
+    if (in.down) pad.vy += pad.speed;
+    if (cfg.freeMovement) {
+        if (in.left)  pad.vx -= pad.speed;
+        if (in.right) pad.vx += pad.speed;
+    }
+}
+
+static void driveAIPaddle(MatchState& s, const MatchConfig& cfg, int side, const AIProfile& ai) {
+    PROFILE_SCOPE(PROFILE_AI);
+    SimPaddle& aiPaddle = (side == 1) ? s.paddle1 : s.paddle2;
+    const SimBall& ball = s.balls[incomingBall(s, side)];
+
+    float paddleCenterY = aiPaddle.y + aiPaddle.height * 0.5f;
+    int aiHealth = (side == 1) ? s.health1 : s.health2;
+    bool battleMode = (cfg.mode == MODE_BATTLE);
+
+    // Predictive AI: where the ball will be when it reaches the paddle face
+    float targetY = ball.y;
+    bool ballMovingTowardAI = (side == 2) ? (ball.velX > 0) : (ball.velX < 0);
+    if (ballMovingTowardAI) {
+        const BallArrival& arrival = arrivalAtPaddle(s, side, ball);
+        float timeToReach = (arrival.x - ball.x) / ball.velX;
+        if (arrival.valid && timeToReach > 0 && timeToReach < 2.0f) {
+            // Blend between current ball Y and predicted Y per profile
+            targetY = ball.y * (1.0f - ai.predictionBlend) + arrival.y * ai.predictionBlend;
+        }
+        targetY += (side == 1) ? s.aiAimError1 : s.aiAimError2;
+    } else {
+        // Ball moving away: drift toward ready position (screen center)
+        float readyY = (float)cfg.height * 0.5f;
+        targetY = ball.y * (1.0f - ai.driftBlend) + readyY * ai.driftBlend;
+    }
+
+    // AI shield pickup seeking - runs BEFORE dodge logic so it can override
+    bool aiHasShield = (side == 1) ? s.shieldHeld1 : s.shieldHeld2;
+    bool seekingShield = false;
+    float shieldTargetY = targetY;
+    float shieldTargetX = aiPaddle.x; // Only used in free movement
+    bool shieldOverrideDodge = false;
+
+    if (cfg.shieldEnabled && battleMode && ball.isPiercing && cfg.freeMovement) {
+        const ShieldPickup& aiPickup = (side == 1) ? s.shieldPickup1 : s.shieldPickup2;
+        if (aiPickup.active && !aiHasShield) {
+            float pickupCenterY = aiPickup.y;
+            float pickupCenterX = aiPickup.x;
+            float padCenterY = aiPaddle.y + aiPaddle.height * 0.5f;
+            float padCenterX = aiPaddle.x + aiPaddle.width * 0.5f;
+            float distY = std::fabs(pickupCenterY - padCenterY);
+            float distX = std::fabs(pickupCenterX - padCenterX);
+            float distTotal = std::sqrt(distX * distX + distY * distY);
+
+            switch (ai.behaviour) {
+                case AI_EASY:
+                    // Easy AI doesn't understand shield importance
+                    seekingShield = false;
+                    break;
+                case AI_MEDIUM: {
+                    // Medium AI seeks when pickup is reasonably close
+                    // More aggressive when health is low
+                    float seekRange = (aiHealth <= 2) ? 400.0f : 250.0f;
+                    seekingShield = (distTotal < seekRange);
+                    // Override dodge when critically low health
+                    shieldOverrideDodge = (aiHealth <= 2) && (distTotal < 300.0f);
+                    break;
+                }
+                case AI_HARD:
+                    // Hard AI always seeks aggressively
+                    seekingShield = true;
+                    // Only override dodge if shield is very close and worth the risk
+                    shieldOverrideDodge = (distTotal < 150.0f) || (aiHealth <= 2);
+                    break;
+            }
+
+            if (seekingShield) {
+                shieldTargetY = pickupCenterY;
+                shieldTargetX = pickupCenterX;
+            }
+        }
+    }
+
+    // Red ball avoidance in Battle Mode
+    // If AI already has a shield, don't dodge (stay and block)
+    bool shouldDodge = false;
+    if (battleMode && ball.isPiercing && ballMovingTowardAI && !aiHasShield) {
+        switch (ai.behaviour) {
+            case AI_EASY:
+                // Easy AI doesn't understand red ball danger
+                shouldDodge = false;
+                break;
+            case AI_MEDIUM:
+                // Medium AI dodges when health critical or the ball will arrive after many wall bounces
+                // But if we're seeking shield and health is critical, shield takes priority
+                if (!shieldOverrideDodge) {
+                    int bouncesOnArrival = ball.wallBounceCount + arrivalAtPaddle(s, side, ball).wallBounces;
+                    shouldDodge = (aiHealth <= 2) || (bouncesOnArrival >= 3);
+                }
+                break;
+            case AI_HARD:
+                // Hard AI always dodges unless shield override
+                if (!shieldOverrideDodge) {
+                    shouldDodge = true;
+                }
+                break;
+        }
+    }
+
+    if (shouldDodge) {
+        // Move away from predicted ball position
+        float dodgeDist = (float)aiPaddle.height * 1.5f;
+        float screenH = (float)cfg.height;
+        // Dodge toward whichever side has more room
+        if (targetY > screenH * 0.5f) {
+            targetY -= dodgeDist;
+        } else {
+            targetY += dodgeDist;
+        }
+        float halfH = (float)aiPaddle.height * 0.5f;
+        if (targetY < halfH) targetY = halfH;
+        if (targetY > screenH - halfH) targetY = screenH - halfH;
+    }
+
+    // If seeking shield, override targetY with shield position
+    // But blend if both dodge and shield seeking are active
+    if (seekingShield) {
+        if (shouldDodge && !shieldOverrideDodge) {
+            // Blend: 60% toward shield, 40% dodge direction
+            targetY = shieldTargetY * 0.6f + targetY * 0.4f;
+        } else {
+            // Full shield seeking
+            targetY = shieldTargetY;
+        }
+    }
+
+    float diff = targetY - paddleCenterY;
+
+    float maxSpeed = aiPaddle.speed * ai.speedMult;
+    float desiredVy = diff * ai.reactionMult;
+    if (desiredVy > maxSpeed) desiredVy = maxSpeed;
+    if (desiredVy < -maxSpeed) desiredVy = -maxSpeed;
+    aiPaddle.vy = desiredVy;
+
+    // AI horizontal movement in free movement mode
+    if (cfg.freeMovement) {
+        float aiDefaultX = (side == 2)
+            ? (float)(cfg.width - (int)PaddleInset - aiPaddle.width)
+            : PaddleInset;
+        float advanceTarget = aiDefaultX;
+
+        // If seeking shield, prioritize moving toward shield X
+        if (seekingShield) {
+            advanceTarget = shieldTargetX;
+        } else if (ballMovingTowardAI && !shouldDodge) {
+            float advanceFraction = ai.advanceFraction;
+            // Health-aware: advance less when health is low
+            if (battleMode && aiHealth <= 3) {
+                advanceFraction *= 0.3f;
+            }
+            float centerX = (float)cfg.width * 0.5f;
+            advanceTarget = aiDefaultX + (centerX - aiDefaultX) * advanceFraction;
+        }
+
+        float hDiff = advanceTarget - (aiPaddle.x + aiPaddle.width * 0.5f);
+        float hSpeed = hDiff * ai.reactionMult;
+        if (hSpeed > maxSpeed) hSpeed = maxSpeed;
+        if (hSpeed < -maxSpeed) hSpeed = -maxSpeed;
+        aiPaddle.vx = hSpeed;
+    } else {
+        aiPaddle.vx = 0.0f;
+    }
+}
+
+static void movePaddle(const MatchConfig& cfg, SimPaddle& pad, int side, float dt) {
+    pad.y += pad.vy * dt;
+    if (pad.y < 0.0f) pad.y = 0.0f;
+    if (pad.y > (float)(cfg.height - pad.height)) pad.y = (float)(cfg.height - pad.height);
+
+    if (cfg.freeMovement) {
+        float xMin, xMax;
+        paddleXRange(cfg, pad, side, xMin, xMax);
+        pad.x += pad.vx * dt;
+        if (pad.x < xMin) pad.x = xMin;
+        if (pad.x > xMax) pad.x = xMax;
+    }
+}
+
+void stepMatch(MatchState& s, const MatchConfig& cfg, const MatchInput& in, float dt, SimEvents* q) {
+    if (q) clearEvents(*q);
+    if (s.winner != 0) {
+        return;
+    }
+    s.tick++;
+
+    // Settings can change between steps (pause menu); bring the state in line
+    // here rather than from Game, so a replay of the same configs reproduces it
+    if (!cfg.freeMovement) {
+        s.paddle1.x = PaddleInset;
+        s.paddle2.x = (float)cfg.width - PaddleInset - (float)s.paddle2.width;
+    }
+    if (!cfg.shieldEnabled) {
+        s.shieldHeld1 = s.shieldHeld2 = false;
+        s.shieldCooldown1 = s.shieldCooldown2 = 0.0f;
+        s.shieldPickup1.active = s.shieldPickup2.active = false;
+    }
+    int ballCount = configuredBallCount(cfg);
+    if (ballCount != s.ballCount) {
+        // Extra balls join from the middle; dropped ones are the highest indices.
+        // Joining balls start from nothing: snapshots don't keep unused slots.
+        for (int i = s.ballCount; i < ballCount; ++i) {
+            s.balls[i] = SimBall();
+            serveBall(s, cfg, i);
+        }
+        s.ballCount = ballCount;
+    }
+
+    bool battleMode = (cfg.mode == MODE_BATTLE);
+
+    stepBoost(s, cfg, q, 1, in.p1, cfg.aiControlled1, s.boostMeter1, s.boostActive1, dt);
+    stepBoost(s, cfg, q, 2, in.p2, cfg.aiControlled2, s.boostMeter2, s.boostActive2, dt);
+
+    // Shield system (Battle Mode only when enabled)
+    if (cfg.shieldEnabled && battleMode) {
+        stepShields(s, cfg, q, in, dt);
+    }
+
+    // Apply boost multiplier to paddle speeds temporarily
+    s.paddle1.speed = PaddleSpeed * (s.boostActive1 ? BoostMultiplier : 1.0f);
+    s.paddle2.speed = PaddleSpeed * (s.boostActive2 ? BoostMultiplier : 1.0f);
+
+    if (cfg.aiControlled1) driveAIPaddle(s, cfg, 1, aiProfileFor(cfg, 1));
+    else drivePlayerPaddle(cfg, s.paddle1, 1, in.p1);
+    if (cfg.aiControlled2) driveAIPaddle(s, cfg, 2, aiProfileFor(cfg, 2));
+    else drivePlayerPaddle(cfg, s.paddle2, 2, in.p2);
+
+    movePaddle(cfg, s.paddle1, 1, dt);
+    movePaddle(cfg, s.paddle2, 2, dt);
+
+    s.paddle1.speed = PaddleSpeed;
+    s.paddle2.speed = PaddleSpeed;
+
+    bool s1Before = s.shieldHeld1;
+    bool s2Before = s.shieldHeld2;
+    stepBalls(s, cfg, q, dt);
+    // Start cooldown when shield is consumed (fixed mode only)
+    if (!cfg.freeMovement && cfg.shieldEnabled && battleMode) {
+        if (s1Before && !s.shieldHeld1) s.shieldCooldown1 = ShieldCooldown;
+        if (s2Before && !s.shieldHeld2) s.shieldCooldown2 = ShieldCooldown;
+    }
+
+    // KO win condition (health depleted) - Battle Mode only
+    if (battleMode && (s.health1 <= 0 || s.health2 <= 0)) {
+        s.winner = (s.health2 <= 0) ? 1 : 2;
+        s.koWin = true;
+        raiseEvent(q, EVENT_MATCH_OVER, s.winner, -1, 0.0f, 0.0f);
+        return;
+    }
+
+    // Competitive win condition if a score target is set
+    if (cfg.targetScore > 0 && (s.score1 >= cfg.targetScore || s.score2 >= cfg.targetScore)) {
+        s.winner = (s.score1 > s.score2) ? 1 : 2;
+        s.koWin = false;
+        raiseEvent(q, EVENT_MATCH_OVER, s.winner, -1, 0.0f, 0.0f);
+    }
+}
+
+static unsigned int snapshotBytes(const MatchState& s) {
+    return (unsigned int)(offsetof(MatchState, balls) + (size_t)s.ballCount * sizeof(SimBall));
+}
+
+void saveSnapshot(const MatchState& s, MatchSnapshot& out, unsigned int tick) {
+    out.tick = tick;
+    out.size = snapshotBytes(s);
+    std::memcpy(out.data, &s, out.size);
+}
+
+void restoreSnapshot(const MatchSnapshot& snap, MatchState& s) {
+    std::memcpy(&s, snap.data, snap.size);
+}
+
+void copyMatchState(const MatchState& from, MatchState& to) {
+    std::memcpy(&to, &from, snapshotBytes(from));
+}
+
+void SnapshotRing::reset(int capacity) {
+    slots.resize(capacity > 0 ? (size_t)capacity : 0);
+    for (MatchSnapshot& slot : slots) {
+        slot.tick = 0;
+        slot.size = 0;
+    }
+}
+
+void SnapshotRing::save(unsigned int tick, const MatchState& s) {
+    if (slots.empty()) return;
+    saveSnapshot(s, slots[tick % slots.size()], tick);
+}
+
+const MatchSnapshot* SnapshotRing::find(unsigned int tick) const {
+    if (slots.empty()) return nullptr;
+    const MatchSnapshot& slot = slots[tick % slots.size()];
+    return (slot.size != 0 && slot.tick == tick) ? &slot : nullptr;
+}
+
+bool SnapshotRing::restore(unsigned int tick, MatchState& s) const {
+    const MatchSnapshot* snap = find(tick);
+    if (!snap) return false;
+    restoreSnapshot(*snap, s);
+    return true;
+}
@@ -0,0 +1,261 @@
+#pragma once
+#include "Random.h"
+#include <vector>
+
+// Headless match simulation: ball, paddles, boost meters, shields, health and scoring.
+// Pure C++ with no SDL, OpenGL or audio dependencies and no heap allocation - a
+// MatchState is stepped from a MatchInput, and Game only maps keys in and events out.
+
+enum GameMode { MODE_CLASSIC = 0, MODE_BATTLE = 1 };
+enum AIDifficulty { AI_EASY = 0, AI_MEDIUM = 1, AI_HARD = 2 };
+
+// Gameplay events raised by a step (bit flags, cleared at the start of every step)
+enum MatchEvent {
+    EVENT_PADDLE_HIT      = 1 << 0,   // Ball hit a paddle
+    EVENT_WALL_BOUNCE     = 1 << 1,   // Ball bounced off top/bottom wall
+    EVENT_GOAL            = 1 << 2,   // Someone scored (ball has been re-served)
+    EVENT_HEALTH_LOSS     = 1 << 3,   // Piercing ball damaged a paddle
+    EVENT_BOOST_START     = 1 << 4,   // A boost was activated
+    EVENT_SHIELD_ARMED    = 1 << 5,   // Human armed the key-activated shield
+    EVENT_SHIELD_AI_ARMED = 1 << 6,   // AI armed the key-activated shield
+    EVENT_SHIELD_COLLECT  = 1 << 7,   // Shield pickup collected (free movement)
+    EVENT_SHIELD_CONSUMED = 1 << 8,   // Held shield absorbed a piercing hit
+    EVENT_MATCH_OVER      = 1 << 9    // winner is now set
+};
+
+// One event with its details; a step queues them in a SimEvents in the order
+// they happen, for audio, effects and tools to consume afterwards
+struct SimEvent {
+    MatchEvent type;     // exactly one flag
+    short side;          // paddle it concerns: 1 or 2 (the scorer for a goal, the winner at match end), 0 = none
+    short ball;          // index into MatchState::balls, -1 = none
+    float x, y;          // where it happened
+};
+
+// Tuning shared by the simulation and the HUD
+constexpr int PaddleWidth = 16;
+constexpr int PaddleHeight = 120;
+constexpr float PaddleSpeed = 600.0f;
+constexpr float PaddleInset = 40.0f;
+constexpr int BallRadius = 10;
+constexpr float BoostMultiplier = 1.6f;
+constexpr float BoostDrainRate = 0.8f;
+constexpr float BoostFillAmount = 0.25f;
+constexpr float ShieldCooldown = 3.0f;
+constexpr float ShieldSpeedBoost = 1.3f;
+constexpr float ShieldPickupSize = 18.0f;
+constexpr float MaxBallSpeed = 900.0f;
+constexpr int MaxBalls = 256;        // multi-ball pool size
+constexpr int MaxQueuedEvents = 64;  // per-step queued events; SimEvents::kinds still flags every kind raised
+constexpr int MinCourtWidth = 320;   // court size accepted from files and the network
+constexpr int MinCourtHeight = 240;
+constexpr int MaxCourtWidth = 7680;
+constexpr int MaxCourtHeight = 4320;
+constexpr int MinTickRate = 30;      // fixed-step rates the game runs at (Hz)
+constexpr int MaxTickRate = 1000;
+
+struct SimPaddle {
+    float x, y;
+    int width, height;
+    float speed;
+    float vx, vy;
+};
+
+// The ball's straight line since its velocity last changed, with the band its
+// centre reflects in. stepMatch rebuilds it only when the velocity changes, so
+// queries against it between hits and bounces are a few flops each.
+struct BallPath {
+    float x0, y0;        // anchor: where the ball was when the velocity changed
+    float velX, velY;
+    float top, bottom;   // ball-centre reflection band (radius in from each wall)
+    unsigned int serial; // unique per rebuild within a match, so derived caches can tell
+};
+
+// Where a path crosses a given x, wall reflections folded in
+struct BallArrival {
+    float x;
+    float time;          // seconds from the path's anchor; < 0 if x is behind it
+    float y;             // ball centre on arrival
+    int wallBounces;     // top/bottom bounces on the way, i.e. piercing hits added
+    bool valid;          // false when the ball never reaches x (moving away, or still)
+    unsigned int serial; // path serial it was computed from
+};
+
+struct SimBall {
+    float x, y;
+    float velX, velY;
+    float trailBoost;
+    float rallyEnergy;
+    float leftImpactTimer;
+    float rightImpactTimer;
+    float topImpactTimer;
+    float bottomImpactTimer;
+    float lastScoreX;
+    float lastScoreY;
+    int radius;
+    bool isPiercing;
+    int wallBounceCount;
+    BallPath path;       // rebuilt on every hit, bounce and serve
+};
+
+struct ShieldPickup {
+    float x, y;
+    float targetY;       // where it floats to after spawning
+    float bobTimer;
+    bool active;
+};
+
+// One player's controls for a single step
+struct PaddleInput {
+    bool up, down, left, right;
+    bool boost;
+    bool shield;
+    bool usePointer;     // paddle centre follows the pointer instead of the keys
+    float pointerX, pointerY;
+};
+
+struct MatchInput {
+    PaddleInput p1;
+    PaddleInput p2;
+};
+
+// Numeric tuning for one AI paddle; each difficulty is a preset of these. The
+// dodge and shield-seek rules stay keyed on `behaviour`.
+struct AIProfile {
+    AIDifficulty behaviour;
+    float speedMult;         // fraction of paddle speed
+    float reactionMult;      // how hard it closes on its target (1/s)
+    float predictionBlend;   // 0 = chase the ball, 1 = go to the intercept
+    float driftBlend;        // pull toward centre while the ball is moving away
+    float advanceFraction;   // free movement: how far it steps in to meet the ball
+    float aimError;          // +/- px of intercept error, re-drawn per return; 0 = exact
+};
+
+// The profile behind each AIDifficulty
+const AIProfile& aiPreset(AIDifficulty difficulty);
+
+// Match rules; cheap to rebuild every step so settings can change mid-game
+struct MatchConfig {
+    int width, height;
+    GameMode mode;
+    bool freeMovement;
+    bool autoBoost;
+    bool shieldEnabled;
+    int maxHealth;
+    int targetScore;     // 0 = endless
+    int ballCount;       // balls in play, 1..MaxBalls (0 plays as 1)
+    bool aiControlled1;
+    bool aiControlled2;
+    AIDifficulty aiDifficulty1;
+    AIDifficulty aiDifficulty2;
+    // Tools only (not recorded in replays): use this profile instead of the preset
+    const AIProfile* aiProfile1;
+    const AIProfile* aiProfile2;
+};
+
+// False if a config from outside the process (a replay, a netplay host, a
+// broadcast) is out of range: court size, mode and difficulty enums, ballCount
+// in [1, MaxBalls], health of at least 1 in battle (non-negative otherwise), and a
+// non-negative target score (0 = endless)
+bool validMatchConfig(const MatchConfig& cfg);
+
+// Everything gameplay-relevant; plain data so it can be copied freely. The ball
+// pool stays the last member: snapshots copy the fields before it plus the
+// balls in play, not all MaxBalls.
+struct MatchState {
+    SimPaddle paddle1, paddle2;
+    int ballCount;
+
+    int score1, score2;
+    int health1, health2;
+
+    float boostMeter1, boostMeter2;
+    bool boostActive1, boostActive2;
+
+    bool shieldHeld1, shieldHeld2;
+    float shieldCooldown1, shieldCooldown2;  // fixed-mode: cooldown after consumption
+    ShieldPickup shieldPickup1, shieldPickup2;
+
+    float aiAimError1, aiAimError2;  // intercept offsets for the current return
+    BallArrival aiArrival1, aiArrival2;  // AI target ball at each AI paddle's face
+    unsigned int pathSerial;
+
+    int winner;          // 0 = still playing, 1 = P1, 2 = P2
+    bool koWin;
+
+    Rng rng;             // gameplay stream; effects draw from their own
+    unsigned int tick;
+
+    SimBall balls[MaxBalls];   // [0, ballCount) in play; the HUD and trails follow balls[0]
+};
+
+// What one step raised, in order: the only record of it. Output only, so it
+// lives outside MatchState and snapshots, rollback slots and replay
+// checkpoints never carry it. A goal's entry names the ball (re-served
+// already) and where it left the field.
+struct SimEvents {
+    SimEvent queue[MaxQueuedEvents];  // while there was room
+    int count;
+    int dropped;         // raised after the queue filled up
+    unsigned int kinds;  // MatchEvent flags of everything raised, queued or not
+};
+
+// Empty the queue (stepMatch does this itself at the start of a step)
+inline void clearEvents(SimEvents& q) {
+    q.count = 0;
+    q.dropped = 0;
+    q.kinds = 0;
+}
+// Append an event, or count it as dropped when the queue is full
+void pushEvent(SimEvents& q, const SimEvent& e);
+
+// A MatchState cut down to what is in use, as one fixed-size block of plain
+// data. Saving or restoring copies about 0.3 KB for a single-ball match.
+struct MatchSnapshot {
+    unsigned int tick;         // whatever the caller keyed it by
+    unsigned int size;         // bytes of `data` in use; 0 = empty
+    alignas(MatchState) unsigned char data[sizeof(MatchState)];
+};
+
+void saveSnapshot(const MatchState& s, MatchSnapshot& out, unsigned int tick);
+// Only balls [0, ballCount) are written back; the rest of s.balls is left alone
+void restoreSnapshot(const MatchSnapshot& snap, MatchState& s);
+// Read a snapshot in place, without restoring it; balls past ballCount are junk
+inline const MatchState& snapshotState(const MatchSnapshot& snap) {
+    return *reinterpret_cast<const MatchState*>(snap.data);
+}
+// Copy a state the way a snapshot does: everything before balls, then balls
+// [0, ballCount) only. Balls past ballCount in `to` keep whatever they held.
+void copyMatchState(const MatchState& from, MatchState& to);
+
+// The last N snapshots by tick, allocated once up front
+class SnapshotRing {
+public:
+    explicit SnapshotRing(int capacity = 0) { reset(capacity); }
+    void reset(int capacity);          // (re)allocates, dropping everything saved
+    int capacity() const { return (int)slots.size(); }
+
+    void save(unsigned int tick, const MatchState& s);
+    // false if that tick was never saved or has been overwritten since
+    bool restore(unsigned int tick, MatchState& s) const;
+    const MatchSnapshot* find(unsigned int tick) const;
+
+private:
+    std::vector<MatchSnapshot> slots;
+};
+
+// Start a fresh match: paddles centred, full health, balls served from the middle
+void resetMatch(MatchState& s, const MatchConfig& cfg, unsigned int seed);
+
+// Re-serve a ball in a random direction: balls[0] from the centre, the rest of a
+// multi-ball pool from random spots across the middle of the court
+void serveBall(MatchState& s, const MatchConfig& cfg, int index);
+
+// Closed-form prediction: the path from a ball's current state, and where it
+// crosses x. No iteration, whatever the number of wall bounces.
+BallPath ballPathFrom(const SimBall& b, int fieldHeight);
+BallArrival predictArrival(const BallPath& path, float x);
+
+// Advance the match by dt seconds; pass `events` to get what it raised
+void stepMatch(MatchState& s, const MatchConfig& cfg, const MatchInput& in, float dt,
+               SimEvents* events = nullptr);
@@ -0,0 +1,556 @@
+#include "Spectator.h"
+#include "Replay.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char SpectatorMagic[4] = { 'P', 'P', 'S', 'B' };
+const unsigned int SpectatorVersion = 1;
+const int MaxPacketBytes = 65507;      // a full 256-ball frame is about 5 KB
+
+enum PacketType { PACKET_SUBSCRIBE = 1, PACKET_ACK, PACKET_FRAME };
+
+// Header field indices; ball blocks follow at HeaderFields + i * BallFields
+enum HeaderField {
+    H_PADDLE1_X, H_PADDLE1_Y, H_PADDLE1_W, H_PADDLE1_H,
+    H_PADDLE2_X, H_PADDLE2_Y, H_PADDLE2_W, H_PADDLE2_H,
+    H_SCORE1, H_SCORE2, H_HEALTH1, H_HEALTH2,
+    H_BOOST1, H_BOOST2, H_COOLDOWN1, H_COOLDOWN2,
+    H_PICKUP1_X, H_PICKUP1_Y, H_PICKUP1_BOB,
+    H_PICKUP2_X, H_PICKUP2_Y, H_PICKUP2_BOB,
+    H_FLAGS, H_WINNER, H_EVENTS,
+    H_GOAL_BALL, H_GOAL_X, H_GOAL_Y,
+    H_COUNT
+};
+static_assert(H_COUNT == SpectatorFrame::HeaderFields, "header field count");
+
+enum BallField { B_X, B_Y, B_VEL_X, B_VEL_Y, B_TRAIL, B_RALLY, B_IMPACT, B_FLAGS, B_COUNT };
+static_assert(B_COUNT == SpectatorFrame::BallFields, "ball field count");
+
+// H_FLAGS bits
+enum {
+    FLAG_BOOST1 = 1 << 0, FLAG_BOOST2 = 1 << 1,
+    FLAG_SHIELD1 = 1 << 2, FLAG_SHIELD2 = 1 << 3,
+    FLAG_PICKUP1 = 1 << 4, FLAG_PICKUP2 = 1 << 5,
+    FLAG_KO = 1 << 6
+};
+
+// Positions in 1/4 px, unit meters in 1/255, timers in 1/100 s
+const float PositionScale = 4.0f;
+const float MeterScale = 255.0f;
+const float TimerScale = 100.0f;
+
+typedef std::chrono::steady_clock Clock;
+
+int msSince(Clock::time_point t) {
+    return (int)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - t).count();
+}
+
+int quantize(float v, float scale) {
+    return (int)std::lround(v * scale);
+}
+
+float unquantize(int v, float scale) {
+    return (float)v / scale;
+}
+
+// Impact flashes last 0.12 s: four 4-bit centisecond counters in one field
+int packImpacts(const SimBall& b) {
+    auto nibble = [](float t) {
+        int c = quantize(t, TimerScale);
+        return c < 0 ? 0 : (c > 15 ? 15 : c);
+    };
+    return nibble(b.leftImpactTimer) | nibble(b.rightImpactTimer) << 4 |
+           nibble(b.topImpactTimer) << 8 | nibble(b.bottomImpactTimer) << 12;
+}
+
+unsigned int zigzag(int v) {
+    return ((unsigned int)v << 1) ^ (unsigned int)(v >> 31);
+}
+
+int unzigzag(unsigned int v) {
+    return (int)(v >> 1) ^ -(int)(v & 1);
+}
+
+// Fields a frame doesn't carry (balls past its count) read as zero
+int fieldOf(const SpectatorFrame* frame, int i) {
+    return frame && i < frame->fieldCount ? frame->fields[i] : 0;
+}
+
+bool sameAddress(const NetAddress& a, const NetAddress& b) {
+    return a.ip == b.ip && a.port == b.port;
+}
+
+void beginPacket(std::vector<unsigned char>& out, unsigned char type) {
+    out.assign(SpectatorMagic, SpectatorMagic + 4);
+    out.push_back(type);
+}
+
+bool hasMagic(const std::vector<unsigned char>& bytes) {
+    return bytes.size() >= 5 && std::memcmp(bytes.data(), SpectatorMagic, 4) == 0;
+}
+
+} // namespace
+
+void quantizeFrame(const MatchState& s, SpectatorFrame& out) {
+    int* f = out.fields;
+    auto paddle = [&](int at, const SimPaddle& p) {
+        f[at] = quantize(p.x, PositionScale);
+        f[at + 1] = quantize(p.y, PositionScale);
+        f[at + 2] = p.width;
+        f[at + 3] = p.height;
+    };
+    auto pickup = [&](int at, const ShieldPickup& p) {
+        f[at] = quantize(p.x, PositionScale);
+        f[at + 1] = quantize(p.y, PositionScale);
+        f[at + 2] = quantize(p.bobTimer, TimerScale);
+    };
+    paddle(H_PADDLE1_X, s.paddle1);
+    paddle(H_PADDLE2_X, s.paddle2);
+    f[H_SCORE1] = s.score1;
+    f[H_SCORE2] = s.score2;
+    f[H_HEALTH1] = s.health1;
+    f[H_HEALTH2] = s.health2;
+    f[H_BOOST1] = quantize(s.boostMeter1, MeterScale);
+    f[H_BOOST2] = quantize(s.boostMeter2, MeterScale);
+    f[H_COOLDOWN1] = quantize(s.shieldCooldown1, TimerScale);
+    f[H_COOLDOWN2] = quantize(s.shieldCooldown2, TimerScale);
+    pickup(H_PICKUP1_X, s.shieldPickup1);
+    pickup(H_PICKUP2_X, s.shieldPickup2);
+    f[H_FLAGS] = (s.boostActive1 ? FLAG_BOOST1 : 0) | (s.boostActive2 ? FLAG_BOOST2 : 0) |
+                 (s.shieldHeld1 ? FLAG_SHIELD1 : 0) | (s.shieldHeld2 ? FLAG_SHIELD2 : 0) |
+                 (s.shieldPickup1.active ? FLAG_PICKUP1 : 0) | (s.shieldPickup2.active ? FLAG_PICKUP2 : 0) |
+                 (s.koWin ? FLAG_KO : 0);
+    f[H_WINNER] = s.winner;
+    // Events aren't part of the state; the publisher fills this block in
+    f[H_EVENTS] = 0;
+    f[H_GOAL_BALL] = 0;
+    f[H_GOAL_X] = 0;
+    f[H_GOAL_Y] = 0;
+
+    int balls = s.ballCount < 1 ? 1 : (s.ballCount > MaxBalls ? MaxBalls : s.ballCount);
+    for (int i = 0; i < balls; ++i) {
+        const SimBall& b = s.balls[i];
+        int* bf = f + SpectatorFrame::HeaderFields + i * SpectatorFrame::BallFields;
+        bf[B_X] = quantize(b.x, PositionScale);
+        bf[B_Y] = quantize(b.y, PositionScale);
+        bf[B_VEL_X] = quantize(b.velX, 1.0f);
+        bf[B_VEL_Y] = quantize(b.velY, 1.0f);
+        bf[B_TRAIL] = quantize(b.trailBoost, MeterScale);
+        bf[B_RALLY] = quantize(b.rallyEnergy, MeterScale);
+        bf[B_IMPACT] = packImpacts(b);
+        bf[B_FLAGS] = (b.isPiercing ? 1 : 0) | b.wallBounceCount << 1;
+    }
+    out.matchTick = s.tick;
+    out.fieldCount = SpectatorFrame::HeaderFields + balls * SpectatorFrame::BallFields;
+}
+
+void dequantizeFrame(const SpectatorFrame& frame, MatchState& out) {
+    const int* f = frame.fields;
+    auto paddle = [&](int at, SimPaddle& p) {
+        p = SimPaddle();
+        p.x = unquantize(f[at], PositionScale);
+        p.y = unquantize(f[at + 1], PositionScale);
+        p.width = f[at + 2];
+        p.height = f[at + 3];
+        p.speed = PaddleSpeed;
+    };
+    auto pickup = [&](int at, int flag, ShieldPickup& p) {
+        p.x = unquantize(f[at], PositionScale);
+        p.y = unquantize(f[at + 1], PositionScale);
+        p.targetY = p.y;
+        p.bobTimer = unquantize(f[at + 2], TimerScale);
+        p.active = (f[H_FLAGS] & flag) != 0;
+    };
+    paddle(H_PADDLE1_X, out.paddle1);
+    paddle(H_PADDLE2_X, out.paddle2);
+    out.score1 = f[H_SCORE1];
+    out.score2 = f[H_SCORE2];
+    out.health1 = f[H_HEALTH1];
+    out.health2 = f[H_HEALTH2];
+    out.boostMeter1 = unquantize(f[H_BOOST1], MeterScale);
+    out.boostMeter2 = unquantize(f[H_BOOST2], MeterScale);
+    out.boostActive1 = (f[H_FLAGS] & FLAG_BOOST1) != 0;
+    out.boostActive2 = (f[H_FLAGS] & FLAG_BOOST2) != 0;
+    out.shieldHeld1 = (f[H_FLAGS] & FLAG_SHIELD1) != 0;
+    out.shieldHeld2 = (f[H_FLAGS] & FLAG_SHIELD2) != 0;
+    out.shieldCooldown1 = unquantize(f[H_COOLDOWN1], TimerScale);
+    out.shieldCooldown2 = unquantize(f[H_COOLDOWN2], TimerScale);
+    pickup(H_PICKUP1_X, FLAG_PICKUP1, out.shieldPickup1);
+    pickup(H_PICKUP2_X, FLAG_PICKUP2, out.shieldPickup2);
+    out.aiAimError1 = out.aiAimError2 = 0.0f;
+    out.aiArrival1 = out.aiArrival2 = BallArrival();
+    out.pathSerial = 0;
+    out.winner = f[H_WINNER];
+    out.koWin = (f[H_FLAGS] & FLAG_KO) != 0;
+    out.rng = Rng();
+    // The last goal the publisher sent stands in for every ball's last score
+    float goalX = unquantize(f[H_GOAL_X], PositionScale);
+    float goalY = unquantize(f[H_GOAL_Y], PositionScale);
+    out.tick = frame.matchTick;
+
+    int balls = (frame.fieldCount - SpectatorFrame::HeaderFields) / SpectatorFrame::BallFields;
+    out.ballCount = balls < 1 ? 1 : balls;
+    for (int i = 0; i < balls; ++i) {
+        const int* bf = f + SpectatorFrame::HeaderFields + i * SpectatorFrame::BallFields;
+        SimBall& b = out.balls[i];
+        b = SimBall();
+        b.x = unquantize(bf[B_X], PositionScale);
+        b.y = unquantize(bf[B_Y], PositionScale);
+        b.velX = (float)bf[B_VEL_X];
+        b.velY = (float)bf[B_VEL_Y];
+        b.trailBoost = unquantize(bf[B_TRAIL], MeterScale);
+        b.rallyEnergy = unquantize(bf[B_RALLY], MeterScale);
+        b.leftImpactTimer = unquantize(bf[B_IMPACT] & 15, TimerScale);
+        b.rightImpactTimer = unquantize(bf[B_IMPACT] >> 4 & 15, TimerScale);
+        b.topImpactTimer = unquantize(bf[B_IMPACT] >> 8 & 15, TimerScale);
+        b.bottomImpactTimer = unquantize(bf[B_IMPACT] >> 12 & 15, TimerScale);
+        b.lastScoreX = goalX;
+        b.lastScoreY = goalY;
+        b.radius = BallRadius;
+        b.isPiercing = (bf[B_FLAGS] & 1) != 0;
+        b.wallBounceCount = bf[B_FLAGS] >> 1;
+    }
+}
+
+bool SpectatorPublisher::open(unsigned short port) {
+    close();
+    if (!socket.open(port)) {
+        return false;
+    }
+    history.assign(HistoryDepth, SpectatorFrame());
+    viewers.clear();
+    configBytes.clear();
+    configSince = 0;
+    nextSeq = 1;
+    pendingEvents = 0;
+    lastGoal = SimEvent();
+    havePublished = false;
+    ticksSinceSend = 0;
+    counters = Stats();
+    std::printf("Broadcasting to spectators on UDP port %u\n", (unsigned)socket.localPort());
+    return true;
+}
+
+void SpectatorPublisher::close() {
+    socket.close();
+    viewers.clear();
+    history.clear();
+    history.shrink_to_fit();
+}
+
+void SpectatorPublisher::setSendInterval(int ticks) {
+    sendInterval = ticks < 1 ? 1 : ticks;
+}
+
+SpectatorPublisher::Viewer* SpectatorPublisher::findViewer(const NetAddress& address) {
+    for (Viewer& v : viewers) {
+        if (sameAddress(v.address, address)) return &v;
+    }
+    return nullptr;
+}
+
+void SpectatorPublisher::receive() {
+    NetAddress from;
+    for (;;) {
+        incoming.resize(MaxPacketBytes);
+        int n = socket.receive(incoming.data(), MaxPacketBytes, from);
+        if (n <= 0) {
+            break;
+        }
+        incoming.resize((size_t)n);
+        if (!hasMagic(incoming)) continue;
+
+        std::size_t pos = 5;
+        ByteReader r{ incoming, pos };
+        unsigned int value = r.u32();
+        if (!r.ok) continue;
+
+        Viewer* v = findViewer(from);
+        if (incoming[4] == PACKET_SUBSCRIBE) {
+            if (value != SpectatorVersion) continue;
+            if (!v) {
+                if ((int)viewers.size() >= MaxViewers) continue;
+                viewers.push_back(Viewer());
+                v = &viewers.back();
+                v->address = from;
+                v->ackSeq = 0;
+                v->lastFullSeq = 0;
+                std::printf("Spectator joined (%d watching)\n", (int)viewers.size());
+            }
+            v->lastHeard = Clock::now();
+        } else if (incoming[4] == PACKET_ACK && v) {
+            if (value > v->ackSeq && value < nextSeq) v->ackSeq = value;
+            v->lastHeard = Clock::now();
+        }
+    }
+
+    for (std::size_t i = 0; i < viewers.size();) {
+        if (msSince(viewers[i].lastHeard) > ViewerTimeoutMs) {
+            viewers.erase(viewers.begin() + (std::ptrdiff_t)i);
+            std::printf("Spectator left (%d watching)\n", (int)viewers.size());
+        } else {
+            ++i;
+        }
+    }
+}
+
+const SpectatorFrame* SpectatorPublisher::baselineFor(const Viewer& v) const {
+    if (v.ackSeq == 0 || v.ackSeq < configSince) {
+        return nullptr;
+    }
+    const SpectatorFrame& base = history[v.ackSeq % HistoryDepth];
+    return base.seq == v.ackSeq ? &base : nullptr;
+}
+
+void SpectatorPublisher::encode(const SpectatorFrame& frame, const SpectatorFrame* base, const MatchConfig& cfg) {
+    beginPacket(packet, PACKET_FRAME);
+    putU32(packet, frame.seq);
+    putVarint(packet, base ? frame.seq - base->seq : 0);
+    putVarint(packet, frame.matchTick);
+    putVarint(packet, (unsigned int)frame.fieldCount);
+    if (!base) putMatchConfig(packet, cfg);
+
+    std::size_t mask = packet.size();
+    packet.resize(mask + (std::size_t)(frame.fieldCount + 7) / 8, 0);
+    for (int i = 0; i < frame.fieldCount; ++i) {
+        int delta = (int)((unsigned int)frame.fields[i] - (unsigned int)fieldOf(base, i));
+        if (delta != 0) {
+            packet[mask + (std::size_t)(i >> 3)] |= (unsigned char)(1 << (i & 7));
+            putVarint(packet, zigzag(delta));
+        }
+    }
+}
+
+void SpectatorPublisher::publish(const MatchState& s, const MatchConfig& cfg, const SimEvents& events) {
+    if (!socket.isOpen()) {
+        return;
+    }
+    receive();
+
+    pendingEvents |= events.kinds;
+    for (int i = 0; i < events.count; ++i) {
+        if (events.queue[i].type == EVENT_GOAL) lastGoal = events.queue[i];
+    }
+    lastConfig = cfg;
+    havePublished = true;
+    // The final tick always goes out, so the win screen isn't a frame late
+    if (++ticksSinceSend < sendInterval && !(events.kinds & EVENT_MATCH_OVER)) {
+        return;
+    }
+    ticksSinceSend = 0;
+    sendFrame(s, cfg);
+}
+
+void SpectatorPublisher::idle(const MatchState& s) {
+    if (!socket.isOpen()) {
+        return;
+    }
+    receive();
+    if (!havePublished || ++ticksSinceSend < sendInterval) {
+        return;
+    }
+    ticksSinceSend = 0;
+    // The last tick's events already went out; only pending ones ride along
+    sendFrame(s, lastConfig);
+}
+
+void SpectatorPublisher::sendFrame(const MatchState& s, const MatchConfig& cfg) {
+    if (viewers.empty()) {
+        pendingEvents = 0;
+        return;
+    }
+
+    SpectatorFrame& frame = history[nextSeq % HistoryDepth];
+    quantizeFrame(s, frame);
+    frame.seq = nextSeq++;
+    frame.fields[H_EVENTS] = (int)pendingEvents;
+    frame.fields[H_GOAL_BALL] = lastGoal.ball;
+    frame.fields[H_GOAL_X] = quantize(lastGoal.x, PositionScale);
+    frame.fields[H_GOAL_Y] = quantize(lastGoal.y, PositionScale);
+    pendingEvents = 0;
+    ++counters.frames;
+
+    // New rules (a settings change, or the next match) invalidate every baseline
+    configScratch.clear();
+    putMatchConfig(configScratch, cfg);
+    if (configScratch != configBytes) {
+        configBytes.swap(configScratch);
+        configSince = frame.seq;
+    }
+
+    // Viewers acking the same frame share one encode
+    bool encoded = false;
+    unsigned int encodedBase = 0;
+    for (Viewer& v : viewers) {
+        const SpectatorFrame* base = baselineFor(v);
+        if (!base) {
+            // Nothing to delta against: a full frame now and then until one is acked
+            if (v.lastFullSeq != 0 && frame.seq - v.lastFullSeq < (unsigned int)FullFrameInterval) continue;
+            v.lastFullSeq = frame.seq;
+        }
+        unsigned int baseSeq = base ? base->seq : 0;
+        if (!encoded || encodedBase != baseSeq) {
+            encode(frame, base, cfg);
+            encoded = true;
+            encodedBase = baseSeq;
+        }
+        if (!socket.send(v.address, packet.data(), (int)packet.size())) {
+            ++counters.sendFailures;
+            continue;
+        }
+        if (base) ++counters.deltaPackets;
+        else ++counters.fullPackets;
+        counters.bytesSent += (unsigned int)packet.size();
+    }
+}
+
+bool SpectatorViewer::connect(const NetAddress& address) {
+    close();
+    if (!socket.open(0)) {
+        return false;
+    }
+    publisher = address;
+    history.assign(HistoryDepth + 1, SpectatorFrame());
+    latest = nullptr;
+    configBytes.clear();
+    cfgVersion = 0;
+    events = 0;
+    lastGoal = SimEvent();
+    received = 0;
+    heardAnything = false;
+    sendSubscribe();
+    return true;
+}
+
+void SpectatorViewer::close() {
+    socket.close();
+    latest = nullptr;
+    history.clear();
+    history.shrink_to_fit();
+}
+
+void SpectatorViewer::sendSubscribe() {
+    beginPacket(packet, PACKET_SUBSCRIBE);
+    putU32(packet, SpectatorVersion);
+    socket.send(publisher, packet.data(), (int)packet.size());
+    lastSubscribe = Clock::now();
+}
+
+bool SpectatorViewer::poll() {
+    if (!socket.isOpen()) {
+        return false;
+    }
+    bool fresh = false;
+    NetAddress from;
+    for (;;) {
+        incoming.resize(MaxPacketBytes);
+        int n = socket.receive(incoming.data(), MaxPacketBytes, from);
+        if (n <= 0) {
+            break;
+        }
+        incoming.resize((size_t)n);
+        if (!sameAddress(from, publisher) || !hasMagic(incoming) || incoming[4] != PACKET_FRAME) continue;
+        received += (unsigned int)n;
+        heardAnything = true;
+        lastHeard = Clock::now();
+        if (decodeFrame(incoming, 5)) fresh = true;
+    }
+    // Subscribing again is also the keepalive
+    if (msSince(lastSubscribe) >= SubscribeIntervalMs) {
+        sendSubscribe();
+    }
+    return fresh;
+}
+
+bool SpectatorViewer::publisherLost() const {
+    return heardAnything && msSince(lastHeard) > TimeoutMs;
+}
+
+bool SpectatorViewer::decodeFrame(const std::vector<unsigned char>& bytes, std::size_t pos) {
+    ByteReader r{ bytes, pos };
+    unsigned int seq = r.u32();
+    unsigned int back = r.varint();
+    unsigned int tick = r.varint();
+    unsigned int count = r.varint();
+    if (!r.ok || seq == 0 || back >= (unsigned int)HistoryDepth || back > seq ||
+        count < (unsigned int)SpectatorFrame::HeaderFields || count > (unsigned int)SpectatorFrame::MaxFields ||
+        (count - SpectatorFrame::HeaderFields) % SpectatorFrame::BallFields != 0) {
+        return false;
+    }
+    // Late or duplicated: the newer frame is already showing
+    if (latest && seq <= latest->seq) {
+        return false;
+    }
+
+    const SpectatorFrame* base = nullptr;
+    MatchConfig incomingCfg = {};
+    if (back == 0) {
+        r.config(incomingCfg);
+        // Anyone can send to the subscribed port; never adopt rules the game could not run
+        if (!r.ok || !validMatchConfig(incomingCfg)) return false;
+    } else {
+        base = &history[(seq - back) % HistoryDepth];
+        if (base->seq != seq - back) return false;
+    }
+
+    std::size_t maskBytes = (count + 7) / 8;
+    if (!r.ok || pos + maskBytes > bytes.size()) {
+        return false;
+    }
+    const unsigned char* mask = bytes.data() + pos;
+    pos += maskBytes;
+
+    SpectatorFrame& out = history[HistoryDepth];
+    for (int i = 0; i < (int)count; ++i) {
+        int value = fieldOf(base, i);
+        if (mask[i >> 3] & (1 << (i & 7))) {
+            value = (int)((unsigned int)value + (unsigned int)unzigzag(r.varint()));
+        }
+        out.fields[i] = value;
+    }
+    if (!r.ok) {
+        return false;
+    }
+    out.seq = seq;
+    out.matchTick = tick;
+    out.fieldCount = (int)count;
+
+    SpectatorFrame& slot = history[seq % HistoryDepth];
+    std::memcpy(&slot, &out, sizeof(slot));
+    latest = &slot;
+    events |= (unsigned int)slot.fields[H_EVENTS];
+    if (slot.fields[H_EVENTS] & EVENT_GOAL) {
+        lastGoal = SimEvent{ EVENT_GOAL, 0, (short)slot.fields[H_GOAL_BALL],
+                             unquantize(slot.fields[H_GOAL_X], PositionScale),
+                             unquantize(slot.fields[H_GOAL_Y], PositionScale) };
+    }
+
+    if (back == 0) {
+        configScratch.clear();
+        putMatchConfig(configScratch, incomingCfg);
+        if (configScratch != configBytes) {
+            configBytes.swap(configScratch);
+            cfg = incomingCfg;
+            ++cfgVersion;
+        }
+    }
+
+    beginPacket(packet, PACKET_ACK);
+    putU32(packet, seq);
+    socket.send(publisher, packet.data(), (int)packet.size());
+    return true;
+}
+
+void SpectatorViewer::latestState(MatchState& out) const {
+    if (latest) dequantizeFrame(*latest, out);
+}
+
+void SpectatorViewer::takeEvents(SimEvents& out) {
+    clearEvents(out);
+    if (events & EVENT_GOAL) pushEvent(out, lastGoal);
+    out.kinds = events;
+    events = 0;
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include "Netplay.h"
+#include <cstddef>
+#include <vector>
+
+// Live match broadcast for spectator screens. The publisher quantizes what a
+// viewer draws (positions to 1/4 px, meters to 8 bits, timers to 1/100 s,
+// bit-packed flags) into a flat array of integer fields every few ticks, and
+// sends each viewer the difference from the last frame that viewer
+// acknowledged: a bitmask of the fields that changed plus zigzag varint deltas.
+// A viewer without a usable baseline gets a full frame, at most every 16th
+// frame. Everything goes over the non-blocking UdpSocket, so a slow or
+// vanished viewer costs the game loop nothing but an encode.
+//
+// Packets, little-endian, all prefixed with "PPSB" u8 type:
+//   SUBSCRIBE (viewer -> publisher) u32 version; also the keepalive
+//   ACK       (viewer -> publisher) u32 seq
+//   FRAME     (publisher -> viewer) u32 seq, varint seq - baseSeq (0 = full
+//             frame, deltas against zeros), varint matchTick, varint fieldCount,
+//             [config if full], changed-field bitmask, zigzag varint delta
+//             per changed field
+
+static const unsigned short SpectatorDefaultPort = 7778;
+
+// One quantized frame: header fields, then a block of fields per ball
+struct SpectatorFrame {
+    static const int HeaderFields = 28;
+    static const int BallFields = 8;
+    static const int MaxFields = HeaderFields + MaxBalls * BallFields;
+
+    unsigned int seq;        // 0 = empty slot
+    unsigned int matchTick;
+    int fieldCount;
+    int fields[MaxFields];
+};
+
+class SpectatorPublisher {
+public:
+    static const int MaxViewers = 16;
+
+    SpectatorPublisher() = default;
+    ~SpectatorPublisher() { close(); }
+    SpectatorPublisher(const SpectatorPublisher&) = delete;
+    SpectatorPublisher& operator=(const SpectatorPublisher&) = delete;
+
+    bool open(unsigned short port);
+    void close();
+    bool isOpen() const { return socket.isOpen(); }
+    unsigned short localPort() const { return socket.localPort(); }
+
+    // Send a frame every Nth published tick (default 2); events raised on the
+    // ticks in between ride along with the next frame
+    void setSendInterval(int ticks);
+
+    // Once per simulated tick, with the config it was stepped with and what the
+    // step raised. Never blocks.
+    void publish(const MatchState& s, const MatchConfig& cfg, const SimEvents& events);
+    // Once per frame while the match isn't ticking (menus, the win screen):
+    // keeps viewers subscribed and showing s, without repeating its events
+    void idle(const MatchState& s);
+
+    int viewerCount() const { return (int)viewers.size(); }
+
+    struct Stats {
+        unsigned int frames;         // frames quantized
+        unsigned int deltaPackets, fullPackets;
+        unsigned int bytesSent;
+        unsigned int sendFailures;   // socket full or unreachable; the viewer catches up later
+    };
+    const Stats& stats() const { return counters; }
+
+private:
+    static const int HistoryDepth = 32;          // frames a viewer's ack can still delta against
+    static const int FullFrameInterval = 16;     // frames between full frames to a viewer with no baseline
+    static const int ViewerTimeoutMs = 5000;
+
+    struct Viewer {
+        NetAddress address;
+        unsigned int ackSeq;         // newest frame it confirmed, 0 = none
+        unsigned int lastFullSeq;    // 0 = none sent yet
+        std::chrono::steady_clock::time_point lastHeard;
+    };
+
+    void receive();
+    Viewer* findViewer(const NetAddress& address);
+    const SpectatorFrame* baselineFor(const Viewer& v) const;
+    void sendFrame(const MatchState& s, const MatchConfig& cfg);
+    void encode(const SpectatorFrame& frame, const SpectatorFrame* base, const MatchConfig& cfg);
+
+    UdpSocket socket;
+    std::vector<Viewer> viewers;
+    std::vector<SpectatorFrame> history;         // by seq % HistoryDepth, allocated on open
+    std::vector<unsigned char> packet;           // send scratch
+    std::vector<unsigned char> incoming;         // receive scratch
+    std::vector<unsigned char> configBytes;      // last config sent, serialized
+    std::vector<unsigned char> configScratch;
+    unsigned int configSince = 0;                // first frame under that config
+    unsigned int nextSeq = 1;
+    unsigned int pendingEvents = 0;
+    SimEvent lastGoal = {};
+    MatchConfig lastConfig = {};                 // what idle() sends with
+    bool havePublished = false;
+    int sendInterval = 2;
+    int ticksSinceSend = 0;
+    Stats counters = {};
+};
+
+class SpectatorViewer {
+public:
+    SpectatorViewer() = default;
+    ~SpectatorViewer() { close(); }
+    SpectatorViewer(const SpectatorViewer&) = delete;
+    SpectatorViewer& operator=(const SpectatorViewer&) = delete;
+
+    bool connect(const NetAddress& publisher);
+    void close();
+    bool isOpen() const { return socket.isOpen(); }
+
+    // Drain the socket and keep the subscription alive; true if a newer
+    // frame was decoded since the last call
+    bool poll();
+    bool hasFrame() const { return latest != nullptr; }
+    // Nothing heard for a few seconds
+    bool publisherLost() const;
+
+    const MatchConfig& config() const { return cfg; }
+    unsigned int configVersion() const { return cfgVersion; }
+    // The newest frame as a MatchState; only what is drawn is filled in
+    void latestState(MatchState& out) const;
+    // What every frame decoded since the last call raised. Frames carry event
+    // kinds only, plus the last goal's ball and position, so that is all `out`
+    // gets: the kinds, and one EVENT_GOAL entry if there was a goal.
+    void takeEvents(SimEvents& out);
+
+    unsigned int bytesReceived() const { return received; }
+
+private:
+    static const int HistoryDepth = 32;
+    static const int SubscribeIntervalMs = 500;
+    static const int TimeoutMs = 5000;
+
+    void sendSubscribe();
+    bool decodeFrame(const std::vector<unsigned char>& bytes, std::size_t pos);
+
+    UdpSocket socket;
+    NetAddress publisher = {};
+    // Decoded frames by seq % HistoryDepth, plus one scratch slot at the end
+    // to decode into, so a bad packet can't clobber a baseline
+    std::vector<SpectatorFrame> history;
+    const SpectatorFrame* latest = nullptr;
+    std::vector<unsigned char> packet;
+    std::vector<unsigned char> incoming;
+    std::vector<unsigned char> configBytes;
+    std::vector<unsigned char> configScratch;
+    MatchConfig cfg = {};
+    unsigned int cfgVersion = 0;                 // bumped whenever a full frame brings a different config
+    unsigned int events = 0;
+    SimEvent lastGoal = {};                      // from the newest frame that had a goal
+    unsigned int received = 0;
+    std::chrono::steady_clock::time_point lastHeard;
+    std::chrono::steady_clock::time_point lastSubscribe;
+    bool heardAnything = false;
+};
+
+// The drawn part of a state, quantized; exposed for tools that check the encoding
+void quantizeFrame(const MatchState& s, SpectatorFrame& out);
+// Rebuild a state from a frame. Only balls [0, ballCount) are written; what a
+// viewer never draws (AI targets, the rng, ball paths) is zeroed.
+void dequantizeFrame(const SpectatorFrame& frame, MatchState& out);
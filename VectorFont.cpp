@@ -0,0 +1,374 @@
+#include "VectorFont.h"
+#include "Renderer.h"
+#include <cmath>
+#include <cstring>
+
+// Stroke thickness in pixels (matches the old glLineWidth(2.0f) text)
+static const float kStrokeWidth = 2.0f;
+
+struct GlyphStroke {
+    char c;                 // 0 = fallback glyph for anything not listed
+    float x1, y1, x2, y2;
+};
+
+// Source strokes, grouped by glyph
+static const GlyphStroke kStrokes[] = {
+    { 'A', 0.0f, 1.0f, 0.5f, 0.0f },
+    { 'A', 1.0f, 1.0f, 0.5f, 0.0f },
+    { 'A', 0.2f, 0.5f, 0.8f, 0.5f },
+    { 'C', 0.8f, 0.0f, 0.2f, 0.0f },
+    { 'C', 0.2f, 0.0f, 0.2f, 1.0f },
+    { 'C', 0.2f, 1.0f, 0.8f, 1.0f },
+    { 'D', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'D', 0.0f, 0.0f, 0.6f, 0.2f },
+    { 'D', 0.6f, 0.2f, 0.6f, 0.8f },
+    { 'D', 0.6f, 0.8f, 0.0f, 1.0f },
+    { 'E', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'E', 0.0f, 0.0f, 0.8f, 0.0f },
+    { 'E', 0.0f, 0.5f, 0.7f, 0.5f },
+    { 'E', 0.0f, 1.0f, 0.8f, 1.0f },
+    { 'F', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'F', 0.0f, 0.0f, 0.8f, 0.0f },
+    { 'F', 0.0f, 0.5f, 0.7f, 0.5f },
+    { 'G', 0.2f, 0.0f, 0.8f, 0.0f },
+    { 'G', 0.2f, 0.0f, 0.2f, 1.0f },
+    { 'G', 0.2f, 1.0f, 0.8f, 1.0f },
+    { 'G', 0.8f, 1.0f, 0.8f, 0.5f },
+    { 'G', 0.8f, 0.5f, 0.5f, 0.5f },
+    { 'L', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'L', 0.0f, 1.0f, 0.8f, 1.0f },
+    { 'N', 0.0f, 1.0f, 0.0f, 0.0f },
+    { 'N', 0.0f, 0.0f, 1.0f, 1.0f },
+    { 'N', 1.0f, 1.0f, 1.0f, 0.0f },
+    { 'O', 0.2f, 0.0f, 0.8f, 0.0f },
+    { 'O', 0.2f, 1.0f, 0.8f, 1.0f },
+    { 'O', 0.2f, 0.0f, 0.2f, 1.0f },
+    { 'O', 0.8f, 0.0f, 0.8f, 1.0f },
+    { 'P', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'P', 0.0f, 0.0f, 0.7f, 0.0f },
+    { 'P', 0.7f, 0.0f, 0.7f, 0.5f },
+    { 'P', 0.0f, 0.5f, 0.7f, 0.5f },
+    { 'S', 0.8f, 0.0f, 0.2f, 0.0f },
+    { 'S', 0.2f, 0.0f, 0.2f, 0.5f },
+    { 'S', 0.2f, 0.5f, 0.8f, 0.5f },
+    { 'S', 0.8f, 0.5f, 0.8f, 1.0f },
+    { 'S', 0.8f, 1.0f, 0.2f, 1.0f },
+    { 'T', 0.0f, 0.0f, 1.0f, 0.0f },
+    { 'T', 0.5f, 0.0f, 0.5f, 1.0f },
+    { 'R', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'R', 0.0f, 0.0f, 0.8f, 0.0f },
+    { 'R', 0.0f, 0.5f, 0.7f, 0.5f },
+    { 'R', 0.8f, 0.0f, 0.8f, 0.5f },
+    { 'R', 0.0f, 0.5f, 0.8f, 1.0f },
+    { 'M', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'M', 1.0f, 0.0f, 1.0f, 1.0f },
+    { 'M', 0.0f, 0.0f, 0.5f, 0.5f },
+    { 'M', 1.0f, 0.0f, 0.5f, 0.5f },
+    { 'V', 0.0f, 0.0f, 0.5f, 1.0f },
+    { 'V', 1.0f, 0.0f, 0.5f, 1.0f },
+    { 'I', 0.5f, 0.0f, 0.5f, 1.0f },
+    { 'I', 0.2f, 1.0f, 0.8f, 1.0f },
+    { 'I', 0.2f, 0.0f, 0.8f, 0.0f },
+    { 'Q', 0.2f, 0.0f, 0.8f, 0.0f },
+    { 'Q', 0.2f, 1.0f, 0.8f, 1.0f },
+    { 'Q', 0.2f, 0.0f, 0.2f, 1.0f },
+    { 'Q', 0.8f, 0.0f, 0.8f, 1.0f },
+    { 'Q', 0.6f, 0.4f, 0.9f, 0.0f },
+    { 'U', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'U', 1.0f, 0.0f, 1.0f, 1.0f },
+    { 'U', 0.0f, 1.0f, 1.0f, 1.0f },
+    { 'W', 0.0f, 0.0f, 0.2f, 1.0f },
+    { 'W', 0.2f, 1.0f, 0.5f, 0.5f },
+    { 'W', 0.5f, 0.5f, 0.8f, 1.0f },
+    { 'W', 0.8f, 1.0f, 1.0f, 0.0f },
+    { 'Y', 0.0f, 0.0f, 0.5f, 0.5f },
+    { 'Y', 1.0f, 0.0f, 0.5f, 0.5f },
+    { 'Y', 0.5f, 0.5f, 0.5f, 1.0f },
+    { '0', 0.2f, 0.0f, 0.8f, 0.0f },
+    { '0', 0.2f, 1.0f, 0.8f, 1.0f },
+    { '0', 0.2f, 0.0f, 0.2f, 1.0f },
+    { '0', 0.8f, 0.0f, 0.8f, 1.0f },
+    { '1', 0.5f, 0.0f, 0.5f, 1.0f },
+    { '1', 0.3f, 0.2f, 0.5f, 0.0f },
+    { '1', 0.3f, 1.0f, 0.7f, 1.0f },
+    { '2', 0.2f, 0.0f, 0.8f, 0.0f },
+    { '2', 0.8f, 0.0f, 0.8f, 0.5f },
+    { '2', 0.2f, 0.5f, 0.8f, 0.5f },
+    { '2', 0.2f, 0.5f, 0.2f, 1.0f },
+    { '2', 0.2f, 1.0f, 0.8f, 1.0f },
+    { '3', 0.2f, 0.0f, 0.8f, 0.0f },
+    { '3', 0.8f, 0.0f, 0.8f, 0.5f },
+    { '3', 0.2f, 0.5f, 0.8f, 0.5f },
+    { '3', 0.8f, 0.5f, 0.8f, 1.0f },
+    { '3', 0.2f, 1.0f, 0.8f, 1.0f },
+    { '4', 0.2f, 0.0f, 0.2f, 0.5f },
+    { '4', 0.8f, 0.0f, 0.8f, 1.0f },
+    { '4', 0.2f, 0.5f, 0.8f, 0.5f },
+    { '5', 0.8f, 0.0f, 0.2f, 0.0f },
+    { '5', 0.2f, 0.0f, 0.2f, 0.5f },
+    { '5', 0.2f, 0.5f, 0.8f, 0.5f },
+    { '5', 0.8f, 0.5f, 0.8f, 1.0f },
+    { '5', 0.2f, 1.0f, 0.8f, 1.0f },
+    { '6', 0.8f, 0.0f, 0.2f, 0.0f },
+    { '6', 0.2f, 0.0f, 0.2f, 1.0f },
+    { '6', 0.2f, 0.5f, 0.8f, 0.5f },
+    { '6', 0.8f, 0.5f, 0.8f, 1.0f },
+    { '6', 0.2f, 1.0f, 0.8f, 1.0f },
+    { '7', 0.2f, 0.0f, 0.8f, 0.0f },
+    { '7', 0.8f, 0.0f, 0.5f, 1.0f },
+    { '8', 0.2f, 0.0f, 0.8f, 0.0f },
+    { '8', 0.2f, 1.0f, 0.8f, 1.0f },
+    { '8', 0.2f, 0.0f, 0.2f, 1.0f },
+    { '8', 0.8f, 0.0f, 0.8f, 1.0f },
+    { '8', 0.2f, 0.5f, 0.8f, 0.5f },
+    { '9', 0.2f, 0.0f, 0.8f, 0.0f },
+    { '9', 0.2f, 0.0f, 0.2f, 0.5f },
+    { '9', 0.2f, 0.5f, 0.8f, 0.5f },
+    { '9', 0.8f, 0.0f, 0.8f, 1.0f },
+    { '9', 0.2f, 1.0f, 0.8f, 1.0f },
+    { '/', 0.8f, 0.0f, 0.2f, 1.0f },
+    { ':', 0.5f, 0.3f, 0.5f, 0.3f },
+    { ':', 0.5f, 0.7f, 0.5f, 0.7f },
+    { 'B', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'B', 0.0f, 0.0f, 0.7f, 0.0f },
+    { 'B', 0.7f, 0.0f, 0.8f, 0.15f },
+    { 'B', 0.8f, 0.15f, 0.8f, 0.35f },
+    { 'B', 0.8f, 0.35f, 0.7f, 0.5f },
+    { 'B', 0.0f, 0.5f, 0.7f, 0.5f },
+    { 'B', 0.7f, 0.5f, 0.8f, 0.65f },
+    { 'B', 0.8f, 0.65f, 0.8f, 0.85f },
+    { 'B', 0.8f, 0.85f, 0.7f, 1.0f },
+    { 'B', 0.0f, 1.0f, 0.7f, 1.0f },
+    { 'H', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'H', 0.8f, 0.0f, 0.8f, 1.0f },
+    { 'H', 0.0f, 0.5f, 0.8f, 0.5f },
+    { 'J', 0.8f, 0.0f, 0.8f, 0.85f },
+    { 'J', 0.8f, 0.85f, 0.5f, 1.0f },
+    { 'J', 0.5f, 1.0f, 0.2f, 0.85f },
+    { 'J', 0.3f, 0.0f, 0.8f, 0.0f },
+    { 'K', 0.0f, 0.0f, 0.0f, 1.0f },
+    { 'K', 0.8f, 0.0f, 0.0f, 0.5f },
+    { 'K', 0.0f, 0.5f, 0.8f, 1.0f },
+    { 'X', 0.0f, 0.0f, 0.8f, 1.0f },
+    { 'X', 0.8f, 0.0f, 0.0f, 1.0f },
+    { 'Z', 0.0f, 0.0f, 0.8f, 0.0f },
+    { 'Z', 0.8f, 0.0f, 0.0f, 1.0f },
+    { 'Z', 0.0f, 1.0f, 0.8f, 1.0f },
+    { '.', 0.4f, 0.9f, 0.6f, 0.9f },
+    { '.', 0.6f, 0.9f, 0.6f, 1.0f },
+    { '.', 0.6f, 1.0f, 0.4f, 1.0f },
+    { '.', 0.4f, 1.0f, 0.4f, 0.9f },
+    { '!', 0.5f, 0.0f, 0.5f, 0.65f },
+    { '!', 0.4f, 0.85f, 0.6f, 0.85f },
+    { '!', 0.6f, 0.85f, 0.6f, 1.0f },
+    { '!', 0.6f, 1.0f, 0.4f, 1.0f },
+    { '!', 0.4f, 1.0f, 0.4f, 0.85f },
+    { '>', 0.2f, 0.0f, 0.8f, 0.5f },
+    { '>', 0.8f, 0.5f, 0.2f, 1.0f },
+    { '<', 0.8f, 0.0f, 0.2f, 0.5f },
+    { '<', 0.2f, 0.5f, 0.8f, 1.0f },
+    { '-', 0.2f, 0.5f, 0.8f, 0.5f },
+    { 0, 0.0f, 0.0f, 1.0f, 1.0f },
+    { 0, 1.0f, 0.0f, 0.0f, 1.0f },
+};
+
+struct GlyphRange {
+    unsigned short first;
+    unsigned short count;
+};
+
+static const int kStrokeCount = (int)(sizeof(kStrokes) / sizeof(kStrokes[0]));
+static GlyphRange gGlyphs[128];
+static GlyphRange gFallbackGlyph;
+static bool gGlyphsBuilt = false;
+
+static void buildGlyphTable() {
+    for (int i = 0; i < kStrokeCount; ) {
+        char c = kStrokes[i].c;
+        GlyphRange range = { (unsigned short)i, 0 };
+        while (i < kStrokeCount && kStrokes[i].c == c) {
+            range.count++;
+            i++;
+        }
+        if (c == 0) gFallbackGlyph = range;
+        else gGlyphs[(unsigned char)c] = range;
+    }
+    gGlyphsBuilt = true;
+}
+
+static const GlyphRange& glyphFor(char c) {
+    unsigned char uc = (unsigned char)c;
+    if (uc < 128 && gGlyphs[uc].count > 0) return gGlyphs[uc];
+    return gFallbackGlyph;
+}
+
+// --- Cached runs ---
+// Open-addressed table keyed by a hash of the text and scale. Positions are
+// stored relative to the text origin so a label can move or jitter freely.
+// When the table or vertex pool fills up, everything is dropped and rebuilt on
+// demand; in practice the working set is a few dozen labels. A hit is
+// confirmed against a copy of the text, so a hash collision only costs a probe.
+
+struct TextRun {
+    unsigned long long key;
+    float scale;
+    int first;              // offset into gRunPool (floats)
+    int vertexCount;
+    int textFirst;          // offset into gRunText
+    int textLength;
+    bool used;
+};
+
+static const int kRunSlots = 256;                 // power of two
+static const int kRunPoolFloats = 256 * 1024;     // xy pairs
+static const int kRunTextChars = 16 * 1024;
+static TextRun gRuns[kRunSlots];
+static int gRunCount = 0;
+static float gRunPool[kRunPoolFloats];
+static int gRunPoolUsed = 0;
+static char gRunText[kRunTextChars];
+static int gRunTextUsed = 0;
+
+static unsigned long long hashText(float scale, const char* text) {
+    // FNV-1a over the characters and the scale bits
+    unsigned long long h = 1469598103934665603ull;
+    for (const char* p = text; *p; ++p) {
+        h ^= (unsigned char)*p;
+        h *= 1099511628211ull;
+    }
+    union { float f; unsigned int u; } bits;
+    bits.f = scale;
+    for (int i = 0; i < 4; ++i) {
+        h ^= (bits.u >> (i * 8)) & 0xFFu;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+void clearTextCache() {
+    for (int i = 0; i < kRunSlots; ++i) gRuns[i].used = false;
+    gRunCount = 0;
+    gRunPoolUsed = 0;
+    gRunTextUsed = 0;
+}
+
+// Segment as a quad with square caps; returns floats written (12)
+static int strokeQuad(float* out, float x1, float y1, float x2, float y2, float half) {
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float len = std::sqrt(dx * dx + dy * dy);
+    float ux = 1.0f, uy = 0.0f;
+    if (len > 0.0001f) {
+        ux = dx / len;
+        uy = dy / len;
+    }
+    float nx = -uy * half, ny = ux * half;
+    float ax = x1 - ux * half, ay = y1 - uy * half;
+    float bx = x2 + ux * half, by = y2 + uy * half;
+
+    const float quad[4][2] = {
+        { ax + nx, ay + ny }, { bx + nx, by + ny },
+        { bx - nx, by - ny }, { ax - nx, ay - ny }
+    };
+    static const int order[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int i = 0; i < 6; ++i) {
+        out[i * 2 + 0] = quad[order[i]][0];
+        out[i * 2 + 1] = quad[order[i]][1];
+    }
+    return 12;
+}
+
+static int countTextSegments(const char* text) {
+    int n = 0;
+    for (const char* p = text; *p; ++p) {
+        if (*p != ' ' && *p != '\n') n += glyphFor(*p).count;
+    }
+    return n;
+}
+
+static void buildRun(float* out, float scale, const char* text) {
+    float half = kStrokeWidth * 0.5f;
+    float cursor = 0.0f;
+    float y = 0.0f;
+    for (const char* p = text; *p; ++p) {
+        char c = *p;
+        if (c == ' ') {
+            cursor += scale * 0.7f;
+        } else if (c == '\n') {
+            y += scale * 1.2f;
+            cursor = 0.0f;
+        } else {
+            const GlyphRange& g = glyphFor(c);
+            for (int i = 0; i < g.count; ++i) {
+                const GlyphStroke& st = kStrokes[g.first + i];
+                out += strokeQuad(out, cursor + st.x1 * scale, y + st.y1 * scale,
+                                  cursor + st.x2 * scale, y + st.y2 * scale, half);
+            }
+            cursor += scale * 1.0f;
+        }
+    }
+}
+
+static const TextRun* findOrBuildRun(float scale, const char* text) {
+    unsigned long long key = hashText(scale, text);
+    int length = (int)std::strlen(text);
+    int slot = (int)(key & (kRunSlots - 1));
+    for (int probe = 0; probe < kRunSlots; ++probe) {
+        const TextRun& run = gRuns[slot];
+        if (!run.used) break;
+        if (run.key == key && run.scale == scale && run.textLength == length &&
+            std::memcmp(gRunText + run.textFirst, text, (size_t)length) == 0) {
+            return &run;
+        }
+        slot = (slot + 1) & (kRunSlots - 1);
+    }
+
+    int floats = countTextSegments(text) * 12;
+    if (floats > kRunPoolFloats || length > kRunTextChars) return nullptr;
+    if (gRunCount >= kRunSlots / 2 || gRunPoolUsed + floats > kRunPoolFloats ||
+        gRunTextUsed + length > kRunTextChars) {
+        clearTextCache();
+    }
+
+    slot = (int)(key & (kRunSlots - 1));
+    while (gRuns[slot].used) slot = (slot + 1) & (kRunSlots - 1);
+
+    TextRun& run = gRuns[slot];
+    run.key = key;
+    run.scale = scale;
+    run.first = gRunPoolUsed;
+    run.vertexCount = floats / 2;
+    run.textFirst = gRunTextUsed;
+    run.textLength = length;
+    run.used = true;
+    buildRun(gRunPool + run.first, scale, text);
+    std::memcpy(gRunText + run.textFirst, text, (size_t)length);
+    gRunPoolUsed += floats;
+    gRunTextUsed += length;
+    gRunCount++;
+    return &run;
+}
+
+float measureText(float scale, const char* text) {
+    float width = 0.0f;
+    for (const char* p = text; *p; ++p) {
+        char c = *p;
+        if (c == ' ') {
+            width += scale * 0.7f;
+        } else if (c == '\n') {
+            // We only use single-line text for width calculations here.
+            break;
+        } else {
+            width += scale * 1.0f;
+        }
+    }
+    return width;
+}
+
+void drawText(float x, float y, float scale, const char* text) {
+    if (!gGlyphsBuilt) buildGlyphTable();
+
+    const TextRun* run = findOrBuildRun(scale, text);
+    if (!run || run->vertexCount == 0) return;
+    Renderer::getInstance().triangles(gRunPool + run->first, run->vertexCount, x, y);
+}
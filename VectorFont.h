@@ -0,0 +1,16 @@
+#pragma once
+
+// Stroke font used by every menu and HUD label.
+// Glyphs are line segments in a 1x1 cell, decoded once into a flat table. Each
+// distinct (text, scale) pair is expanded into a triangle run on first use and
+// cached, so drawing a label is a copy into the renderer's triangle batch with
+// the current color - no per-character work and no GL_LINES batch to split on.
+
+// Width a single line of text will take up
+float measureText(float scale, const char* text);
+
+// Draw text with its top-left corner at (x, y) in the current color; '\n' starts a new line
+void drawText(float x, float y, float scale, const char* text);
+
+// Drop every cached run (e.g. after a resize that changes all label scales)
+void clearTextCache();
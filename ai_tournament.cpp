@@ -0,0 +1,360 @@
+// AI self-play tournament: every pair of AI profiles plays a round robin over
+// many seeds, sides alternating, spread across all cores. Reports win rates,
+// KO stats and a histogram of rally lengths (paddle hits per point), so the
+// difficulty presets can be tuned without a tester in the loop. Links only
+// Simulation.cpp, so it runs without SDL video or a GL context.
+//
+//   ai_tournament [options] [profile ...]
+//     --seeds N        matches per pairing (default 200)
+//     --mode M         classic | battle | free (battle with free movement; default battle)
+//     --threads N      worker threads (default: all cores)
+//     --tick-rate N    simulation rate in Hz (default 120)
+//
+// A profile is a preset name with optional overrides, e.g. "hard" or
+// "medium:aim=60:speed=0.8". Keys: speed, react, predict, drift, advance, aim.
+// With no profiles given, the three presets play with and without aim error.
+#include "Simulation.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int FieldWidth = 1280;
+static const int FieldHeight = 720;
+static const double MaxMatchSeconds = 600.0;   // longer than this is scored a stalemate
+
+// Rally length buckets in paddle hits: 0, 1, 2-3, 4-7, ... 64+
+static const int RallyBuckets = 8;
+static const char* const kRallyBucketNames[RallyBuckets] = {
+    "0", "1", "2-3", "4-7", "8-15", "16-31", "32-63", "64+"
+};
+
+static const char* const kDefaultRoster[] = {
+    "easy", "medium", "hard", "easy:aim=70", "medium:aim=70", "hard:aim=70",
+};
+
+struct Entrant {
+    std::string name;
+    AIProfile profile;
+};
+
+// One match: entrant a against b, with a on the left when aLeft
+struct Fixture {
+    int a, b;
+    bool aLeft;
+    unsigned int seed;
+};
+
+struct MatchResult {
+    int winner;                   // entrant index, or -1 for a stalemate
+    bool koWin;
+    int scoreA, scoreB;
+    int healthA, healthB;
+    unsigned int ticks;
+    int points;                   // rallies completed (goals, plus the KO point)
+    int rallyHits;                // paddle hits summed over those rallies
+    int rallyHistogram[RallyBuckets];
+};
+
+static int rallyBucket(int hits) {
+    int bucket = 0;
+    while (hits > 0 && bucket < RallyBuckets - 1) {
+        hits >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static bool parseProfile(const char* spec, Entrant& out) {
+    std::string text = spec;
+    size_t colon = text.find(':');
+    std::string base = text.substr(0, colon);
+    if (base == "easy") out.profile = aiPreset(AI_EASY);
+    else if (base == "medium") out.profile = aiPreset(AI_MEDIUM);
+    else if (base == "hard") out.profile = aiPreset(AI_HARD);
+    else {
+        std::fprintf(stderr, "Unknown preset '%s' (easy, medium or hard)\n", base.c_str());
+        return false;
+    }
+    out.name = text;
+
+    while (colon != std::string::npos) {
+        size_t next = text.find(':', colon + 1);
+        std::string item = text.substr(colon + 1, next == std::string::npos ? std::string::npos : next - colon - 1);
+        colon = next;
+
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            std::fprintf(stderr, "Bad override '%s' in '%s' (expected key=value)\n", item.c_str(), spec);
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        float value = (float)std::atof(item.c_str() + eq + 1);
+        if (key == "speed") out.profile.speedMult = value;
+        else if (key == "react") out.profile.reactionMult = value;
+        else if (key == "predict") out.profile.predictionBlend = value;
+        else if (key == "drift") out.profile.driftBlend = value;
+        else if (key == "advance") out.profile.advanceFraction = value;
+        else if (key == "aim") out.profile.aimError = value;
+        else {
+            std::fprintf(stderr, "Unknown key '%s' in '%s'\n", key.c_str(), spec);
+            return false;
+        }
+    }
+    return true;
+}
+
+static MatchResult playMatch(const std::vector<Entrant>& entrants, const Fixture& fx,
+                             MatchConfig cfg, int tickRate) {
+    const Entrant& left = entrants[fx.aLeft ? fx.a : fx.b];
+    const Entrant& right = entrants[fx.aLeft ? fx.b : fx.a];
+    cfg.aiDifficulty1 = left.profile.behaviour;
+    cfg.aiDifficulty2 = right.profile.behaviour;
+    cfg.aiProfile1 = &left.profile;
+    cfg.aiProfile2 = &right.profile;
+
+    const float dt = 1.0f / (float)tickRate;
+    const unsigned int maxTicks = (unsigned int)(MaxMatchSeconds * tickRate);
+
+    MatchResult r = {};
+    MatchState s;
+    resetMatch(s, cfg, fx.seed);
+    const MatchInput in = {};
+    SimEvents events;
+    int hits = 0;
+    while (s.winner == 0 && s.tick < maxTicks) {
+        stepMatch(s, cfg, in, dt, &events);
+        // Every hit counts, even two in one tick; a point ends on a goal or a KO
+        for (int e = 0; e < events.count; ++e) {
+            MatchEvent type = events.queue[e].type;
+            if (type == EVENT_PADDLE_HIT) hits++;
+            if (type == EVENT_GOAL || (type == EVENT_MATCH_OVER && s.koWin)) {
+                r.points++;
+                r.rallyHits += hits;
+                r.rallyHistogram[rallyBucket(hits)]++;
+                hits = 0;
+            }
+        }
+    }
+
+    r.ticks = s.tick;
+    r.koWin = s.koWin;
+    r.scoreA = fx.aLeft ? s.score1 : s.score2;
+    r.scoreB = fx.aLeft ? s.score2 : s.score1;
+    r.healthA = fx.aLeft ? s.health1 : s.health2;
+    r.healthB = fx.aLeft ? s.health2 : s.health1;
+    if (s.winner != 0) {
+        bool leftWon = (s.winner == 1);
+        r.winner = (leftWon == fx.aLeft) ? fx.a : fx.b;
+    } else {
+        r.winner = -1;
+    }
+    return r;
+}
+
+struct PairTotals {
+    int matches;
+    int winsA, winsB, stalemates;
+    int koA, koB;
+    int healthLeftA, healthLeftB;   // summed over the KO wins
+    unsigned long long ticks;
+    int points;
+    long long rallyHits;
+};
+
+struct EntrantTotals {
+    int played, wins, losses, stalemates;
+    int koWins, koLosses;
+};
+
+int main(int argc, char** argv) {
+    int seeds = 200;
+    int threads = 0;
+    int tickRate = 120;
+    const char* modeName = "battle";
+    std::vector<const char*> specs;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--seeds") == 0 && hasValue) seeds = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--tick-rate") == 0 && hasValue) tickRate = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--mode") == 0 && hasValue) modeName = argv[++i];
+        else if (argv[i][0] == '-') {
+            std::fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+            return 1;
+        } else specs.push_back(argv[i]);
+    }
+    if (seeds < 1) seeds = 1;
+    if (tickRate < 30) tickRate = 30;
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    if (specs.empty()) {
+        specs.assign(kDefaultRoster, kDefaultRoster + sizeof(kDefaultRoster) / sizeof(kDefaultRoster[0]));
+    }
+
+    MatchConfig cfg = {};
+    cfg.width = FieldWidth;
+    cfg.height = FieldHeight;
+    cfg.autoBoost = false;
+    cfg.shieldEnabled = true;
+    cfg.maxHealth = 10;
+    cfg.targetScore = 11;
+    cfg.aiControlled1 = true;
+    cfg.aiControlled2 = true;
+    if (std::strcmp(modeName, "classic") == 0) {
+        cfg.mode = MODE_CLASSIC;
+    } else if (std::strcmp(modeName, "battle") == 0) {
+        cfg.mode = MODE_BATTLE;
+    } else if (std::strcmp(modeName, "free") == 0) {
+        cfg.mode = MODE_BATTLE;
+        cfg.freeMovement = true;
+    } else {
+        std::fprintf(stderr, "Unknown mode '%s' (classic, battle or free)\n", modeName);
+        return 1;
+    }
+
+    std::vector<Entrant> entrants(specs.size());
+    for (size_t i = 0; i < specs.size(); ++i) {
+        if (!parseProfile(specs[i], entrants[i])) return 1;
+    }
+    if (entrants.size() < 2) {
+        std::fprintf(stderr, "Need at least two profiles\n");
+        return 1;
+    }
+
+    // Round robin; each pairing plays the same seeds, swapping sides every match
+    std::vector<Fixture> fixtures;
+    std::vector<int> pairOf;
+    int pairCount = 0;
+    for (int a = 0; a < (int)entrants.size(); ++a) {
+        for (int b = a + 1; b < (int)entrants.size(); ++b) {
+            for (int m = 0; m < seeds; ++m) {
+                fixtures.push_back(Fixture{ a, b, (m % 2) == 0, 0x70A40000u + (unsigned int)(m / 2) });
+                pairOf.push_back(pairCount);
+            }
+            pairCount++;
+        }
+    }
+
+    // Workers pull fixtures off a shared counter and write into their own slots,
+    // so the report is identical whatever the thread count
+    std::vector<MatchResult> results(fixtures.size());
+    std::atomic<size_t> nextFixture(0);
+    auto worker = [&]() {
+        for (;;) {
+            size_t i = nextFixture.fetch_add(1);
+            if (i >= fixtures.size()) break;
+            results[i] = playMatch(entrants, fixtures[i], cfg, tickRate);
+        }
+    };
+
+    std::printf("%zu profiles, %d pairings x %d matches, mode %s, %d Hz, %d threads\n\n",
+                entrants.size(), pairCount, seeds, modeName, tickRate, threads);
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::vector<PairTotals> pairs(pairCount, PairTotals{});
+    std::vector<EntrantTotals> totals(entrants.size(), EntrantTotals{});
+    long long histogram[RallyBuckets] = {};
+    unsigned long long totalTicks = 0;
+    for (size_t i = 0; i < fixtures.size(); ++i) {
+        const Fixture& fx = fixtures[i];
+        const MatchResult& r = results[i];
+        PairTotals& p = pairs[pairOf[i]];
+        EntrantTotals& ta = totals[fx.a];
+        EntrantTotals& tb = totals[fx.b];
+
+        p.matches++;
+        p.ticks += r.ticks;
+        p.points += r.points;
+        p.rallyHits += r.rallyHits;
+        ta.played++;
+        tb.played++;
+        if (r.winner == fx.a) {
+            p.winsA++;
+            ta.wins++;
+            tb.losses++;
+            if (r.koWin) {
+                p.koA++;
+                p.healthLeftA += r.healthA;
+                ta.koWins++;
+                tb.koLosses++;
+            }
+        } else if (r.winner == fx.b) {
+            p.winsB++;
+            tb.wins++;
+            ta.losses++;
+            if (r.koWin) {
+                p.koB++;
+                p.healthLeftB += r.healthB;
+                tb.koWins++;
+                ta.koLosses++;
+            }
+        } else {
+            p.stalemates++;
+            ta.stalemates++;
+            tb.stalemates++;
+        }
+        for (int k = 0; k < RallyBuckets; ++k) {
+            histogram[k] += r.rallyHistogram[k];
+        }
+        totalTicks += r.ticks;
+    }
+
+    std::printf("%-20s %-20s %6s %6s %6s %7s %9s %9s %9s %9s\n",
+                "A", "B", "A wins", "B wins", "stale", "A win%", "KO A/B", "KO hp", "avg secs", "hits/pt");
+    int pairIndex = 0;
+    for (int a = 0; a < (int)entrants.size(); ++a) {
+        for (int b = a + 1; b < (int)entrants.size(); ++b) {
+            const PairTotals& p = pairs[pairIndex++];
+            int decided = p.winsA + p.winsB;
+            char ko[16];
+            std::snprintf(ko, sizeof(ko), "%d/%d", p.koA, p.koB);
+            // Health the KO winner had left, averaged over all KO wins
+            int koWins = p.koA + p.koB;
+            double koHealth = koWins ? (double)(p.healthLeftA + p.healthLeftB) / koWins : 0.0;
+            std::printf("%-20s %-20s %6d %6d %6d %6.1f%% %9s %9.1f %9.1f %9.1f\n",
+                        entrants[a].name.c_str(), entrants[b].name.c_str(), p.winsA, p.winsB, p.stalemates,
+                        decided ? 100.0 * p.winsA / decided : 0.0, ko, koHealth,
+                        (double)p.ticks / p.matches / tickRate,
+                        p.points ? (double)p.rallyHits / p.points : 0.0);
+        }
+    }
+
+    std::printf("\n%-20s %6s %6s %6s %6s %7s %8s %8s\n",
+                "profile", "played", "wins", "losses", "stale", "win%", "KO wins", "KO lost");
+    for (size_t i = 0; i < entrants.size(); ++i) {
+        const EntrantTotals& t = totals[i];
+        int decided = t.wins + t.losses;
+        std::printf("%-20s %6d %6d %6d %6d %6.1f%% %8d %8d\n",
+                    entrants[i].name.c_str(), t.played, t.wins, t.losses, t.stalemates,
+                    decided ? 100.0 * t.wins / decided : 0.0, t.koWins, t.koLosses);
+    }
+
+    long long points = 0;
+    for (int k = 0; k < RallyBuckets; ++k) {
+        points += histogram[k];
+    }
+    std::printf("\nRally length (paddle hits per point, %lld points)\n", points);
+    for (int k = 0; k < RallyBuckets; ++k) {
+        double share = points ? (double)histogram[k] / (double)points : 0.0;
+        std::printf("  %-6s %9lld %6.1f%% %s\n", kRallyBucketNames[k], histogram[k], 100.0 * share,
+                    std::string((size_t)(share * 50.0 + 0.5), '#').c_str());
+    }
+
+    std::printf("\n%zu matches, %.1f s wall, %.1fM ticks/s\n", fixtures.size(), wallSeconds,
+                wallSeconds > 0.0 ? (double)totalTicks / wallSeconds / 1.0e6 : 0.0);
+    return 0;
+}
@@ -0,0 +1,191 @@
+// Offline asset packer: walks the assets folder, converts every .wav to the
+// mixer's device format and every .png to RGBA8, and writes one archive the
+// game memory-maps at startup (see AssetPack.h).
+//
+//   asset_packer [assets-dir] [output]      defaults: assets  assets.pak
+#include "AssetPack.h"
+#include "SDL3/SDL.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+// Must match the spec AudioManager opens the device with
+static const int DeviceFreq = 44100;
+static const int DeviceChannels = 2;
+
+static const Uint64 PayloadAlign = 16;
+
+struct PackedAsset {
+    AssetPackEntry entry;
+    std::vector<Uint8> payload;
+};
+
+static bool hasExtension(const std::string& path, const char* ext) {
+    size_t n = std::strlen(ext);
+    if (path.size() < n) return false;
+    for (size_t i = 0; i < n; ++i) {
+        char c = path[path.size() - n + i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != ext[i]) return false;
+    }
+    return true;
+}
+
+static SDL_EnumerationResult SDLCALL collectFile(void* userdata, const char* dirname, const char* fname) {
+    std::vector<std::string>* files = static_cast<std::vector<std::string>*>(userdata);
+    std::string path = std::string(dirname) + fname;
+
+    SDL_PathInfo info;
+    if (!SDL_GetPathInfo(path.c_str(), &info)) {
+        return SDL_ENUM_CONTINUE;
+    }
+    if (info.type == SDL_PATHTYPE_DIRECTORY) {
+        SDL_EnumerateDirectory(path.c_str(), collectFile, userdata);
+    } else if (hasExtension(path, ".wav") || hasExtension(path, ".png")) {
+        files->push_back(path);
+    }
+    return SDL_ENUM_CONTINUE;
+}
+
+static bool packAudio(const std::string& path, PackedAsset& out) {
+    SDL_AudioSpec srcSpec;
+    Uint8* data = nullptr;
+    Uint32 length = 0;
+    if (!SDL_LoadWAV(path.c_str(), &srcSpec, &data, &length)) {
+        std::fprintf(stderr, "  skip %s: %s\n", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    SDL_AudioSpec dstSpec;
+    SDL_zero(dstSpec);
+    dstSpec.format = SDL_AUDIO_F32;
+    dstSpec.channels = DeviceChannels;
+    dstSpec.freq = DeviceFreq;
+
+    SDL_AudioStream* stream = SDL_CreateAudioStream(&srcSpec, &dstSpec);
+    bool ok = stream && SDL_PutAudioStreamData(stream, data, (int)length) && SDL_FlushAudioStream(stream);
+    SDL_free(data);
+    if (ok) {
+        int available = SDL_GetAudioStreamAvailable(stream);
+        out.payload.resize(available > 0 ? (size_t)available : 0);
+        ok = available > 0 && SDL_GetAudioStreamData(stream, out.payload.data(), available) == available;
+    }
+    if (stream) SDL_DestroyAudioStream(stream);
+    if (!ok) {
+        std::fprintf(stderr, "  skip %s: conversion failed: %s\n", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    out.entry.type = ASSET_AUDIO_F32;
+    out.entry.freq = DeviceFreq;
+    out.entry.channels = DeviceChannels;
+    return true;
+}
+
+static bool packImage(const std::string& path, PackedAsset& out) {
+    int w = 0, h = 0, channels = 0;
+    unsigned char* pixels = stbi_load(path.c_str(), &w, &h, &channels, 4);
+    if (!pixels) {
+        std::fprintf(stderr, "  skip %s: %s\n", path.c_str(), stbi_failure_reason());
+        return false;
+    }
+    out.payload.assign(pixels, pixels + (size_t)w * (size_t)h * 4);
+    stbi_image_free(pixels);
+
+    out.entry.type = ASSET_IMAGE_RGBA8;
+    out.entry.width = (Uint32)w;
+    out.entry.height = (Uint32)h;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string assetsDir = argc > 1 ? argv[1] : "assets";
+    const char* outputPath = argc > 2 ? argv[2] : AssetPackDefaultPath;
+    while (!assetsDir.empty() && (assetsDir.back() == '/' || assetsDir.back() == '\\')) {
+        assetsDir.pop_back();
+    }
+
+    if (!SDL_Init(0)) {
+        std::fprintf(stderr, "SDL_Init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    std::vector<std::string> files;
+    if (!SDL_EnumerateDirectory(assetsDir.c_str(), collectFile, &files)) {
+        std::fprintf(stderr, "Cannot read '%s': %s\n", assetsDir.c_str(), SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    std::vector<PackedAsset> assets;
+    for (std::string& file : files) {
+        // Store the path the game asks for: "assets/..." with forward slashes
+        std::replace(file.begin(), file.end(), '\\', '/');
+        std::string name = "assets" + file.substr(assetsDir.size());
+
+        PackedAsset asset;
+        std::memset(&asset.entry, 0, sizeof(asset.entry));
+        if (name.size() >= sizeof(asset.entry.path)) {
+            std::fprintf(stderr, "  skip %s: path too long\n", name.c_str());
+            continue;
+        }
+        std::memcpy(asset.entry.path, name.c_str(), name.size() + 1);
+
+        bool ok = hasExtension(file, ".wav") ? packAudio(file, asset) : packImage(file, asset);
+        if (ok) {
+            std::printf("  %-72s %8zu KB\n", name.c_str(), asset.payload.size() / 1024);
+            assets.push_back(std::move(asset));
+        }
+    }
+    SDL_Quit();
+
+    // Sorted so the runtime can binary-search the table
+    std::sort(assets.begin(), assets.end(), [](const PackedAsset& a, const PackedAsset& b) {
+        return std::strcmp(a.entry.path, b.entry.path) < 0;
+    });
+
+    Uint64 offset = sizeof(AssetPackHeader) + assets.size() * sizeof(AssetPackEntry);
+    for (PackedAsset& asset : assets) {
+        offset = (offset + PayloadAlign - 1) & ~(PayloadAlign - 1);
+        asset.entry.offset = offset;
+        asset.entry.size = asset.payload.size();
+        offset += asset.entry.size;
+    }
+
+    std::FILE* f = std::fopen(outputPath, "wb");
+    if (!f) {
+        std::fprintf(stderr, "Cannot write '%s'\n", outputPath);
+        return 1;
+    }
+    AssetPackHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, AssetPackMagic, sizeof(header.magic));
+    header.version = AssetPackVersion;
+    header.entryCount = (Uint32)assets.size();
+    std::fwrite(&header, sizeof(header), 1, f);
+    for (const PackedAsset& asset : assets) {
+        std::fwrite(&asset.entry, sizeof(asset.entry), 1, f);
+    }
+    static const Uint8 zeros[PayloadAlign] = {};
+    Uint64 written = sizeof(AssetPackHeader) + assets.size() * sizeof(AssetPackEntry);
+    for (const PackedAsset& asset : assets) {
+        std::fwrite(zeros, 1, (size_t)(asset.entry.offset - written), f);
+        std::fwrite(asset.payload.data(), 1, asset.payload.size(), f);
+        written = asset.entry.offset + asset.entry.size;
+    }
+    bool ok = std::ferror(f) == 0;
+    std::fclose(f);
+    if (!ok) {
+        std::fprintf(stderr, "Write error on '%s'\n", outputPath);
+        return 1;
+    }
+
+    std::printf("Packed %zu assets into %s (%llu KB)\n", assets.size(), outputPath,
+                (unsigned long long)(written / 1024));
+    return 0;
+}
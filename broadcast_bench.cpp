@@ -0,0 +1,174 @@
+// Spectator broadcast check over loopback UDP: an AI-vs-AI match is published
+// tick by tick to a handful of in-process viewers, one of which only drains
+// its socket every so often, like a venue screen on a busy machine. Reports the
+// bytes each viewer received per second of play, how long publish() took
+// (it must never wait on a viewer), and checks that every frame a viewer
+// decodes matches the quantized state of its tick field for field.
+// Links Simulation.cpp, Replay.cpp, Netplay.cpp and Spectator.cpp only: no SDL.
+//
+//   broadcast_bench [options]
+//     --seconds N      match time to publish (default 120)
+//     --viewers N      viewers, the last one slow (default 4)
+//     --slow N         the slow viewer polls every N ticks (default 90)
+//     --interval N     ticks per frame sent (default 2)
+//     --balls N        balls in play (default 1)
+//     --tick-rate N    simulation rate in Hz (default 120)
+#include "Spectator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const int FieldWidth = 1280;
+static const int FieldHeight = 720;
+static const int MaxViewersHere = 16;
+static const int ExpectedRing = 256;    // ticks of quantized states kept to check late viewers against
+
+// The event block (events, goal ball, goal x/y) isn't part of the state:
+// quantizeFrame leaves it zero and the publisher fills in what the ticks raised
+static const int EventFields = 4;
+
+static bool sameDrawnState(const SpectatorFrame& a, const SpectatorFrame& b) {
+    if (a.fieldCount != b.fieldCount) return false;
+    for (int i = 0; i < a.fieldCount; ++i) {
+        bool eventField = i >= SpectatorFrame::HeaderFields - EventFields && i < SpectatorFrame::HeaderFields;
+        if (!eventField && a.fields[i] != b.fields[i]) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int seconds = 120;
+    int viewerCount = 4;
+    int slowEvery = 90;
+    int interval = 2;
+    int balls = 1;
+    int tickRate = 120;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--seconds") == 0 && hasValue) seconds = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--viewers") == 0 && hasValue) viewerCount = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--slow") == 0 && hasValue) slowEvery = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--interval") == 0 && hasValue) interval = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--balls") == 0 && hasValue) balls = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--tick-rate") == 0 && hasValue) tickRate = std::atoi(argv[++i]);
+        else {
+            std::fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+    if (seconds < 1) seconds = 1;
+    if (viewerCount < 1) viewerCount = 1;
+    if (viewerCount > MaxViewersHere) viewerCount = MaxViewersHere;
+    if (slowEvery < 1) slowEvery = 1;
+    if (tickRate < 30) tickRate = 30;
+    if (balls < 1) balls = 1;
+    if (balls > MaxBalls) balls = MaxBalls;
+
+    MatchConfig cfg = {};
+    cfg.width = FieldWidth;
+    cfg.height = FieldHeight;
+    cfg.mode = MODE_BATTLE;
+    cfg.shieldEnabled = true;
+    cfg.maxHealth = 10;
+    cfg.targetScore = 11;
+    cfg.ballCount = balls;
+    cfg.aiControlled1 = true;
+    cfg.aiControlled2 = true;
+    cfg.aiDifficulty1 = AI_HARD;
+    cfg.aiDifficulty2 = AI_MEDIUM;
+
+    SpectatorPublisher publisher;
+    if (!publisher.open(0)) {
+        return 1;
+    }
+    publisher.setSendInterval(interval);
+
+    NetAddress address;
+    if (!parseNetAddress("127.0.0.1", publisher.localPort(), address)) {
+        return 1;
+    }
+    std::vector<SpectatorViewer> viewers(viewerCount);
+    for (SpectatorViewer& v : viewers) {
+        if (!v.connect(address)) return 1;
+    }
+
+    std::printf("Broadcasting %d s of AI vs AI at %d Hz, a frame every %d ticks, %d ball%s\n", seconds, tickRate,
+                interval, balls, balls == 1 ? "" : "s");
+    std::printf("%d viewer%s; the last polls every %d ticks\n\n", viewerCount, viewerCount == 1 ? "" : "s",
+                slowEvery);
+
+    MatchState* s = new MatchState();
+    MatchState* decoded = new MatchState();
+    std::vector<SpectatorFrame> expected(ExpectedRing);
+    SpectatorFrame* actual = new SpectatorFrame();
+    unsigned int seed = 0xB40AD000u;
+    resetMatch(*s, cfg, seed);
+
+    std::vector<unsigned int> framesDecoded(viewerCount, 0), framesChecked(viewerCount, 0), mismatches(viewerCount, 0);
+    const int ticks = seconds * tickRate;
+    const float dt = 1.0f / (float)tickRate;
+    double publishMs = 0.0, worstPublishMs = 0.0;
+    int matches = 1;
+    MatchInput in = {};
+    SimEvents events;
+    for (int t = 0; t < ticks; ++t) {
+        if (s->winner != 0) {
+            resetMatch(*s, cfg, ++seed);
+            ++matches;
+        }
+        stepMatch(*s, cfg, in, dt, &events);
+
+        auto start = std::chrono::steady_clock::now();
+        publisher.publish(*s, cfg, events);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        publishMs += ms;
+        if (ms > worstPublishMs) worstPublishMs = ms;
+
+        SpectatorFrame& now = expected[s->tick % ExpectedRing];
+        quantizeFrame(*s, now);
+        for (int v = 0; v < viewerCount; ++v) {
+            bool slow = v == viewerCount - 1 && viewerCount > 1;
+            if (slow && t % slowEvery != 0) continue;
+            if (!viewers[v].poll()) continue;
+            ++framesDecoded[v];
+            viewers[v].latestState(*decoded);
+            // A slow viewer's frame may be a while old; a new match restarts the tick count
+            if (decoded->tick > s->tick || s->tick - decoded->tick >= (unsigned int)ExpectedRing) continue;
+            const SpectatorFrame& want = expected[decoded->tick % ExpectedRing];
+            quantizeFrame(*decoded, *actual);
+            ++framesChecked[v];
+            if (!sameDrawnState(want, *actual)) ++mismatches[v];
+        }
+    }
+
+    std::printf("%-8s %8s %8s %10s %8s\n", "viewer", "frames", "checked", "mismatches", "KB/s");
+    bool ok = true;
+    unsigned int checked = 0;
+    for (int v = 0; v < viewerCount; ++v) {
+        bool slow = v == viewerCount - 1 && viewerCount > 1;
+        char name[16];
+        std::snprintf(name, sizeof(name), "%d%s", v + 1, slow ? " slow" : "");
+        std::printf("%-8s %8u %8u %10u %8.2f\n", name, framesDecoded[v], framesChecked[v], mismatches[v],
+                    viewers[v].bytesReceived() / 1024.0 / seconds);
+        if (mismatches[v] > 0 || framesDecoded[v] == 0) ok = false;
+        checked += framesChecked[v];
+    }
+
+    const SpectatorPublisher::Stats& st = publisher.stats();
+    std::printf("\n%d match%s; %u frames, %u delta and %u full packets, %u send failures\n", matches,
+                matches == 1 ? "" : "es", st.frames, st.deltaPackets, st.fullPackets, st.sendFailures);
+    std::printf("publish(): %.4f ms average, %.3f ms worst\n", publishMs / ticks, worstPublishMs);
+    if (ok && checked > 0) {
+        std::printf("%u decoded frames compared, all matched\n", checked);
+    } else {
+        std::printf("FAILED: a viewer decoded a frame that differs from what was published\n");
+        ok = false;
+    }
+
+    delete s;
+    delete decoded;
+    delete actual;
+    return ok ? 0 : 1;
+}
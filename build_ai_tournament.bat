@@ -0,0 +1,17 @@
+@echo off
+echo Building AI tournament runner...
+
+REM Simulation only: no SDL, no OpenGL
+C:/mingw64/bin/g++.exe -O2 ^
+  ai_tournament.cpp Simulation.cpp Profiler.cpp ^
+  -o ai_tournament.exe
+
+if %ERRORLEVEL% == 0 (
+  echo Build successful!
+  echo.
+  echo Run ai_tournament.exe [--seeds N] [--mode classic^|battle^|free] [profile ...] for win rates, KO stats and rally lengths
+) else (
+  echo Build failed!
+)
+
+pause
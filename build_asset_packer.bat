@@ -0,0 +1,24 @@
+@echo off
+echo Building asset packer...
+
+REM SDL3 paths only
+set SDL3_INCLUDE=C:/libs/SDL3-3.2.26/include
+set SDL3_LIB=C:/libs/SDL3-3.2.26/SDL3-devel-3.2.26-mingw/SDL3-3.2.26/x86_64-w64-mingw32/lib
+
+C:/mingw64/bin/g++.exe -O2 ^
+  -I"%SDL3_INCLUDE%" ^
+  -I"%SDL3_INCLUDE%/SDL3" ^
+  asset_packer.cpp ^
+  -L"%SDL3_LIB%" ^
+  -lSDL3 ^
+  -o asset_packer.exe
+
+if %ERRORLEVEL% == 0 (
+  echo Build successful!
+  echo.
+  echo Run asset_packer.exe from the game folder to write assets.pak
+) else (
+  echo Build failed!
+)
+
+pause
@@ -0,0 +1,18 @@
+@echo off
+echo Building spectator broadcast bench...
+
+REM Simulation, replay encoding, sockets and the spectator stream only: no SDL, no OpenGL
+C:/mingw64/bin/g++.exe -O2 ^
+  broadcast_bench.cpp Spectator.cpp Netplay.cpp Replay.cpp Simulation.cpp Profiler.cpp ^
+  -lws2_32 ^
+  -o broadcast_bench.exe
+
+if %ERRORLEVEL% == 0 (
+  echo Build successful!
+  echo.
+  echo Run broadcast_bench.exe [--viewers N] [--slow N] [--balls N] [--interval N] for bytes per viewer and a decode check
+) else (
+  echo Build failed!
+)
+
+pause
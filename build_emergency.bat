@@ -9,9 +9,9 @@ echo Building PingPong (No Audio)...
 C:/mingw64/bin/g++.exe -O2 ^
   -I"C:/libs/SDL3-3.2.26/include" ^
   -I"C:/libs/SDL3-3.2.26/include/SDL3" ^
-  main.cpp Game.cpp Paddle.cpp Ball.cpp ^
+  main.cpp Game.cpp Paddle.cpp Ball.cpp Simulation.cpp Profiler.cpp Replay.cpp Netplay.cpp Spectator.cpp Renderer.cpp VectorFont.cpp ParticleSystem.cpp RenderMath.cpp AssetPack.cpp AssetLoader.cpp ^
   -L"C:/libs/SDL3-3.2.26/SDL3-devel-3.2.26-mingw/SDL3-3.2.26/x86_64-w64-mingw32/lib" ^
-  -lSDL3 -lopengl32 ^
+  -lSDL3 -lopengl32 -lws2_32 ^
   -o PingPong_no_audio.exe
 
 if %ERRORLEVEL% == 0 (
@@ -10,10 +10,10 @@ C:/mingw64/bin/g++.exe -O2 ^
   -I"C:/libs/SDL3-3.2.26/include/SDL3" ^
   -I"%SDL2_MIXER_INCLUDE%" ^
   -I"%SDL2_MIXER_INCLUDE%/SDL2" ^
-  main.cpp Game.cpp Paddle.cpp Ball.cpp AudioManager.cpp ^
+  main.cpp Game.cpp Paddle.cpp Ball.cpp Simulation.cpp Profiler.cpp Replay.cpp Netplay.cpp Spectator.cpp Renderer.cpp VectorFont.cpp ParticleSystem.cpp RenderMath.cpp AssetPack.cpp AssetLoader.cpp AudioManager.cpp ^
   -L"C:/libs/SDL3-3.2.26/SDL3-devel-3.2.26-mingw/SDL3-3.2.26/x86_64-w64-mingw32/lib" ^
   -L"%SDL2_MIXER_LIB%" ^
-  -lSDL3 -lSDL2_mixer -lopengl32 ^
+  -lSDL3 -lSDL2_mixer -lopengl32 -lws2_32 ^
   -o PingPong.exe
 
 if %ERRORLEVEL% == 0 (
@@ -5,12 +5,19 @@ REM SDL3 paths only
 set SDL3_INCLUDE=C:/libs/SDL3-3.2.26/include
 set SDL3_LIB=C:/libs/SDL3-3.2.26/SDL3-devel-3.2.26-mingw/SDL3-3.2.26/x86_64-w64-mingw32/lib
 
+REM Music decodes with stb_vorbis.c, vendored next to stb_image.h
+if not exist stb_vorbis.c (
+  echo Build failed: stb_vorbis.c is missing - copy it from https://github.com/nothings/stb next to stb_image.h
+  pause
+  exit /b 1
+)
+
 C:/mingw64/bin/g++.exe -O2 ^
   -I"%SDL3_INCLUDE%" ^
   -I"%SDL3_INCLUDE%/SDL3" ^
-  main.cpp Game.cpp Paddle.cpp Ball.cpp AudioManager_Fixed.cpp ^
+  main.cpp Game.cpp Paddle.cpp Ball.cpp Simulation.cpp Profiler.cpp Replay.cpp Netplay.cpp Spectator.cpp Renderer.cpp VectorFont.cpp ParticleSystem.cpp RenderMath.cpp AssetPack.cpp AssetLoader.cpp AudioMix.cpp MusicStream.cpp AudioManager_Fixed.cpp ^
   -L"%SDL3_LIB%" ^
-  -lSDL3 -lopengl32 ^
+  -lSDL3 -lopengl32 -lws2_32 ^
   -o PingPong_fixed_audio.exe
 
 if %ERRORLEVEL% == 0 (
@@ -0,0 +1,24 @@
+@echo off
+echo Building mixer kernel benchmark...
+
+REM SDL3 paths only
+set SDL3_INCLUDE=C:/libs/SDL3-3.2.26/include
+set SDL3_LIB=C:/libs/SDL3-3.2.26/SDL3-devel-3.2.26-mingw/SDL3-3.2.26/x86_64-w64-mingw32/lib
+
+C:/mingw64/bin/g++.exe -O2 ^
+  -I"%SDL3_INCLUDE%" ^
+  -I"%SDL3_INCLUDE%/SDL3" ^
+  mix_bench.cpp AudioMix.cpp ^
+  -L"%SDL3_LIB%" ^
+  -lSDL3 ^
+  -o mix_bench.exe
+
+if %ERRORLEVEL% == 0 (
+  echo Build successful!
+  echo.
+  echo Run mix_bench.exe to print ns per frame per voice for each kernel set
+) else (
+  echo Build failed!
+)
+
+pause
@@ -0,0 +1,18 @@
+@echo off
+echo Building netplay loopback test...
+
+REM Simulation, replay encoding and netplay only: no SDL, no OpenGL
+C:/mingw64/bin/g++.exe -O2 ^
+  net_loopback.cpp Netplay.cpp Replay.cpp Simulation.cpp Profiler.cpp ^
+  -lws2_32 ^
+  -o net_loopback.exe
+
+if %ERRORLEVEL% == 0 (
+  echo Build successful!
+  echo.
+  echo Run net_loopback.exe [--lag N] [--jitter N] [--loss P] [--balls N] [--seed N] [--pointer] for rollback stats and a desync check
+) else (
+  echo Build failed!
+)
+
+pause
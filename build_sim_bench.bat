@@ -0,0 +1,17 @@
+@echo off
+echo Building simulation benchmark...
+
+REM Simulation only: no SDL, no OpenGL
+C:/mingw64/bin/g++.exe -O2 ^
+  sim_bench.cpp Simulation.cpp Profiler.cpp ^
+  -o sim_bench.exe
+
+if %ERRORLEVEL% == 0 (
+  echo Build successful!
+  echo.
+  echo Run sim_bench.exe [matches-per-case] [tick-rate] for ticks/sec, ns/tick and allocations
+) else (
+  echo Build failed!
+)
+
+pause
@@ -8,9 +8,9 @@ set SDL3_LIB=C:/libs/SDL3-3.2.26/SDL3-devel-3.2.26-mingw/SDL3-3.2.26/x86_64-w64-
 C:/mingw64/bin/g++.exe -O2 ^
   -I"%SDL3_INCLUDE%" ^
   -I"%SDL3_INCLUDE%/SDL3" ^
-  main.cpp Game.cpp Paddle.cpp Ball.cpp AudioManager_Simple.cpp ^
+  main.cpp Game.cpp Paddle.cpp Ball.cpp Simulation.cpp Profiler.cpp Replay.cpp Netplay.cpp Spectator.cpp Renderer.cpp VectorFont.cpp ParticleSystem.cpp RenderMath.cpp AssetPack.cpp AssetLoader.cpp AudioManager_Simple.cpp ^
   -L"%SDL3_LIB%" ^
-  -lSDL3 -lopengl32 ^
+  -lSDL3 -lopengl32 -lws2_32 ^
   -o PingPong_simple_audio.exe
 
 if %ERRORLEVEL% == 0 (
@@ -1,12 +1,57 @@
 #include "Game.h"
 #include "SDL3/SDL_main.h"
+#include <cstdlib>
+#include <cstring>
 
 int main(int argc, char** argv) {
     Game game(1280, 720);
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            game.setTickRate(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--profile") == 0) {
+            game.setProfiling(true);
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            if (!game.loadReplay(argv[++i])) {
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--verify-replay") == 0 && i + 1 < argc) {
+            // Headless: re-simulate and compare, no window
+            return verifyReplay(argv[i + 1]) ? 0 : 1;
+        } else if (std::strcmp(argv[i], "--host") == 0) {
+            // Optional UDP port
+            int port = NetDefaultPort;
+            if (i + 1 < argc && argv[i + 1][0] != '-') port = std::atoi(argv[++i]);
+            game.hostNetplay((unsigned short)port);
+        } else if (std::strcmp(argv[i], "--join") == 0 && i + 1 < argc) {
+            // host[:port]
+            if (!game.joinNetplay(argv[++i])) {
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--net-delay") == 0 && i + 1 < argc) {
+            game.setNetplayInputDelay(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--net-lag") == 0 && i + 1 < argc) {
+            game.setNetplayLag(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--broadcast") == 0) {
+            // Optional UDP port
+            int port = SpectatorDefaultPort;
+            if (i + 1 < argc && argv[i + 1][0] != '-') port = std::atoi(argv[++i]);
+            game.broadcastMatches((unsigned short)port);
+        } else if (std::strcmp(argv[i], "--spectate") == 0 && i + 1 < argc) {
+            // host[:port]
+            if (!game.spectate(argv[++i])) {
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--bench-render") == 0) {
+            // Optional frame count per scene
+            int frames = 1000;
+            if (i + 1 < argc && argv[i + 1][0] != '-') frames = std::atoi(argv[++i]);
+            game.setRenderBenchmark(frames);
+        }
+    }
     if (!game.init()) {
         return 1;
     }
     game.run();
     game.clean();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,217 @@
+// Rollback netplay soak test over loopback UDP: a host and a client session run
+// in one process, each driving its paddle with a scripted player that reads its
+// own (predicted) view of the match. Outgoing packets go through the session's
+// simulated lag, jitter and loss, so every rollback path gets exercised without
+// a second machine. The peers compare checksums of confirmed states as they
+// play; any mismatch is a desync and fails the run. Each peer also counts the
+// goals advance() reports, re-simulated ticks included: fewer than the final
+// score means a rollback lost an event and fails the run too. Links Simulation.cpp,
+// Replay.cpp and Netplay.cpp only: no SDL, no GL context.
+//
+//   net_loopback [options]
+//     --ticks N        ticks to play (default 20000)
+//     --lag N          one-way delay in ticks (default 6)
+//     --jitter N       +/- ticks of delay variation (default 2)
+//     --loss P         percent of input packets dropped (default 5)
+//     --delay N        input delay in ticks (default 2)
+//     --balls N        balls in play (default 1)
+//     --mode M         classic | battle | free (default battle)
+//     --pointer        steer with the pointer, so the input changes every tick
+//     --tick-rate N    simulation rate in Hz (default 120)
+//     --seed N         seed for the simulated jitter and loss (default 1)
+#include "Netplay.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const int FieldWidth = 1280;
+static const int FieldHeight = 720;
+static const int HandshakeTimeoutMs = 3000;
+
+// Chases balls[0] with a wandering aim, taps boost now and then and raises
+// the shield against piercing balls
+struct ScriptedPlayer {
+    Rng rng;
+    float aim;
+    int side;
+    bool pointer;
+
+    PaddleInput input(const MatchState& s) {
+        if (rng.below(60) == 0) aim = rng.range(-50.0f, 50.0f);
+        const SimPaddle& pad = side == 1 ? s.paddle1 : s.paddle2;
+        const SimBall& ball = s.balls[0];
+        float target = ball.y + aim;
+        float centre = pad.y + pad.height * 0.5f;
+
+        PaddleInput in = {};
+        if (pointer) {
+            in.usePointer = true;
+            in.pointerX = pad.x + pad.width * 0.5f;
+            in.pointerY = target;
+        } else {
+            in.up = target < centre - 12.0f;
+            in.down = target > centre + 12.0f;
+        }
+        in.boost = rng.below(200) == 0;
+        in.shield = ball.isPiercing;
+        return in;
+    }
+};
+
+int main(int argc, char** argv) {
+    int ticks = 20000;
+    int lag = 6, jitter = 2, loss = 5;
+    int delay = 2;
+    int balls = 1;
+    int tickRate = 120;
+    unsigned int lagSeed = 1;
+    bool pointer = false;
+    const char* modeName = "battle";
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--ticks") == 0 && hasValue) ticks = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--lag") == 0 && hasValue) lag = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--jitter") == 0 && hasValue) jitter = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--loss") == 0 && hasValue) loss = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--delay") == 0 && hasValue) delay = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--balls") == 0 && hasValue) balls = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--tick-rate") == 0 && hasValue) tickRate = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) lagSeed = (unsigned int)std::strtoul(argv[++i], nullptr, 0);
+        else if (std::strcmp(argv[i], "--mode") == 0 && hasValue) modeName = argv[++i];
+        else if (std::strcmp(argv[i], "--pointer") == 0) pointer = true;
+        else {
+            std::fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+    if (ticks < 1) ticks = 1;
+    if (tickRate < 30) tickRate = 30;
+    if (balls < 1) balls = 1;
+    if (balls > MaxBalls) balls = MaxBalls;
+
+    MatchConfig cfg = {};
+    cfg.width = FieldWidth;
+    cfg.height = FieldHeight;
+    cfg.shieldEnabled = true;
+    cfg.maxHealth = 10;
+    cfg.targetScore = 0;   // endless, so the run lasts as long as asked
+    cfg.ballCount = balls;
+    if (std::strcmp(modeName, "classic") == 0) {
+        cfg.mode = MODE_CLASSIC;
+    } else if (std::strcmp(modeName, "battle") == 0) {
+        cfg.mode = MODE_BATTLE;
+    } else if (std::strcmp(modeName, "free") == 0) {
+        cfg.mode = MODE_BATTLE;
+        cfg.freeMovement = true;
+    } else {
+        std::fprintf(stderr, "Unknown mode '%s' (classic, battle or free)\n", modeName);
+        return 1;
+    }
+
+    NetSession host, client;
+    if (!host.host(0, 0x4E455450u, tickRate, cfg)) {
+        return 1;
+    }
+    // The host took any free port; the client joins it on loopback
+    NetAddress address;
+    if (!parseNetAddress("127.0.0.1", host.localPort(), address) || !client.join(address)) {
+        return 1;
+    }
+
+    auto handshakeStart = std::chrono::steady_clock::now();
+    while (!(host.poll() && client.poll())) {
+        auto waited = std::chrono::steady_clock::now() - handshakeStart;
+        if (std::chrono::duration_cast<std::chrono::milliseconds>(waited).count() > HandshakeTimeoutMs) {
+            std::fprintf(stderr, "Handshake timed out\n");
+            return 1;
+        }
+    }
+
+    NetSession* peers[2] = { &host, &client };
+    MatchState* states[2] = { new MatchState(), new MatchState() };
+    ScriptedPlayer players[2];
+    for (int p = 0; p < 2; ++p) {
+        peers[p]->setInputDelay(delay);
+        // Each peer its own draws, both fixed by the seed
+        peers[p]->setSimulatedLag(lag, jitter, loss, lagSeed * 2u + (unsigned int)p);
+        peers[p]->startMatch(*states[p]);
+        players[p].rng.seed(0x51C0DE00u + (unsigned int)p, RNG_STREAM_COSMETIC);
+        players[p].aim = 0.0f;
+        players[p].side = peers[p]->localSide();
+        players[p].pointer = pointer;
+    }
+
+    std::printf("Loopback netplay: %d ticks at %d Hz, mode %s, %d ball%s, %s input\n", ticks, tickRate,
+                modeName, balls, balls == 1 ? "" : "s", pointer ? "pointer" : "keyboard");
+    std::printf("Lag %d +/- %d ticks, %d%% loss (seed %u), input delay %d\n\n", lag, jitter, loss, lagSeed, delay);
+
+    // Both peers get one advance() per loop, like two games at the same frame rate
+    const float dt = 1.0f / (float)tickRate;
+    double advanceMs[2] = { 0.0, 0.0 };
+    double worstAdvanceMs[2] = { 0.0, 0.0 };
+    SimEvents events;
+    int goalsReported[2] = { 0, 0 };
+    auto t0 = std::chrono::steady_clock::now();
+    int loops = 0;
+    const int maxLoops = ticks * 4;
+    while ((host.frame() < (unsigned int)ticks || client.frame() < (unsigned int)ticks) && loops < maxLoops) {
+        for (int p = 0; p < 2; ++p) {
+            if (peers[p]->frame() >= (unsigned int)ticks) continue;
+            PaddleInput in = players[p].input(*states[p]);
+            auto start = std::chrono::steady_clock::now();
+            bool stepped = peers[p]->advance(*states[p], in, dt, &events);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            for (int e = 0; stepped && e < events.count; ++e) {
+                if (events.queue[e].type == EVENT_GOAL) goalsReported[p]++;
+            }
+            advanceMs[p] += ms;
+            if (ms > worstAdvanceMs[p]) worstAdvanceMs[p] = ms;
+        }
+        if (host.peerLost() || client.peerLost() || host.desynced() || client.desynced()) break;
+        ++loops;
+    }
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    const char* names[2] = { "host", "client" };
+    std::printf("%-8s %8s %9s %9s %10s %11s %12s %10s %9s %7s\n", "peer", "frames", "rollbacks",
+                "resim", "max depth", "max resim", "worst tick", "avg tick", "stalls", "KB/s");
+    for (int p = 0; p < 2; ++p) {
+        const NetSession::Stats& st = peers[p]->stats();
+        unsigned int frames = peers[p]->frame();
+        double seconds = (double)frames / (double)tickRate;
+        std::printf("%-8s %8u %9u %9u %10d %9.3fms %10.3fms %8.4fms %9u %7.2f\n", names[p], frames,
+                    st.rollbacks, st.resimulatedTicks, st.maxRollback, st.maxRollbackMs, worstAdvanceMs[p],
+                    frames ? advanceMs[p] / frames : 0.0, st.stallTicks,
+                    seconds > 0.0 ? st.bytesSent / 1024.0 / seconds : 0.0);
+    }
+    std::printf("\nPlayed in %.0f ms; score %d-%d\n", wallMs, states[0]->score1, states[0]->score2);
+
+    // A mispredicted goal that a rollback took back still counts as reported
+    bool eventsOk = true;
+    for (int p = 0; p < 2; ++p) {
+        int scored = states[p]->score1 + states[p]->score2;
+        std::printf("%s: %d goals reported for %d scored, %u events only seen after a rollback\n", names[p],
+                    goalsReported[p], scored, peers[p]->stats().lateEvents);
+        if (goalsReported[p] < scored) eventsOk = false;
+    }
+
+    unsigned int checks = host.stats().syncChecks + client.stats().syncChecks;
+    bool ok = !host.desynced() && !client.desynced() && !host.peerLost() && !client.peerLost() && checks > 0 &&
+              eventsOk;
+    if (host.desynced() || client.desynced()) {
+        std::printf("DESYNC: the peers disagree about a confirmed state\n");
+    } else if (!eventsOk) {
+        std::printf("FAILED: goals re-simulated after a rollback were never reported\n");
+    } else if (host.peerLost() || client.peerLost()) {
+        std::printf("FAILED: a peer dropped the connection\n");
+    } else {
+        std::printf("%u confirmed checksums compared, all matched\n", checks);
+    }
+
+    host.close();
+    client.close();
+    delete states[0];
+    delete states[1];
+    return ok ? 0 : 1;
+}
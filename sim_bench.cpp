@@ -0,0 +1,243 @@
+// Throughput benchmark for the headless match simulation: plays N matches per
+// case (AI vs AI, or a scripted player vs AI) in Classic and Battle modes, one
+// of them an endless Battle match that only a KO ends, and reports ticks/sec,
+// ns/tick, KOs and heap allocations made while stepping, then times snapshot
+// save/restore against a plain MatchState copy. Links only Simulation.cpp, so
+// it runs without SDL video or a GL context.
+//
+//   sim_bench [matches-per-case] [tick-rate]      defaults: 20  120
+#include "Simulation.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Count every heap allocation; stepMatch is supposed to make none
+static unsigned long long gAllocations = 0;
+
+void* operator new(std::size_t size) {
+    ++gAllocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    ++gAllocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+static const int FieldWidth = 1280;
+static const int FieldHeight = 720;
+static const double MaxMatchSeconds = 600.0;   // AI vs AI rallies can go on forever
+
+struct BenchCase {
+    const char* name;
+    GameMode mode;
+    bool freeMovement;
+    bool scripted;            // P1 is the scripted player instead of AI
+    AIDifficulty difficulty1;
+    AIDifficulty difficulty2;
+    int balls;
+    bool knockout;            // endless, low health and a P2 that misjudges returns: ends on a KO
+};
+
+// Knockout cases: P2's intercept error on top of its preset, and the health both start with
+static const float KnockoutAimError = 100.0f;
+static const int KnockoutHealth = 3;
+
+static const BenchCase kCases[] = {
+    { "classic ai-vs-ai",     MODE_CLASSIC, false, false, AI_HARD,   AI_MEDIUM, 1,   false },
+    { "classic scripted",     MODE_CLASSIC, false, true,  AI_MEDIUM, AI_MEDIUM, 1,   false },
+    { "battle ai-vs-ai KO",   MODE_BATTLE,  false, false, AI_HARD,   AI_MEDIUM, 1,   true  },
+    { "battle scripted",      MODE_BATTLE,  false, true,  AI_MEDIUM, AI_HARD,   1,   false },
+    { "battle free ai-vs-ai", MODE_BATTLE,  true,  false, AI_HARD,   AI_EASY,   1,   false },
+    { "classic 30 balls",     MODE_CLASSIC, false, false, AI_HARD,   AI_MEDIUM, 30,  false },
+    { "classic 250 balls",    MODE_CLASSIC, false, false, AI_HARD,   AI_MEDIUM, 250, false },
+};
+
+// Keyboard-style player for P1: re-aims every few ticks with a misjudgement
+// that sometimes exceeds half a paddle, boosts on the way in and arms the
+// shield against red balls. Seeded per match so runs are reproducible.
+struct ScriptedPlayer {
+    unsigned int rng;
+    float aimY;
+
+    PaddleInput next(const MatchState& s) {
+        PaddleInput in = {};
+        const SimPaddle& p = s.paddle1;
+        const SimBall& b = s.balls[0];
+        bool incoming = b.velX < 0.0f;
+
+        // Re-aim every 6 ticks, like a human who isn't watching every frame
+        if (s.tick % 6 == 0) {
+            rng = rng * 1664525u + 1013904223u;
+            float error = (float)((rng >> 16) % 241) - 120.0f;
+            aimY = incoming ? b.y + error : (float)FieldHeight * 0.5f;
+        }
+        float centre = p.y + p.height * 0.5f;
+        in.up = aimY < centre - 12.0f;
+        in.down = aimY > centre + 12.0f;
+        in.boost = incoming && b.x < (float)FieldWidth * 0.35f && (s.tick / 30) % 3 == 0;
+        in.shield = incoming && b.isPiercing;
+        if (s.shieldPickup1.active && !incoming) {
+            in.right = s.shieldPickup1.x > p.x;
+            in.left = !in.right;
+        }
+        return in;
+    }
+};
+
+struct CaseResult {
+    int finished;
+    int knockouts;
+    unsigned long long ticks;
+    double seconds;
+    unsigned long long allocations;
+    unsigned int checksum;
+};
+
+static CaseResult runCase(const BenchCase& bc, int matches, int tickRate) {
+    MatchConfig cfg = {};
+    cfg.width = FieldWidth;
+    cfg.height = FieldHeight;
+    cfg.mode = bc.mode;
+    cfg.freeMovement = bc.freeMovement;
+    cfg.autoBoost = false;
+    cfg.shieldEnabled = true;
+    cfg.maxHealth = bc.knockout ? KnockoutHealth : 10;
+    cfg.targetScore = bc.knockout ? 0 : 11;
+    cfg.aiControlled1 = !bc.scripted;
+    cfg.aiControlled2 = true;
+    cfg.aiDifficulty1 = bc.difficulty1;
+    cfg.aiDifficulty2 = bc.difficulty2;
+    cfg.ballCount = bc.balls;
+    AIProfile profile2 = aiPreset(bc.difficulty2);
+    profile2.aimError += KnockoutAimError;
+    cfg.aiProfile2 = bc.knockout ? &profile2 : nullptr;
+
+    const float dt = 1.0f / (float)tickRate;
+    const unsigned int maxTicks = (unsigned int)(MaxMatchSeconds * tickRate);
+
+    CaseResult r = {};
+    MatchState s;
+    for (int m = 0; m < matches; ++m) {
+        resetMatch(s, cfg, 0x5EED0000u + (unsigned int)m);
+        MatchInput in = {};
+        ScriptedPlayer player = { 0xB0A7u + (unsigned int)m, (float)FieldHeight * 0.5f };
+
+        unsigned long long allocBefore = gAllocations;
+        auto t0 = std::chrono::steady_clock::now();
+        unsigned int t = 0;
+        while (s.winner == 0 && t < maxTicks) {
+            if (bc.scripted) in.p1 = player.next(s);
+            stepMatch(s, cfg, in, dt);
+            ++t;
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        r.allocations += gAllocations - allocBefore;
+
+        r.seconds += std::chrono::duration<double>(t1 - t0).count();
+        r.ticks += t;
+        if (s.winner != 0) r.finished++;
+        if (s.koWin) r.knockouts++;
+        // Fold the outcome in so a behaviour change shows up next to the timing
+        r.checksum = r.checksum * 31u + (unsigned int)s.score1 * 1000u + (unsigned int)s.score2 * 10u +
+                     (unsigned int)s.winner + s.tick;
+    }
+    return r;
+}
+
+// Keeps the timed restores and copies from being optimised away
+static volatile unsigned int gSnapshotSink = 0;
+
+// ns per save and per restore through a SnapshotRing, next to a whole-struct
+// copy, for a match with `balls` in play
+static void benchSnapshots(const char* name, int balls) {
+    const int Rounds = 200000;
+    const int RingSize = 16;
+
+    MatchConfig cfg = {};
+    cfg.width = FieldWidth;
+    cfg.height = FieldHeight;
+    cfg.mode = MODE_BATTLE;
+    cfg.shieldEnabled = true;
+    cfg.maxHealth = 10;
+    cfg.aiControlled1 = true;
+    cfg.aiControlled2 = true;
+    cfg.aiDifficulty1 = AI_HARD;
+    cfg.aiDifficulty2 = AI_MEDIUM;
+    cfg.ballCount = balls;
+
+    static MatchState s, copy;
+    resetMatch(s, cfg, 0x5AFE0000u);
+    MatchInput in = {};
+    for (int t = 0; t < 120; ++t) stepMatch(s, cfg, in, 1.0f / 120.0f);
+
+    SnapshotRing ring(RingSize);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < Rounds; ++i) {
+        s.tick = (unsigned int)i;
+        ring.save((unsigned int)i, s);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    unsigned int sink = 0;
+    for (int i = 0; i < Rounds; ++i) {
+        ring.restore((unsigned int)(Rounds - 1 - (i % RingSize)), copy);
+        sink += copy.tick;
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    for (int i = 0; i < Rounds; ++i) {
+        s.tick = (unsigned int)i;
+        copy = s;
+        sink += copy.tick;
+    }
+    auto t3 = std::chrono::steady_clock::now();
+
+    auto ns = [](std::chrono::steady_clock::duration d) {
+        return std::chrono::duration<double, std::nano>(d).count() / Rounds;
+    };
+    const MatchSnapshot* snap = ring.find((unsigned int)(Rounds - 1));
+    gSnapshotSink = sink;
+    std::printf("%-22s %9u %12.1f %12.1f %12.1f\n", name, snap ? snap->size : 0u,
+                ns(t1 - t0), ns(t2 - t1), ns(t3 - t2));
+}
+
+int main(int argc, char** argv) {
+    int matches = argc > 1 ? std::atoi(argv[1]) : 20;
+    int tickRate = argc > 2 ? std::atoi(argv[2]) : 120;
+    if (matches < 1) matches = 1;
+    if (tickRate < 30) tickRate = 30;
+
+    std::printf("%d matches per case at %d Hz (capped at %.0f s of match time)\n\n",
+                matches, tickRate, MaxMatchSeconds);
+    std::printf("%-22s %9s %5s %12s %14s %10s %7s %10s\n",
+                "case", "finished", "KOs", "ticks", "ticks/s", "ns/tick", "allocs", "checksum");
+
+    unsigned long long totalTicks = 0;
+    double totalSeconds = 0.0;
+    unsigned long long totalAllocs = 0;
+    for (const BenchCase& bc : kCases) {
+        CaseResult r = runCase(bc, matches, tickRate);
+        double tps = r.seconds > 0.0 ? (double)r.ticks / r.seconds : 0.0;
+        double nsPerTick = r.ticks ? r.seconds * 1.0e9 / (double)r.ticks : 0.0;
+        std::printf("%-22s %4d/%-4d %5d %12llu %14.0f %10.1f %7llu %08x\n",
+                    bc.name, r.finished, matches, r.knockouts, r.ticks, tps, nsPerTick, r.allocations, r.checksum);
+        totalTicks += r.ticks;
+        totalSeconds += r.seconds;
+        totalAllocs += r.allocations;
+    }
+
+    std::printf("\n%-22s %9s %5s %12llu %14.0f %10.1f %7llu\n", "total", "", "",
+                totalTicks, totalSeconds > 0.0 ? (double)totalTicks / totalSeconds : 0.0,
+                totalTicks ? totalSeconds * 1.0e9 / (double)totalTicks : 0.0, totalAllocs);
+
+    std::printf("\n%-22s %9s %12s %12s %12s\n", "", "bytes", "save ns", "restore ns", "copy ns");
+    benchSnapshots("snapshot 1 ball", 1);
+    benchSnapshots("snapshot 30 balls", 30);
+    benchSnapshots("snapshot 250 balls", 250);
+    return totalAllocs == 0 ? 0 : 1;
+}